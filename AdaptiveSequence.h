@@ -0,0 +1,281 @@
+#pragma once
+
+#include <stdexcept>
+#include "Sequence.h"
+#include "DynamicArray.h"
+#include "LinkedList.h"
+
+template <class T>
+class AdaptiveSequence : public Sequence<T> {
+private:
+    enum class StorageType { Array, List };
+    StorageType currentType;
+    ICollection<T>* storage = nullptr;
+    size_t operationThreshold = 10;
+    size_t randomAccessCount = 0;
+    size_t insertionCount = 0;
+
+    void InitializeStorage(StorageType type) {
+        if (storage) delete storage;
+
+        if (type == StorageType::Array) {
+            storage = new DynamicArray<T>();
+        } else {
+            storage = new LinkedList<T>();
+        }
+        currentType = type;
+    }
+
+    void CheckAndSwitch() {
+        if (randomAccessCount > operationThreshold && currentType == StorageType::List) {
+            SwitchToArray();
+        } else if (insertionCount > operationThreshold && currentType == StorageType::Array) {
+            SwitchToList();
+        }
+    }
+
+    void SwitchToArray() {
+        if (currentType == StorageType::Array) return;
+        DynamicArray<T>* newArray = new DynamicArray<T>();
+        for (int i = 0; i < storage->GetSize(); ++i) {
+            newArray->Append(storage->Get(i));
+        }
+        delete storage;
+        storage = newArray;
+        currentType = StorageType::Array;
+        randomAccessCount = 0;
+        insertionCount = 0;
+    }
+
+    void SwitchToList() {
+        if (currentType == StorageType::List) return;
+        LinkedList<T>* newList = new LinkedList<T>();
+        for (int i = 0; i < storage->GetSize(); ++i) {
+            newList->Append(storage->Get(i));
+        }
+        delete storage;
+        storage = newList;
+        currentType = StorageType::List;
+        randomAccessCount = 0;
+        insertionCount = 0;
+    }
+
+public:
+    AdaptiveSequence() {
+        InitializeStorage(StorageType::Array);
+    }
+
+    AdaptiveSequence(T* items, int count) {
+        InitializeStorage(count > 100 ? StorageType::Array : StorageType::List);
+        for (int i = 0; i < count; ++i) {
+            storage->Append(items[i]);
+        }
+    }
+
+    AdaptiveSequence(AdaptiveSequence<T>& other) {
+        InitializeStorage(other.currentType);
+        for (int i = 0; i < other.storage->GetSize(); ++i) {
+            storage->Append(other.storage->Get(i));
+        }
+    }
+
+    ~AdaptiveSequence() {
+        delete storage;
+    }
+
+    T GetFirst() override {
+        if (storage->GetSize() == 0) throw IndexOutOfRange();
+        return storage->Get(0);
+    }
+
+    T GetLast() override {
+        int size = storage->GetSize();
+        if (size == 0) throw IndexOutOfRange();
+        return storage->Get(size - 1);
+    }
+
+    T Get(int index) override {
+        randomAccessCount++;
+        CheckAndSwitch();
+        return storage->Get(index);
+    }
+
+    int GetSize() override {
+        return storage->GetSize();
+    }
+
+    CollectionFootprint MemoryFootprint() override {
+        return storage->MemoryFootprint().Wrapped(sizeof(*this));
+    }
+
+    T& operator[](int index) override {
+        randomAccessCount++;
+        CheckAndSwitch();
+        if (currentType == StorageType::Array) {
+            return dynamic_cast<DynamicArray<T>*>(storage)->operator[](index);
+        }
+        throw std::runtime_error("Operator[] not supported for list storage");
+    }
+
+    const T& operator[](int index) const override {
+        if (currentType == StorageType::Array) {
+            return dynamic_cast<const DynamicArray<T>*>(storage)->operator[](index);
+        }
+        throw std::runtime_error("Operator[] not supported for list storage");
+    }
+
+    void Append(T item) override {
+        insertionCount++;
+        CheckAndSwitch();
+        storage->Append(item);
+    }
+
+    void Prepend(T item) override {
+        insertionCount++;
+        CheckAndSwitch();
+        storage->Prepend(item);
+    }
+
+    void Insert(T item, int index) override {
+        insertionCount++;
+        CheckAndSwitch();
+        storage->Insert(item, index);
+    }
+
+    Sequence<T>* GetSubSequence(int startIndex, int endIndex) override {
+        AdaptiveSequence<T>* subSequence = new AdaptiveSequence<T>();
+        for (int i = startIndex; i < endIndex; i++) {
+            subSequence->Append(Get(i));
+        }
+        return subSequence;
+    }
+
+    Sequence<T>* Concat(Sequence<T>* other) override {
+        AdaptiveSequence<T>* newSequence = new AdaptiveSequence<T>(*this);
+        for (int i = 0; i < other->GetSize(); i++) {
+            newSequence->Append(other->Get(i));
+        }
+        return newSequence;
+    }
+
+    Sequence<T>* Map(function<T(T)> func) override {
+        AdaptiveSequence<T>* newSequence = new AdaptiveSequence<T>();
+        int size = GetSize();
+        for (int i = 0; i < size; ++i) {
+            newSequence->Append(func(Get(i)));
+        }
+        return newSequence;
+    }
+
+    T Reduce(function<T(T, T)> func, T startValue) override {
+        T result = startValue;
+        int size = GetSize();
+        for (int i = 0; i < size; ++i) {
+            result = func(result, Get(i));
+        }
+        return result;
+    }
+
+    Sequence<T>* Where(function<bool(T)> predicate) override {
+        AdaptiveSequence<T>* newSequence = new AdaptiveSequence<T>();
+        int size = GetSize();
+        for (int i = 0; i < size; ++i) {
+            T item = Get(i);
+            if (predicate(item)) {
+                newSequence->Append(item);
+            }
+        }
+        return newSequence;
+    }
+
+    Sequence<T>* Zip(Sequence<T>* other, function<T(T, T)> func) override {
+        AdaptiveSequence<T>* newSequence = new AdaptiveSequence<T>();
+        int minSize = min(GetSize(), other->GetSize());
+        for (int i = 0; i < minSize; ++i) {
+            newSequence->Append(func(Get(i), other->Get(i)));
+        }
+        return newSequence;
+    }
+
+    Sequence<T>* Slice(int index, int count, Sequence<T>* replacement) override {
+        AdaptiveSequence<T>* newSequence = new AdaptiveSequence<T>();
+        for (int i = 0; i < index; ++i) {
+            newSequence->Append(Get(i));
+        }
+        if (replacement != nullptr) {
+            for (int i = 0; i < replacement->GetSize(); ++i) {
+                newSequence->Append(replacement->Get(i));
+            }
+        }
+        for (int i = index + count; i < GetSize(); ++i) {
+            newSequence->Append(Get(i));
+        }
+        return newSequence;
+    }
+
+    Sequence<T>* Split(function<bool(T)> predicate) override {
+        AdaptiveSequence<T>* result = new AdaptiveSequence<T>();
+        AdaptiveSequence<T>* current = new AdaptiveSequence<T>();
+        int size = GetSize();
+        for (int i = 0; i < size; ++i) {
+            T item = Get(i);
+            if (predicate(item)) {
+                if (current->GetSize() > 0) {
+                    result->Append(current->Get(0));
+                    delete current;
+                    current = new AdaptiveSequence<T>();
+                }
+            } else {
+                current->Append(item);
+            }
+        }
+
+        if (current->GetSize() > 0) {
+            result->Append(current->Get(0));
+        } else {
+            delete current;
+        }
+
+        return result;
+    }
+
+    bool TryGet(int index, T& value) override {
+        if (index < 0 || index >= GetSize()) {
+            return false;
+        }
+        value = Get(index);
+        return true;
+    }
+
+    bool TryFind(function<bool(T)> predicate, T& value) override {
+        int size = GetSize();
+        for (int i = 0; i < size; ++i) {
+            T item = Get(i);
+            if (predicate(item)) {
+                value = item;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void OptimizeForRandomAccess() {
+        SwitchToArray();
+    }
+
+    void OptimizeForInsertions() {
+        SwitchToList();
+    }
+
+    bool IsArray() const {
+        return currentType == StorageType::Array;
+    }
+
+    bool IsList() const {
+        return currentType == StorageType::List;
+    }
+
+    void SetOperationThreshold(size_t threshold) {
+        operationThreshold = threshold;
+    }
+};
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cstddef>
+#include <map>
+#include <string>
+
+using namespace std;
+
+struct AllocationStats {
+    size_t liveBytes = 0;
+    size_t peakBytes = 0;
+    size_t allocations = 0;
+    size_t frees = 0;
+};
+
+// Optional accounting of the heap blocks containers allocate, per container
+// type (DynamicArray buffers, LinkedList nodes, SegmentedList segments).
+// Disabled by default so the hooks cost one predictable branch; not thread
+// safe, like the containers themselves.
+class AllocationTracker {
+private:
+    static bool& EnabledFlag() {
+        static bool enabled = false;
+        return enabled;
+    }
+
+    static AllocationStats& Total() {
+        static AllocationStats total;
+        return total;
+    }
+
+public:
+    static map<string, AllocationStats>& ByType() {
+        static map<string, AllocationStats> stats;
+        return stats;
+    }
+
+    // References into the map stay valid, so containers look their entry up
+    // once and keep it in a function-local static.
+    static AllocationStats& Register(const string& type) {
+        return ByType()[type];
+    }
+
+    static void Enable(bool enabled = true) {
+        EnabledFlag() = enabled;
+    }
+
+    static bool Enabled() {
+        return EnabledFlag();
+    }
+
+    static void OnAllocate(AllocationStats& stats, size_t bytes) {
+        if (!EnabledFlag()) {
+            return;
+        }
+        for (AllocationStats* entry : {&stats, &Total()}) {
+            entry->liveBytes += bytes;
+            entry->allocations++;
+            if (entry->liveBytes > entry->peakBytes) {
+                entry->peakBytes = entry->liveBytes;
+            }
+        }
+    }
+
+    // Frees of blocks allocated while tracking was off are clamped at zero
+    // rather than wrapping around.
+    static void OnFree(AllocationStats& stats, size_t bytes) {
+        if (!EnabledFlag()) {
+            return;
+        }
+        for (AllocationStats* entry : {&stats, &Total()}) {
+            entry->liveBytes -= bytes < entry->liveBytes ? bytes : entry->liveBytes;
+            entry->frees++;
+        }
+    }
+
+    static const AllocationStats& Overall() {
+        return Total();
+    }
+
+    // Starts a new peak window at the current live size.
+    static void ResetPeaks() {
+        Total().peakBytes = Total().liveBytes;
+        for (auto& entry : ByType()) {
+            entry.second.peakBytes = entry.second.liveBytes;
+        }
+    }
+};
@@ -0,0 +1,584 @@
+#pragma once
+
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "AllocationTracker.h"
+#include "CollectionFootprint.h"
+#include "PerfCounters.h"
+
+using namespace std;
+
+// Keeps the optimizer from discarding a value that is only computed for timing.
+template <class T>
+inline void DoNotOptimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r"(&value) : "memory");
+#else
+    volatile const T* sink = &value;
+    (void)sink;
+#endif
+}
+
+struct BenchmarkResult {
+    string container;
+    string operation;
+    string type;
+    string pattern;
+    long long size = 0;
+    // For per-element operations (Append, Get, ...) one op is one call; for
+    // whole-container operations (Map, Reduce, iterate, ...) one op is one
+    // element processed, so ns/op is comparable across the two kinds.
+    long long ops = 0;
+    double seconds = 0;
+    // Set when the time budget ran out before the requested op count was reached.
+    bool truncated = false;
+    // Set when a smaller size of the same case predicted this one would not fit the budget.
+    bool skipped = false;
+    map<string, double> metrics;
+    // Raw hardware counter totals over the timed region; empty when
+    // counters are unavailable or disabled.
+    map<string, double> counters;
+
+    double NsPerOp() const {
+        return ops > 0 ? seconds * 1e9 / ops : 0;
+    }
+
+    double OpsPerSec() const {
+        return seconds > 0 ? ops / seconds : 0;
+    }
+};
+
+enum class AccessPattern { Sequential, Random, Zipf };
+
+inline const char* PatternName(AccessPattern pattern) {
+    switch (pattern) {
+        case AccessPattern::Sequential: return "sequential";
+        case AccessPattern::Random: return "random";
+        case AccessPattern::Zipf: return "zipf";
+    }
+    return "unknown";
+}
+
+// Zipf-distributed ranks in [0, n) after Gray et al., "Quickly generating
+// billion-record synthetic databases" (the generator YCSB uses). Rank 0 is the
+// hottest, so for lists the hot items sit near the head.
+class ZipfGenerator {
+private:
+    long long n;
+    double theta;
+    double alpha;
+    double zetan;
+    double eta;
+    uniform_real_distribution<double> uniform{0.0, 1.0};
+
+    static double Zeta(long long count, double theta) {
+        double sum = 0;
+        for (long long i = 1; i <= count; i++) {
+            sum += 1.0 / pow((double) i, theta);
+        }
+        return sum;
+    }
+
+public:
+    ZipfGenerator(long long n, double theta = 0.99) : n(n), theta(theta) {
+        alpha = 1.0 / (1.0 - theta);
+        zetan = Zeta(n, theta);
+        double zeta2 = Zeta(2, theta);
+        eta = (1.0 - pow(2.0 / n, 1.0 - theta)) / (1.0 - zeta2 / zetan);
+    }
+
+    long long Next(mt19937_64& rng) {
+        double u = uniform(rng);
+        double uz = u * zetan;
+        if (uz < 1.0) {
+            return 0;
+        }
+        if (uz < 1.0 + pow(0.5, theta)) {
+            return n > 1 ? 1 : 0;
+        }
+        long long rank = (long long) (n * pow(eta * u - eta + 1.0, alpha));
+        return rank < n ? rank : n - 1;
+    }
+};
+
+// A wrapping stream of indices in [0, n). Its length is a power of two so the
+// timed loop can index it with a mask.
+inline vector<int> MakeIndexStream(AccessPattern pattern, long long n, uint64_t seed = 42) {
+    size_t length = 1;
+    size_t wanted = (size_t) (n < 4096 ? 4096 : (n > (1 << 20) ? (1 << 20) : n));
+    while (length < wanted) {
+        length <<= 1;
+    }
+    vector<int> indices(length);
+    mt19937_64 rng(seed);
+    if (pattern == AccessPattern::Sequential) {
+        for (size_t i = 0; i < length; i++) {
+            indices[i] = (int) (i % n);
+        }
+    } else if (pattern == AccessPattern::Random) {
+        uniform_int_distribution<long long> dist(0, n - 1);
+        for (size_t i = 0; i < length; i++) {
+            indices[i] = (int) dist(rng);
+        }
+    } else {
+        ZipfGenerator zipf(n);
+        for (size_t i = 0; i < length; i++) {
+            indices[i] = (int) zipf.Next(rng);
+        }
+    }
+    return indices;
+}
+
+struct BenchmarkOptions {
+    vector<long long> sizes = {10, 100, 1000, 10000, 100000, 1000000, 10000000};
+    vector<string> types = {"int", "double", "string", "bool", "record"};
+    vector<string> containers;
+    vector<string> operations;
+    vector<string> patterns;
+    double minTime = 0.05;
+    double budget = 2.0;
+    bool counters = true;
+    bool trackAllocations = false;
+    string outPath;
+
+    static vector<string> SplitList(const string& text) {
+        vector<string> items;
+        stringstream stream(text);
+        string item;
+        while (getline(stream, item, ',')) {
+            if (!item.empty()) {
+                items.push_back(item);
+            }
+        }
+        return items;
+    }
+
+    // Accepts --sizes=, --types=, --containers=, --ops=, --patterns=,
+    // --min-time=, --budget=, --counters=on|off, --track-allocations and
+    // --out=. Unknown flags are reported and ignored.
+    static BenchmarkOptions Parse(int argc, char** argv) {
+        BenchmarkOptions options;
+        for (int i = 1; i < argc; i++) {
+            string arg = argv[i];
+            size_t eq = arg.find('=');
+            string key = arg.substr(0, eq);
+            string value = eq == string::npos ? "" : arg.substr(eq + 1);
+            if (key == "--sizes") {
+                options.sizes.clear();
+                for (const string& size : SplitList(value)) {
+                    options.sizes.push_back(stoll(size));
+                }
+            } else if (key == "--types") {
+                options.types = SplitList(value);
+            } else if (key == "--containers") {
+                options.containers = SplitList(value);
+            } else if (key == "--ops") {
+                options.operations = SplitList(value);
+            } else if (key == "--patterns") {
+                options.patterns = SplitList(value);
+            } else if (key == "--min-time") {
+                options.minTime = stod(value);
+            } else if (key == "--budget") {
+                options.budget = stod(value);
+            } else if (key == "--counters") {
+                options.counters = value != "off" && value != "0";
+            } else if (key == "--track-allocations") {
+                options.trackAllocations = value != "off" && value != "0";
+            } else if (key == "--out") {
+                options.outPath = value;
+            } else {
+                cerr << "Unknown option " << arg << endl;
+            }
+        }
+        return options;
+    }
+
+    static bool Selected(const vector<string>& filter, const string& name) {
+        if (filter.empty()) {
+            return true;
+        }
+        for (const string& item : filter) {
+            if (item == name) {
+                return true;
+            }
+        }
+        return false;
+    }
+};
+
+struct BenchmarkCase {
+    string container;
+    string operation;
+    string type;
+    string pattern;
+    long long size = 0;
+    // Calls one fixture can absorb; growth operations use n, read-only ones
+    // are unbounded and stop at minTime.
+    long long maxCalls = Unbounded;
+    // Ops reported per call: 1 for per-element operations, n for passes over
+    // the whole container.
+    long long opsPerCall = 1;
+    // Payload bytes moved per op; when set the result also carries a
+    // gb_per_sec metric (streaming and I/O-bound cases).
+    double bytesPerOp = 0;
+
+    static constexpr long long Unbounded = 1LL << 50;
+
+    string Key() const {
+        return container + "/" + operation + "/" + type + "/" + pattern;
+    }
+};
+
+class BenchmarkRunner {
+private:
+    using Clock = chrono::steady_clock;
+
+    // The unavoidable cost of a case at one size: building one fixture plus
+    // the calls it cannot stop short of (all of them for growth operations,
+    // a single one otherwise).
+    struct History {
+        long long size;
+        double passSeconds;
+    };
+
+    BenchmarkOptions options;
+    PerfCounters perf;
+    vector<BenchmarkResult> results;
+    // Pass cost of the previous sizes of each case, used to skip sizes that
+    // would blow the budget (quadratic list traversals, O(n) array appends).
+    map<string, vector<History>> history;
+    // Figures a case body reported through Metric() while it ran.
+    map<string, double> caseMetrics;
+
+    static double Seconds(Clock::duration duration) {
+        return chrono::duration<double>(duration).count();
+    }
+
+    double PredictPassSeconds(const string& key, long long size) {
+        auto found = history.find(key);
+        if (found == history.end() || found->second.empty()) {
+            return 0;
+        }
+        const vector<History>& points = found->second;
+        const History& last = points.back();
+        // Tiny timings are mostly noise, so assume the worst (quadratic) until
+        // two sizes are large enough to measure the growth rate.
+        double exponent = 2.0;
+        if (points.size() >= 2) {
+            const History& previous = points[points.size() - 2];
+            if (previous.passSeconds > 1e-4 && last.passSeconds > 0) {
+                exponent = log(last.passSeconds / previous.passSeconds)
+                           / log((double) last.size / previous.size);
+                exponent = exponent < 1.0 ? 1.0 : (exponent > 2.0 ? 2.0 : exponent);
+            }
+        }
+        return last.passSeconds * pow((double) size / last.size, exponent);
+    }
+
+    // Counters as per-op figures, with IPC passed through as a ratio.
+    static void WriteCounters(ostream& out, const map<string, double>& counters, long long ops) {
+        out << "{";
+        bool first = true;
+        for (const auto& counter : counters) {
+            out << (first ? "" : ", ");
+            first = false;
+            if (counter.first == "ipc") {
+                out << "\"ipc\": ";
+                WriteJsonNumber(out, counter.second);
+            } else {
+                WriteJsonString(out, counter.first + "_per_op");
+                out << ": ";
+                WriteJsonNumber(out, ops > 0 ? counter.second / ops : 0);
+            }
+        }
+        out << "}";
+    }
+
+    // Counter totals grouped per container and per operation across every
+    // type, pattern and size that ran, so the slow paths stand out without
+    // post-processing. Omitted when no case collected counters.
+    void WriteCounterSummary(ostream& out) const {
+        map<string, map<string, pair<map<string, double>, long long>>> groups;
+        for (const BenchmarkResult& r : results) {
+            if (r.counters.empty()) {
+                continue;
+            }
+            auto& group = groups[r.container][r.operation];
+            for (const auto& counter : r.counters) {
+                if (counter.first != "ipc") {
+                    group.first[counter.first] += counter.second;
+                }
+            }
+            group.second += r.ops;
+        }
+        if (groups.empty()) {
+            return;
+        }
+        out << ",\n  \"counter_summary\": {";
+        bool firstContainer = true;
+        for (auto& container : groups) {
+            out << (firstContainer ? "\n    " : ",\n    ");
+            firstContainer = false;
+            WriteJsonString(out, container.first);
+            out << ": {";
+            bool firstOperation = true;
+            for (auto& operation : container.second) {
+                map<string, double>& totals = operation.second.first;
+                if (totals.count("cycles") && totals["cycles"] > 0 && totals.count("instructions")) {
+                    totals["ipc"] = totals["instructions"] / totals["cycles"];
+                }
+                out << (firstOperation ? "" : ", ");
+                firstOperation = false;
+                WriteJsonString(out, operation.first);
+                out << ": ";
+                WriteCounters(out, totals, operation.second.second);
+            }
+            out << "}";
+        }
+        out << "\n  }";
+    }
+
+    // Footprint of the fixture as the case left it, per stored element, so
+    // bytes/element sits next to the throughput figures.
+    template <class Fixture>
+    static void RecordFootprint(BenchmarkResult& result, Fixture* fixture) {
+        if constexpr (requires { fixture->MemoryFootprint(); fixture->GetSize(); }) {
+            int elements = fixture->GetSize();
+            if (elements <= 0) {
+                return;
+            }
+            CollectionFootprint footprint = fixture->MemoryFootprint();
+            result.metrics["bytes_per_element"] = (double) footprint.TotalBytes() / elements;
+            result.metrics["overhead_bytes_per_element"] = (double) footprint.overheadBytes / elements;
+            result.metrics["allocations"] = (double) footprint.allocationCount;
+            result.metrics["fragmentation"] = footprint.FragmentationRatio();
+        }
+    }
+
+    void WriteAllocationSummary(ostream& out) const {
+        if (!options.trackAllocations) {
+            return;
+        }
+        out << ",\n  \"allocations\": {";
+        bool first = true;
+        for (const auto& entry : AllocationTracker::ByType()) {
+            out << (first ? "\n    " : ",\n    ");
+            first = false;
+            WriteJsonString(out, entry.first);
+            out << ": {\"live_bytes\": " << entry.second.liveBytes
+                << ", \"peak_bytes\": " << entry.second.peakBytes
+                << ", \"allocations\": " << entry.second.allocations
+                << ", \"frees\": " << entry.second.frees << "}";
+        }
+        out << "\n  }";
+    }
+
+    static void WriteJsonString(ostream& out, const string& text) {
+        out << '"';
+        for (char c : text) {
+            if (c == '"' || c == '\\') {
+                out << '\\';
+            }
+            out << c;
+        }
+        out << '"';
+    }
+
+    // JSON has no inf or nan; a metric that divided by zero is written as
+    // null.
+    static void WriteJsonNumber(ostream& out, double value) {
+        if (isfinite(value)) {
+            out << value;
+        } else {
+            out << "null";
+        }
+    }
+
+public:
+    explicit BenchmarkRunner(BenchmarkOptions options) : options(std::move(options)) {
+        AllocationTracker::Enable(this->options.trackAllocations);
+    }
+
+    const BenchmarkOptions& Options() const {
+        return options;
+    }
+
+    bool Wants(const string& container, const string& operation, const string& type, const string& pattern) const {
+        return BenchmarkOptions::Selected(options.containers, container)
+               && BenchmarkOptions::Selected(options.operations, operation)
+               && BenchmarkOptions::Selected(options.types, type)
+               && BenchmarkOptions::Selected(options.patterns, pattern);
+    }
+
+    // Attaches a figure the timing cannot show (reader lag, retries) to the
+    // case being run; the last value reported wins. Only for case bodies.
+    void Metric(const string& name, double value) {
+        caseMetrics[name] = value;
+    }
+
+    // Runs one benchmark case. `setup` builds a fixture (untimed), `body(fixture,
+    // begin, count)` performs calls [begin, begin + count) (timed), `teardown`
+    // releases the fixture (untimed). Batches double in size and the clock is
+    // only read between batches, so per-op overhead stays out of the numbers.
+    // `maxCalls` bounds the calls per fixture (e.g. n appends); the fixture is
+    // rebuilt until minTime is reached, and the case stops early when the next
+    // batch would overrun the budget.
+    template <class Setup, class Body, class Teardown>
+    void Run(const BenchmarkCase& info, Setup setup, Body body, Teardown teardown) {
+        if (!Wants(info.container, info.operation, info.type, info.pattern)) {
+            return;
+        }
+        BenchmarkResult result;
+        result.container = info.container;
+        result.operation = info.operation;
+        result.type = info.type;
+        result.pattern = info.pattern;
+        result.size = info.size;
+        long long maxOps = info.maxCalls;
+
+        string key = info.Key();
+        if (PredictPassSeconds(key, info.size) > options.budget) {
+            result.skipped = true;
+            results.push_back(result);
+            cerr << key << "/" << info.size << ": skipped" << endl;
+            return;
+        }
+
+        bool counting = options.counters && perf.Available();
+        caseMetrics.clear();
+        perf.Reset();
+        AllocationTracker::ResetPeaks();
+        size_t liveAtStart = AllocationTracker::Overall().liveBytes;
+        Clock::time_point wallStart = Clock::now();
+        double maxSetupSeconds = 0;
+        bool stop = false;
+        while (!stop) {
+            Clock::time_point setupStart = Clock::now();
+            auto fixture = setup();
+            double setupSeconds = Seconds(Clock::now() - setupStart);
+            if (setupSeconds > maxSetupSeconds) {
+                maxSetupSeconds = setupSeconds;
+            }
+            long long done = 0;
+            long long batch = 1;
+            while (done < maxOps) {
+                long long count = batch < maxOps - done ? batch : maxOps - done;
+                if (counting) {
+                    perf.Start();
+                }
+                Clock::time_point start = Clock::now();
+                body(fixture, done, count);
+                Clock::time_point end = Clock::now();
+                if (counting) {
+                    perf.Stop();
+                }
+                double elapsed = Seconds(end - start);
+                result.seconds += elapsed;
+                result.ops += count * info.opsPerCall;
+                done += count;
+                if (result.seconds >= options.minTime && done < maxOps) {
+                    stop = true;
+                    break;
+                }
+                if (done < maxOps && Seconds(end - wallStart) + 2 * elapsed > options.budget) {
+                    result.truncated = true;
+                    stop = true;
+                    break;
+                }
+                batch *= 2;
+            }
+            RecordFootprint(result, fixture);
+            teardown(fixture);
+            if (result.seconds >= options.minTime || Seconds(Clock::now() - wallStart) > options.budget) {
+                stop = true;
+            }
+        }
+
+        long long calls = result.ops / info.opsPerCall;
+        double callSeconds = calls > 0 ? result.seconds / calls : 0;
+        double minCalls = maxOps == BenchmarkCase::Unbounded ? 1 : (double) maxOps;
+        history[key].push_back({info.size, maxSetupSeconds + callSeconds * minCalls});
+        if (info.bytesPerOp > 0 && result.seconds > 0) {
+            result.metrics["gb_per_sec"] = info.bytesPerOp * result.ops / result.seconds / 1e9;
+        }
+        for (const auto& metric : caseMetrics) {
+            result.metrics[metric.first] = metric.second;
+        }
+        if (options.trackAllocations) {
+            result.metrics["peak_heap_bytes"] = (double) (AllocationTracker::Overall().peakBytes - liveAtStart);
+        }
+        if (counting) {
+            for (const PerfCounters::Sample& sample : perf.Totals()) {
+                result.counters[sample.name] = sample.value;
+            }
+        }
+        results.push_back(result);
+        cerr << key << "/" << info.size << ": " << result.NsPerOp() << " ns/op";
+        if (result.counters.count("ipc")) {
+            cerr << ", IPC " << result.counters["ipc"];
+        }
+        cerr << (result.truncated ? " (truncated)" : "") << endl;
+    }
+
+    void WriteJson(ostream& out) const {
+        out << "{\n  \"schema\": 1,\n  \"counters_available\": "
+            << (options.counters && perf.Available() ? "true" : "false")
+            << ",\n  \"benchmarks\": [";
+        for (size_t i = 0; i < results.size(); i++) {
+            const BenchmarkResult& r = results[i];
+            out << (i == 0 ? "\n" : ",\n") << "    {\"container\": ";
+            WriteJsonString(out, r.container);
+            out << ", \"operation\": ";
+            WriteJsonString(out, r.operation);
+            out << ", \"type\": ";
+            WriteJsonString(out, r.type);
+            out << ", \"pattern\": ";
+            WriteJsonString(out, r.pattern);
+            out << ", \"size\": " << r.size;
+            if (r.skipped) {
+                out << ", \"skipped\": true}";
+                continue;
+            }
+            out << ", \"ops\": " << r.ops << ", \"seconds\": ";
+            WriteJsonNumber(out, r.seconds);
+            out << ", \"ns_per_op\": ";
+            WriteJsonNumber(out, r.NsPerOp());
+            out << ", \"ops_per_sec\": ";
+            WriteJsonNumber(out, r.OpsPerSec());
+            out << ", \"truncated\": " << (r.truncated ? "true" : "false");
+            for (const auto& metric : r.metrics) {
+                out << ", ";
+                WriteJsonString(out, metric.first);
+                out << ": ";
+                WriteJsonNumber(out, metric.second);
+            }
+            if (!r.counters.empty()) {
+                out << ", \"counters\": ";
+                WriteCounters(out, r.counters, r.ops);
+            }
+            out << "}";
+        }
+        out << "\n  ]";
+        WriteCounterSummary(out);
+        WriteAllocationSummary(out);
+        out << "\n}\n";
+    }
+
+    void Report() const {
+        if (options.outPath.empty()) {
+            WriteJson(cout);
+            return;
+        }
+        ofstream out(options.outPath);
+        WriteJson(out);
+    }
+};
@@ -0,0 +1,530 @@
+#pragma once
+
+#include <bit>
+#include <climits>
+#include <cstdint>
+#include <functional>
+#include <stdexcept>
+
+#include "Sequence.h"
+#include "DynamicArray.h"
+#include "MutableArraySequence.h"
+#include "IndexOutOfRange.h"
+
+// A Sequence<bool> packed 64 flags to a word, for masks and flag arrays.
+// Count, And/Or/Xor/Not and the searches work a word at a time; Map, Where
+// and a Zip with another BitSequence evaluate their callback on the two
+// (or four) possible inputs once and then combine whole words.
+//
+// Rank and Select answer "set bits before i" and "where is the k-th set
+// bit" from a directory of counts per 512 bits, rebuilt on the first query
+// after a change.
+//
+// As a mask for another sequence:
+//
+//   BitSequence* mask = BitSequence::FromPredicate(prices, [](double p) { return p > limit; });
+//   mask->Or(manualFlags);
+//   MutableArraySequence<double>* outliers = mask->Select(prices);
+//
+// Select reads only the elements at set positions, jumping between them a
+// word at a time.
+//
+// A bool& cannot point into the middle of a word, so the non-const
+// operator[] throws; write bits with Set. The const one returns a
+// reference to a static true or false.
+class BitSequence : public Sequence<bool> {
+private:
+    static const int WORD_BITS = 64;
+    static const int WORDS_PER_RANK = 8;
+
+    DynamicArray<uint64_t>* words;
+    int size = 0;
+    DynamicArray<int>* ranks = nullptr;
+    bool ranksStale = true;
+
+    static constexpr bool TRUE_VALUE = true;
+    static constexpr bool FALSE_VALUE = false;
+
+    static int WordCount(int bits) {
+        return (bits + WORD_BITS - 1) / WORD_BITS;
+    }
+
+    // The bits below `count`.
+    static uint64_t LowMask(int count) {
+        return count == 0 ? 0 : ~0ull >> (WORD_BITS - count);
+    }
+
+    static uint64_t Fill(bool value) {
+        return value ? ~0ull : 0;
+    }
+
+    uint64_t* Data() const {
+        return &(*words)[0];
+    }
+
+    // Makes room for `bits` bits; new words are zero.
+    void Reserve(int bits) {
+        int capacity = words->GetSize();
+        int needed = WordCount(bits);
+        if (needed <= capacity) {
+            return;
+        }
+        int newCapacity = GrowCapacity(capacity, needed, 1);
+        words->Resize(newCapacity);
+        for (int i = capacity; i < newCapacity; i++) {
+            (*words)[i] = 0;
+        }
+    }
+
+    // Bits past `size` in the last word stay zero, so Count and the
+    // searches never look at them.
+    void ClearTail() {
+        if (size % WORD_BITS != 0) {
+            Data()[size / WORD_BITS] &= LowMask(size % WORD_BITS);
+        }
+    }
+
+    bool Bit(int index) const {
+        return (Data()[index / WORD_BITS] >> (index % WORD_BITS)) & 1;
+    }
+
+    void WriteBit(int index, bool value) {
+        uint64_t mask = 1ull << (index % WORD_BITS);
+        uint64_t& word = Data()[index / WORD_BITS];
+        word = value ? (word | mask) : (word & ~mask);
+        ranksStale = true;
+    }
+
+    void CheckIndex(int index) const {
+        if (index < 0 || index >= size) {
+            throw IndexOutOfRange();
+        }
+    }
+
+    void CheckSameSize(const BitSequence* other) const {
+        if (other->size != size) {
+            throw runtime_error("BitSequence: operands have different sizes");
+        }
+    }
+
+    // First bit at or after `from` equal to `value`, -1 if none.
+    int FindFrom(int from, bool value) const {
+        if (from >= size) {
+            return -1;
+        }
+        const uint64_t* data = Data();
+        uint64_t flip = Fill(!value);
+        int word = from / WORD_BITS;
+        uint64_t bits = (data[word] ^ flip) & ~LowMask(from % WORD_BITS);
+        int lastWord = WordCount(size) - 1;
+        while (bits == 0) {
+            if (++word > lastWord) {
+                return -1;
+            }
+            bits = data[word] ^ flip;
+        }
+        int index = word * WORD_BITS + countr_zero(bits);
+        return index < size ? index : -1;
+    }
+
+    void BuildRanks() {
+        int wordCount = WordCount(size);
+        int blockCount = wordCount / WORDS_PER_RANK + 1;
+        delete ranks;
+        ranks = new DynamicArray<int>(blockCount);
+        const uint64_t* data = Data();
+        int total = 0;
+        for (int block = 0; block < blockCount; block++) {
+            (*ranks)[block] = total;
+            int end = min(wordCount, (block + 1) * WORDS_PER_RANK);
+            for (int w = block * WORDS_PER_RANK; w < end; w++) {
+                total += popcount(data[w]);
+            }
+        }
+        ranksStale = false;
+    }
+
+    // The result of `func` on every pair of bits, from the truth table:
+    // for each of the four inputs, all-ones where the input occurs and the
+    // table says true.
+    static uint64_t Combine(uint64_t a, uint64_t b, const bool table[4]) {
+        return (Fill(table[0]) & ~a & ~b) | (Fill(table[1]) & ~a & b)
+               | (Fill(table[2]) & a & ~b) | (Fill(table[3]) & a & b);
+    }
+
+public:
+    BitSequence() {
+        words = new DynamicArray<uint64_t>(1);
+        (*words)[0] = 0;
+    }
+
+    explicit BitSequence(int count, bool value = false) : BitSequence() {
+        if (count < 0) {
+            throw IndexOutOfRange();
+        }
+        Reserve(count);
+        size = count;
+        for (int i = 0; i < WordCount(count); i++) {
+            Data()[i] = Fill(value);
+        }
+        ClearTail();
+    }
+
+    BitSequence(bool* items, int count) : BitSequence() {
+        Reserve(count);
+        for (int i = 0; i < count; i++) {
+            Append(items[i]);
+        }
+    }
+
+    BitSequence(Sequence<bool>* other) : BitSequence() {
+        Reserve(other->GetSize());
+        for (int i = 0; i < other->GetSize(); i++) {
+            Append(other->Get(i));
+        }
+    }
+
+    BitSequence(BitSequence* other) {
+        words = new DynamicArray<uint64_t>(*other->words);
+        size = other->size;
+    }
+
+    ~BitSequence() {
+        delete ranks;
+        delete words;
+    }
+
+    // One bit per element of `sequence`: predicate(element).
+    template <class T, class Predicate>
+    static BitSequence* FromPredicate(Sequence<T>* sequence, Predicate predicate) {
+        int count = sequence->GetSize();
+        BitSequence* mask = new BitSequence(count);
+        uint64_t* data = mask->Data();
+        for (int i = 0; i < count; i++) {
+            data[i / WORD_BITS] |= (uint64_t) (predicate(sequence->Get(i)) ? 1 : 0) << (i % WORD_BITS);
+        }
+        return mask;
+    }
+
+    void Set(int index, bool value) {
+        CheckIndex(index);
+        WriteBit(index, value);
+    }
+
+    // Number of set bits.
+    int Count() const {
+        const uint64_t* data = Data();
+        int total = 0;
+        for (int i = 0; i < WordCount(size); i++) {
+            total += popcount(data[i]);
+        }
+        return total;
+    }
+
+    void And(BitSequence* other) {
+        CheckSameSize(other);
+        for (int i = 0; i < WordCount(size); i++) {
+            Data()[i] &= other->Data()[i];
+        }
+        ranksStale = true;
+    }
+
+    void Or(BitSequence* other) {
+        CheckSameSize(other);
+        for (int i = 0; i < WordCount(size); i++) {
+            Data()[i] |= other->Data()[i];
+        }
+        ranksStale = true;
+    }
+
+    void Xor(BitSequence* other) {
+        CheckSameSize(other);
+        for (int i = 0; i < WordCount(size); i++) {
+            Data()[i] ^= other->Data()[i];
+        }
+        ranksStale = true;
+    }
+
+    void Not() {
+        for (int i = 0; i < WordCount(size); i++) {
+            Data()[i] = ~Data()[i];
+        }
+        ClearTail();
+        ranksStale = true;
+    }
+
+    // Index of the first set bit, -1 if none.
+    int FindFirstSet() const {
+        return FindFrom(0, true);
+    }
+
+    // Index of the first set bit after `index`, -1 if none.
+    int FindNextSet(int index) const {
+        return FindFrom(index + 1, true);
+    }
+
+    // Number of set bits in [0, index), for 0 <= index <= GetSize().
+    int Rank(int index) {
+        if (index < 0 || index > size) {
+            throw IndexOutOfRange();
+        }
+        if (ranksStale) {
+            BuildRanks();
+        }
+        const uint64_t* data = Data();
+        int word = index / WORD_BITS;
+        int block = word / WORDS_PER_RANK;
+        int total = (*ranks)[block];
+        for (int w = block * WORDS_PER_RANK; w < word; w++) {
+            total += popcount(data[w]);
+        }
+        if (index % WORD_BITS != 0) {
+            total += popcount(data[word] & LowMask(index % WORD_BITS));
+        }
+        return total;
+    }
+
+    // Index of the set bit with `rank` set bits before it, -1 if there are
+    // not that many.
+    int Select(int rank) {
+        if (ranksStale) {
+            BuildRanks();
+        }
+        int blockCount = ranks->GetSize();
+        if (rank < 0 || rank >= Count()) {
+            return -1;
+        }
+        int low = 0;
+        int high = blockCount - 1;
+        while (low < high) {
+            int middle = (low + high + 1) / 2;
+            if ((*ranks)[middle] <= rank) {
+                low = middle;
+            } else {
+                high = middle - 1;
+            }
+        }
+        const uint64_t* data = Data();
+        int remaining = rank - (*ranks)[low];
+        int word = low * WORDS_PER_RANK;
+        while (popcount(data[word]) <= remaining) {
+            remaining -= popcount(data[word]);
+            word++;
+        }
+        uint64_t bits = data[word];
+        for (int i = 0; i < remaining; i++) {
+            bits &= bits - 1;
+        }
+        return word * WORD_BITS + countr_zero(bits);
+    }
+
+    // The elements of `source` at the set positions, visiting only those.
+    template <class T>
+    MutableArraySequence<T>* Select(Sequence<T>* source) {
+        if (source->GetSize() < size) {
+            throw IndexOutOfRange();
+        }
+        int count = Count();
+        DynamicArray<T>* selected = new DynamicArray<T>(count);
+        int k = 0;
+        for (int i = FindFirstSet(); i != -1; i = FindNextSet(i)) {
+            (*selected)[k++] = source->Get(i);
+        }
+        return new MutableArraySequence<T>(selected);
+    }
+
+    Sequence<bool>* GetSubSequence(int startIndex, int endIndex) override {
+        if (startIndex < 0 || endIndex > size || startIndex > endIndex) {
+            throw IndexOutOfRange();
+        }
+        BitSequence* subSequence = new BitSequence();
+        subSequence->Reserve(endIndex - startIndex);
+        for (int i = startIndex; i < endIndex; i++) {
+            subSequence->Append(Bit(i));
+        }
+        return subSequence;
+    }
+
+    bool GetFirst() override {
+        if (size == 0) {
+            throw IndexOutOfRange();
+        }
+        return Bit(0);
+    }
+
+    bool GetLast() override {
+        if (size == 0) {
+            throw IndexOutOfRange();
+        }
+        return Bit(size - 1);
+    }
+
+    bool Get(int index) override {
+        CheckIndex(index);
+        return Bit(index);
+    }
+
+    int GetSize() override {
+        return size;
+    }
+
+    // Payload is the packed bits; overhead the unused words, the rank
+    // directory and the objects.
+    CollectionFootprint MemoryFootprint() override {
+        CollectionFootprint footprint;
+        footprint.payloadBytes = ((size_t) size + 7) / 8;
+        footprint.overheadBytes = sizeof(*this) + sizeof(DynamicArray<uint64_t>)
+                                  + sizeof(uint64_t) * (size_t) words->GetSize() - footprint.payloadBytes;
+        footprint.allocationCount = 2;
+        if (ranks != nullptr) {
+            footprint.overheadBytes += sizeof(DynamicArray<int>) + sizeof(int) * (size_t) ranks->GetSize();
+            footprint.allocationCount += 2;
+        }
+        return footprint;
+    }
+
+    bool& operator[](int) override {
+        throw std::runtime_error("Operator[] not supported for packed bits; use Set");
+    }
+
+    const bool& operator[](int index) const override {
+        CheckIndex(index);
+        return Bit(index) ? TRUE_VALUE : FALSE_VALUE;
+    }
+
+    bool TryGet(int index, bool& value) override {
+        CheckIndex(index);
+        value = Bit(index);
+        return true;
+    }
+
+    // Only two values exist: finds the first element equal to whichever
+    // of them the predicate accepts first in the sequence.
+    bool TryFind(function<bool(bool)> predicate, bool& value) override {
+        int firstSet = predicate(true) ? FindFrom(0, true) : -1;
+        int firstClear = predicate(false) ? FindFrom(0, false) : -1;
+        if (firstSet == -1 && firstClear == -1) {
+            return false;
+        }
+        value = firstClear == -1 || (firstSet != -1 && firstSet < firstClear);
+        return true;
+    }
+
+    Sequence<bool>* Map(function<bool(bool)> func) override {
+        bool table[4] = {func(false), func(true), func(false), func(true)};
+        BitSequence* newSequence = new BitSequence(size);
+        for (int i = 0; i < WordCount(size); i++) {
+            newSequence->Data()[i] = Combine(0, Data()[i], table);
+        }
+        newSequence->ClearTail();
+        return newSequence;
+    }
+
+    bool Reduce(function<bool(bool, bool)> func, bool startValue) override {
+        bool result = startValue;
+        for (int i = 0; i < size; i++) {
+            result = func(result, Bit(i));
+        }
+        return result;
+    }
+
+    // The kept elements are all copies of the kept values, so only their
+    // counts matter; keeping both values keeps the order.
+    Sequence<bool>* Where(function<bool(bool)> predicate) override {
+        bool keepSet = predicate(true);
+        bool keepClear = predicate(false);
+        if (keepSet && keepClear) {
+            return new BitSequence(this);
+        }
+        int ones = Count();
+        if (keepSet) {
+            return new BitSequence(ones, true);
+        }
+        return new BitSequence(keepClear ? size - ones : 0, false);
+    }
+
+    Sequence<bool>* Zip(Sequence<bool>* other, function<bool(bool, bool)> func) override {
+        int length = min(size, other->GetSize());
+        BitSequence* newSequence = new BitSequence(length);
+        BitSequence* bits = dynamic_cast<BitSequence*>(other);
+        if (bits != nullptr) {
+            bool table[4] = {func(false, false), func(false, true), func(true, false), func(true, true)};
+            for (int i = 0; i < WordCount(length); i++) {
+                newSequence->Data()[i] = Combine(Data()[i], bits->Data()[i], table);
+            }
+            newSequence->ClearTail();
+            return newSequence;
+        }
+        for (int i = 0; i < length; i++) {
+            newSequence->WriteBit(i, func(Bit(i), other->Get(i)));
+        }
+        return newSequence;
+    }
+
+    Sequence<bool>* Slice(int index, int count, Sequence<bool>* replacement) override {
+        if (index < 0) {
+            index = size + index;
+            if (index < 0) {
+                throw IndexOutOfRange();
+            }
+        }
+        if (index >= size || index + count > size) {
+            throw IndexOutOfRange();
+        }
+        BitSequence* newSequence = new BitSequence();
+        for (int i = 0; i < index; ++i) {
+            newSequence->Append(Bit(i));
+        }
+        if (replacement != nullptr) {
+            for (int i = 0; i < replacement->GetSize(); ++i) {
+                newSequence->Append(replacement->Get(i));
+            }
+        }
+        for (int i = index + count; i < size; ++i) {
+            newSequence->Append(Bit(i));
+        }
+        return newSequence;
+    }
+
+    // Drops the delimiters. With only two values a delimiter is one of them
+    // or both, so this is Where on the negated predicate: no per-bit calls.
+    Sequence<bool>* Split(function<bool(bool)> predicate) override {
+        return Where([&predicate](bool item) { return !predicate(item); });
+    }
+
+    void Append(bool item) override {
+        Reserve(size + 1);
+        size++;
+        WriteBit(size - 1, item);
+    }
+
+    void Prepend(bool item) override {
+        Insert(item, 0);
+    }
+
+    // Shifts the bits from `index` on up by one, a word at a time.
+    void Insert(bool item, int index) override {
+        if (index < 0 || index > size) {
+            throw IndexOutOfRange();
+        }
+        Reserve(size + 1);
+        uint64_t* data = Data();
+        int first = index / WORD_BITS;
+        for (int w = WordCount(size + 1) - 1; w > first; w--) {
+            data[w] = (data[w] << 1) | (data[w - 1] >> (WORD_BITS - 1));
+        }
+        uint64_t low = LowMask(index % WORD_BITS);
+        data[first] = (data[first] & low) | ((data[first] & ~low) << 1);
+        size++;
+        WriteBit(index, item);
+    }
+
+    Sequence<bool>* Concat(Sequence<bool>* list) override {
+        BitSequence* newSequence = new BitSequence(this);
+        newSequence->Reserve(size + list->GetSize());
+        for (int i = 0; i < list->GetSize(); ++i) {
+            newSequence->Append(list->Get(i));
+        }
+        return newSequence;
+    }
+};
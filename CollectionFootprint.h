@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstddef>
+
+// What a collection costs in memory. Payload is sizeof(T) per stored element
+// (heap memory owned by the elements themselves, e.g. long std::string
+// buffers, is not followed); overhead is everything else the collection owns:
+// its own object, node links, unused slots and wrapper objects.
+struct CollectionFootprint {
+    size_t payloadBytes = 0;
+    size_t overheadBytes = 0;
+    size_t allocationCount = 0;
+
+    size_t TotalBytes() const {
+        return payloadBytes + overheadBytes;
+    }
+
+    // Share of the owned bytes that do not hold elements: 0 for a perfectly
+    // packed array, approaching 1 when headers or empty slots dominate.
+    double FragmentationRatio() const {
+        return TotalBytes() == 0 ? 0.0 : (double) overheadBytes / TotalBytes();
+    }
+
+    // Adds an owning wrapper of `wrapperBytes` that holds this collection
+    // through one heap allocation, as the sequences hold their storage.
+    CollectionFootprint Wrapped(size_t wrapperBytes) const {
+        CollectionFootprint result = *this;
+        result.overheadBytes += wrapperBytes;
+        result.allocationCount += 1;
+        return result;
+    }
+};
@@ -0,0 +1,222 @@
+#pragma once
+
+#include <climits>
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "DynamicArray.h"
+#include "MutableArraySequence.h"
+#include "IndexOutOfRange.h"
+
+// Records stored column by column (a struct of arrays): field I of every
+// row lives in its own DynamicArray, so a scan over one field reads only
+// that field's bytes, from a contiguous array the compiler can vectorise.
+//
+//   ColumnarSequence<long long, int, double, int> trades;   // time, id, price, qty
+//   trades.Append(time, id, price, qty);
+//   double volume = trades.Reduce<2, 3>([](double sum, double price, int qty) {
+//       return sum + price * qty;
+//   }, 0.0);
+//
+// Map, Reduce and Where name the columns they read as template arguments
+// and the callback receives those fields only. Rows are assembled on
+// demand: Get returns a tuple copy, operator[] a proxy into the columns.
+template <class... Fields>
+class ColumnarSequence {
+public:
+    using Row = tuple<Fields...>;
+
+    template <size_t I>
+    using FieldType = tuple_element_t<I, Row>;
+
+    // A row by reference: Field<I>() is the element of column I.
+    class RowRef {
+    private:
+        ColumnarSequence<Fields...>* owner;
+        int index;
+
+    public:
+        RowRef(ColumnarSequence<Fields...>* owner, int index) : owner(owner), index(index) {}
+
+        template <size_t I>
+        FieldType<I>& Field() const {
+            return owner->template Data<I>()[index];
+        }
+
+        operator Row() const {
+            return owner->Get(index);
+        }
+
+        RowRef& operator=(const Row& row) {
+            owner->Store(index, row, index_sequence_for<Fields...>());
+            return *this;
+        }
+    };
+
+private:
+    tuple<DynamicArray<Fields>*...> columns;
+    int size = 0;
+    int capacity = 0;
+
+    template <size_t I>
+    FieldType<I>* Data() const {
+        return capacity > 0 ? &(*get<I>(columns))[0] : nullptr;
+    }
+
+    void Reserve(int count) {
+        if (count <= capacity) {
+            return;
+        }
+        int newCapacity = GrowCapacity(capacity, count, 8);
+        apply([newCapacity](auto*... column) { (column->Resize(newCapacity), ...); }, columns);
+        capacity = newCapacity;
+    }
+
+    template <size_t... Is>
+    void Store(int index, const Row& row, index_sequence<Is...>) {
+        ((Data<Is>()[index] = get<Is>(row)), ...);
+    }
+
+    template <size_t... Is>
+    Row Load(int index, index_sequence<Is...>) const {
+        return Row(Data<Is>()[index]...);
+    }
+
+    // Copies rows `selection[0, count)` of every column into `target`.
+    template <size_t... Is>
+    void Gather(ColumnarSequence<Fields...>* target, const int* selection, int count, index_sequence<Is...>) const {
+        (GatherColumn<Is>(target, selection, count), ...);
+    }
+
+    template <size_t I>
+    void GatherColumn(ColumnarSequence<Fields...>* target, const int* selection, int count) const {
+        const FieldType<I>* source = Data<I>();
+        FieldType<I>* destination = target->template Data<I>();
+        for (int k = 0; k < count; k++) {
+            destination[k] = source[selection[k]];
+        }
+    }
+
+    void CheckIndex(int index) const {
+        if (index < 0 || index >= size) {
+            throw IndexOutOfRange();
+        }
+    }
+
+public:
+    ColumnarSequence() : columns(new DynamicArray<Fields>(0)...) {}
+
+    ColumnarSequence(const ColumnarSequence<Fields...>& other) : ColumnarSequence() {
+        Reserve(other.size);
+        int all = other.size;
+        DynamicArray<int> selection(all > 0 ? all : 1);
+        for (int i = 0; i < all; i++) {
+            selection[i] = i;
+        }
+        other.Gather(this, &selection[0], all, index_sequence_for<Fields...>());
+        size = all;
+    }
+
+    ColumnarSequence& operator=(const ColumnarSequence<Fields...>&) = delete;
+
+    ~ColumnarSequence() {
+        apply([](auto*... column) { (delete column, ...); }, columns);
+    }
+
+    int GetSize() const {
+        return size;
+    }
+
+    void Append(const Fields&... values) {
+        Append(Row(values...));
+    }
+
+    void Append(const Row& row) {
+        Reserve(size + 1);
+        Store(size, row, index_sequence_for<Fields...>());
+        size++;
+    }
+
+    Row Get(int index) const {
+        CheckIndex(index);
+        return Load(index, index_sequence_for<Fields...>());
+    }
+
+    RowRef operator[](int index) {
+        CheckIndex(index);
+        return RowRef(this, index);
+    }
+
+    template <size_t I>
+    FieldType<I> GetField(int index) const {
+        CheckIndex(index);
+        return Data<I>()[index];
+    }
+
+    // Column I as a plain array of GetSize() elements, for hand-written
+    // loops; valid until the next Append.
+    template <size_t I>
+    FieldType<I>* Column() {
+        return Data<I>();
+    }
+
+    // func(field<Is>...) for every row, as a sequence.
+    template <size_t... Is, class Func>
+    auto Map(Func func) const {
+        using Result = decay_t<invoke_result_t<Func, const FieldType<Is>&...>>;
+        DynamicArray<Result>* storage = new DynamicArray<Result>(size);
+        if (size > 0) {
+            Result* output = &(*storage)[0];
+            apply([&](const auto*... data) {
+                for (int i = 0; i < size; i++) {
+                    output[i] = func(data[i]...);
+                }
+            }, make_tuple(Data<Is>()...));
+        }
+        return new MutableArraySequence<Result>(storage);
+    }
+
+    // Folds func(accumulator, field<Is>...) over the rows in order.
+    template <size_t... Is, class Func, class Value>
+    Value Reduce(Func func, Value startValue) const {
+        Value result = startValue;
+        apply([&](const auto*... data) {
+            for (int i = 0; i < size; i++) {
+                result = func(result, data[i]...);
+            }
+        }, make_tuple(Data<Is>()...));
+        return result;
+    }
+
+    // Rows for which predicate(field<Is>...) holds, in order. The predicate
+    // reads only its columns; the other columns are touched only for the
+    // rows that pass.
+    template <size_t... Is, class Predicate>
+    ColumnarSequence<Fields...>* Where(Predicate predicate) const {
+        DynamicArray<int> selection(size > 0 ? size : 1);
+        int* selected = &selection[0];
+        int count = 0;
+        apply([&](const auto*... data) {
+            for (int i = 0; i < size; i++) {
+                selected[count] = i;
+                count += predicate(data[i]...) ? 1 : 0;
+            }
+        }, make_tuple(Data<Is>()...));
+        ColumnarSequence<Fields...>* result = new ColumnarSequence<Fields...>();
+        result->Reserve(count);
+        Gather(result, selected, count, index_sequence_for<Fields...>());
+        result->size = count;
+        return result;
+    }
+
+    CollectionFootprint MemoryFootprint() {
+        CollectionFootprint footprint;
+        footprint.payloadBytes = (sizeof(Fields) + ...) * (size_t) size;
+        footprint.overheadBytes = sizeof(*this) + (sizeof(DynamicArray<Fields>) + ...)
+                                  + (sizeof(Fields) + ...) * (size_t) (capacity - size);
+        footprint.allocationCount = 2 * sizeof...(Fields);
+        return footprint;
+    }
+};
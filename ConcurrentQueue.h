@@ -0,0 +1,156 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <stdexcept>
+#include <utility>
+
+using namespace std;
+
+// A bounded multi-producer, multi-consumer queue without locks, for
+// handing work between threads where a mutex around a LinkedList would
+// serialise them.
+//
+// The queue is a ring of cells, each stamped with a sequence number that
+// says whose turn the cell is: a producer claiming position p waits for
+// sequence p (empty), a consumer for p + 1 (full). Claiming a position is
+// one compare-and-swap on the shared head or tail index, and the handover
+// is the release store of the next stamp, so producers and consumers only
+// contend among themselves, never on one lock. All cells are allocated up
+// front and reused, which leaves no freed node for a slow thread to touch
+// and needs no hazard pointers or epochs.
+//
+// TryPush fails when the queue is full and TryPop when it is empty;
+// neither blocks. TryPopBatch takes up to `count` items with a single
+// claim, so a consumer draining a busy queue pays for the contended CAS
+// once per batch instead of once per item.
+template <class T>
+class ConcurrentQueue {
+private:
+    static const size_t CACHE_LINE = 64;
+
+    struct Cell {
+        atomic<size_t> sequence;
+        T value;
+    };
+
+    Cell* cells;
+    size_t mask;
+    // Producers and consumers each write their own index; keeping them on
+    // separate cache lines stops one side from invalidating the other's.
+    alignas(CACHE_LINE) atomic<size_t> tail{0};
+    alignas(CACHE_LINE) atomic<size_t> head{0};
+
+public:
+    // `capacity` is rounded up to a power of two.
+    explicit ConcurrentQueue(int capacity) {
+        if (capacity < 1) {
+            throw std::invalid_argument("ConcurrentQueue capacity must be positive");
+        }
+        size_t size = 2;
+        while (size < (size_t) capacity) {
+            size <<= 1;
+        }
+        mask = size - 1;
+        cells = new Cell[size];
+        for (size_t i = 0; i < size; i++) {
+            cells[i].sequence.store(i, memory_order_relaxed);
+        }
+    }
+
+    ConcurrentQueue(const ConcurrentQueue&) = delete;
+    ConcurrentQueue& operator=(const ConcurrentQueue&) = delete;
+
+    ~ConcurrentQueue() {
+        delete[] cells;
+    }
+
+    int GetCapacity() const {
+        return (int) (mask + 1);
+    }
+
+    // A snapshot that may be stale by the time it returns.
+    int ApproximateSize() const {
+        size_t pushed = tail.load(memory_order_relaxed);
+        size_t popped = head.load(memory_order_relaxed);
+        return pushed > popped ? (int) (pushed - popped) : 0;
+    }
+
+    bool TryPush(T item) {
+        size_t position = tail.load(memory_order_relaxed);
+        for (;;) {
+            Cell& cell = cells[position & mask];
+            size_t sequence = cell.sequence.load(memory_order_acquire);
+            ptrdiff_t turn = (ptrdiff_t) (sequence - position);
+            if (turn == 0) {
+                if (tail.compare_exchange_weak(position, position + 1, memory_order_relaxed)) {
+                    cell.value = std::move(item);
+                    cell.sequence.store(position + 1, memory_order_release);
+                    return true;
+                }
+            } else if (turn < 0) {
+                // The cell still holds the item from one lap ago: full.
+                return false;
+            } else {
+                position = tail.load(memory_order_relaxed);
+            }
+        }
+    }
+
+    bool TryPop(T& item) {
+        size_t position = head.load(memory_order_relaxed);
+        for (;;) {
+            Cell& cell = cells[position & mask];
+            size_t sequence = cell.sequence.load(memory_order_acquire);
+            ptrdiff_t turn = (ptrdiff_t) (sequence - (position + 1));
+            if (turn == 0) {
+                if (head.compare_exchange_weak(position, position + 1, memory_order_relaxed)) {
+                    item = std::move(cell.value);
+                    cell.sequence.store(position + mask + 1, memory_order_release);
+                    return true;
+                }
+            } else if (turn < 0) {
+                return false;
+            } else {
+                position = head.load(memory_order_relaxed);
+            }
+        }
+    }
+
+    // Pops up to `count` items into `items`, in queue order; returns how
+    // many, 0 when the queue is empty.
+    int TryPopBatch(T* items, int count) {
+        size_t position = head.load(memory_order_relaxed);
+        for (;;) {
+            // The run of full cells from `position`, up to `count`.
+            int ready = 0;
+            while (ready < count) {
+                size_t sequence = cells[(position + ready) & mask].sequence.load(memory_order_acquire);
+                if (sequence != position + ready + 1) {
+                    break;
+                }
+                ready++;
+            }
+            if (ready == 0) {
+                size_t sequence = cells[position & mask].sequence.load(memory_order_acquire);
+                if ((ptrdiff_t) (sequence - (position + 1)) < 0) {
+                    return 0;
+                }
+                position = head.load(memory_order_relaxed);
+                continue;
+            }
+            // Full cells stay full until their consumer empties them, so
+            // winning the claim on [position, position + ready) makes them
+            // all ours.
+            if (head.compare_exchange_weak(position, position + ready, memory_order_relaxed)) {
+                for (int i = 0; i < ready; i++) {
+                    Cell& cell = cells[(position + i) & mask];
+                    items[i] = std::move(cell.value);
+                    cell.sequence.store(position + i + mask + 1, memory_order_release);
+                }
+                return ready;
+            }
+        }
+    }
+};
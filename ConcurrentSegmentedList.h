@@ -0,0 +1,139 @@
+#pragma once
+
+#include <atomic>
+#include <climits>
+#include <cstddef>
+#include <stdexcept>
+#include <utility>
+
+#include "CollectionFootprint.h"
+#include "IndexOutOfRange.h"
+#include "SegmentDirectory.h"
+
+using namespace std;
+
+// An append-only SegmentedList that many threads append to and read from
+// at once, for event logs.
+//
+// Append reserves its slot with one fetch-add on a shared counter, so no
+// writer ever waits for another. It then finds its segment in a
+// SegmentDirectory, constructs the element and marks the slot ready with a
+// release store. The first writer into a segment allocates the next one
+// and publishes it with a release CAS, so writers crossing into a new
+// segment almost always find it waiting.
+//
+// Slots can finish out of order, so readers only see the committed prefix:
+// every element below the watermark is ready. GetCommittedSize() moves the
+// watermark over the slots that have become ready since the last call, and
+// Get and ForEach read below it without locks. Elements never move once
+// written, so a reader holding an index is never invalidated.
+template <class T>
+class ConcurrentSegmentedList {
+public:
+    static const int SEGMENT_SIZE = 1 << 14;
+
+private:
+    static const int MAX_SEGMENTS = INT_MAX / SEGMENT_SIZE + 1;
+    static const size_t CACHE_LINE = 64;
+
+    using Segment = SlotBlock<T, SEGMENT_SIZE>;
+
+    SegmentDirectory<Segment, MAX_SEGMENTS> directory;
+    // Writers hammer `reserved`; readers advance `committed`. Each gets its
+    // own cache line.
+    alignas(CACHE_LINE) atomic<long long> reserved{0};
+    alignas(CACHE_LINE) atomic<long long> committed{0};
+
+    bool IsReady(long long index) const {
+        const Segment* segment = directory.Get((int) (index / SEGMENT_SIZE));
+        return segment != nullptr && segment->IsReady((int) (index % SEGMENT_SIZE));
+    }
+
+public:
+    ConcurrentSegmentedList() = default;
+
+    ConcurrentSegmentedList(const ConcurrentSegmentedList&) = delete;
+    ConcurrentSegmentedList& operator=(const ConcurrentSegmentedList&) = delete;
+
+    // Not safe while other threads still append or read.
+    ~ConcurrentSegmentedList() = default;
+
+    // Appends `item` from any thread and returns its index.
+    int Append(T item) {
+        long long index = reserved.fetch_add(1, memory_order_relaxed);
+        if (index >= INT_MAX) {
+            throw std::length_error("ConcurrentSegmentedList is full");
+        }
+        int segmentIndex = (int) (index / SEGMENT_SIZE);
+        int offset = (int) (index % SEGMENT_SIZE);
+        Segment* segment = directory.Publish(segmentIndex);
+        if (offset == 0 && segmentIndex + 1 < MAX_SEGMENTS) {
+            directory.Publish(segmentIndex + 1);
+        }
+        segment->Construct(offset, std::move(item));
+        return (int) index;
+    }
+
+    // Slots handed out so far, written or not.
+    int GetReservedSize() const {
+        long long count = reserved.load(memory_order_relaxed);
+        return count < INT_MAX ? (int) count : INT_MAX;
+    }
+
+    // The watermark: elements [0, size) are all written and readable.
+    // Advances it over every slot that has become ready since.
+    int GetCommittedSize() {
+        long long mark = committed.load(memory_order_acquire);
+        long long end = reserved.load(memory_order_acquire);
+        long long limit = end < INT_MAX ? end : INT_MAX;
+        long long reached = mark;
+        while (reached < limit && IsReady(reached)) {
+            reached++;
+        }
+        // Other readers may have moved it further meanwhile; keep the larger.
+        while (mark < reached && !committed.compare_exchange_weak(mark, reached, memory_order_release, memory_order_acquire)) {
+        }
+        return (int) (mark > reached ? mark : reached);
+    }
+
+    // Reads a committed element; indices at or past the watermark throw.
+    const T& Get(int index) {
+        if (index < 0 || (index >= committed.load(memory_order_acquire) && index >= GetCommittedSize())) {
+            throw IndexOutOfRange();
+        }
+        return (*directory.Get(index / SEGMENT_SIZE))[index % SEGMENT_SIZE];
+    }
+
+    // Calls func(const T&) for the committed elements from `from` on, a
+    // segment at a time, and returns where it stopped: pass that back in to
+    // tail the log as it grows.
+    template <class Func>
+    int ForEach(int from, Func func) {
+        int end = GetCommittedSize();
+        int index = from < 0 ? 0 : from;
+        while (index < end) {
+            const Segment* segment = directory.Get(index / SEGMENT_SIZE);
+            int stop = index - index % SEGMENT_SIZE + SEGMENT_SIZE;
+            stop = stop < end ? stop : end;
+            for (int offset = index % SEGMENT_SIZE; index < stop; index++, offset++) {
+                func((*segment)[offset]);
+            }
+        }
+        return index;
+    }
+
+    // Includes segments published ahead of the writers.
+    CollectionFootprint MemoryFootprint() {
+        size_t segments = (size_t) directory.BlockCount();
+        CollectionFootprint footprint;
+        footprint.payloadBytes = sizeof(T) * (size_t) GetCommittedSize();
+        footprint.overheadBytes = sizeof(*this) + directory.PageBytes() + sizeof(Segment) * segments
+                                  - footprint.payloadBytes;
+        footprint.allocationCount = segments + (size_t) directory.PageCount();
+        return footprint;
+    }
+
+    int GetSize() {
+        return GetCommittedSize();
+    }
+};
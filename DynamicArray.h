@@ -0,0 +1,259 @@
+#pragma once
+
+#include <climits>
+#include <type_traits>
+#include "ICollection.h"
+#include "AllocationTracker.h"
+#include "MappedFile.h"
+
+// The capacity to grow to when `needed` elements no longer fit in
+// `capacity`: doubled from `capacity` (at least `minimum`) until they fit,
+// saturating at INT_MAX. Every container that keeps spare capacity grows
+// through this, so repeated appends cost O(1) amortised.
+inline int GrowCapacity(int capacity, int needed, int minimum) {
+    int newCapacity = capacity < minimum ? minimum : capacity;
+    while (newCapacity < needed) {
+        newCapacity = newCapacity > INT_MAX / 2 ? INT_MAX : newCapacity * 2;
+    }
+    return newCapacity;
+}
+
+template <class T>
+class DynamicArray : public ICollection<T>{
+private:
+    T *data;
+    int size;
+    // File-backed storage: `data` points into the mapping and `capacity`
+    // elements fit in the file before it has to grow. A view maps part of a
+    // file copy-on-write and moves to the heap on its first resize.
+    MappedFile* file = nullptr;
+    int capacity = 0;
+    bool view = false;
+
+    static AllocationStats& Stats() {
+        static AllocationStats& stats = AllocationTracker::Register("DynamicArray");
+        return stats;
+    }
+
+    static T* Allocate(int count) {
+        AllocationTracker::OnAllocate(Stats(), sizeof(T) * count);
+        return new T[count];
+    }
+
+    static void Release(T* block, int count) {
+        AllocationTracker::OnFree(Stats(), sizeof(T) * count);
+        delete[] block;
+    }
+
+    DynamicArray(MappedFile* file, int count) : data((T*) file->Data()), size(count), file(file),
+                                                capacity((int) (file->Length() / sizeof(T))) {}
+
+    void DetachView(int newSize) {
+        T* newData = Allocate(newSize);
+        int copySize = (newSize < size) ? newSize : size;
+        for (int i = 0; i < copySize; i++) {
+            newData[i] = data[i];
+        }
+        delete file;
+        file = nullptr;
+        view = false;
+        capacity = 0;
+        data = newData;
+        size = newSize;
+    }
+
+    void ResizeMapped(int newSize) {
+        if (newSize > capacity) {
+            int newCapacity = GrowCapacity(capacity, newSize, 512);
+            file->Grow(sizeof(T) * (size_t) newCapacity);
+            data = (T*) file->Data();
+            capacity = newCapacity;
+        }
+        size = newSize;
+    }
+
+public:
+    DynamicArray(T* items, int count) : size(count) {
+        data = Allocate(count);
+        for (int i = 0; i < count; i++) {
+            data[i] = items[i];
+        }
+    }
+
+    DynamicArray(int size) : size(size) {
+        data = Allocate(size);
+    }
+
+    DynamicArray() : DynamicArray(0) {}
+
+    DynamicArray(const DynamicArray<T> &dynamicArray) : size(dynamicArray.size) {
+        data = Allocate(size);
+        for (int i = 0; i < size; i++) {
+            data[i] = dynamicArray.data[i];
+        }
+    };
+
+    ~DynamicArray() {
+        if (file) {
+            file->Close(view ? file->Length() : sizeof(T) * (size_t) size);
+            delete file;
+        } else {
+            Release(data, size);
+        }
+    }
+
+    // Creates (or truncates) `path` and maps it as an array of `count`
+    // zero-initialised elements. Growth doubles the file with ftruncate and
+    // mremap, so Append is amortised O(1) in this mode.
+    static DynamicArray<T>* CreateMapped(const string& path, int count = 0) {
+        static_assert(is_trivially_copyable_v<T>, "file-backed DynamicArray needs a trivially copyable T");
+        MappedFile* file = new MappedFile(path, true, sizeof(T) * (size_t) count);
+        return new DynamicArray<T>(file, count);
+    }
+
+    // Maps an existing file of raw elements in O(1): no reads, no copies;
+    // the element count is the file length / sizeof(T).
+    static DynamicArray<T>* OpenMapped(const string& path) {
+        static_assert(is_trivially_copyable_v<T>, "file-backed DynamicArray needs a trivially copyable T");
+        MappedFile* file = new MappedFile(path, false);
+        if (file->Length() % sizeof(T) != 0 || file->Length() / sizeof(T) > (size_t) INT_MAX) {
+            delete file;
+            throw runtime_error("DynamicArray: " + path + " is not a whole number of elements");
+        }
+        return new DynamicArray<T>(file, (int) (file->Length() / sizeof(T)));
+    }
+
+    // Maps `count` elements starting `offset` bytes into `path` without
+    // reading or copying them. The mapping is private: writes stay in memory
+    // and the file is never modified. `offset` must keep elements aligned.
+    static DynamicArray<T>* MapView(const string& path, size_t offset, int count) {
+        static_assert(is_trivially_copyable_v<T>, "file-backed DynamicArray needs a trivially copyable T");
+        MappedFile* file = new MappedFile(path, false, 0, true);
+        if (offset % alignof(T) != 0 || file->Length() < offset + sizeof(T) * (size_t) count) {
+            delete file;
+            throw runtime_error("DynamicArray: " + path + " is too short for the requested view");
+        }
+        DynamicArray<T>* array = new DynamicArray<T>(file, count);
+        array->data = (T*) ((char*) file->Data() + offset);
+        array->capacity = count;
+        array->view = true;
+        return array;
+    }
+
+    bool IsMapped() const {
+        return file != nullptr;
+    }
+
+    // Writes dirty pages back with msync. Spare capacity stays in the file
+    // until the array is destroyed, which trims it to the element count.
+    void Flush() {
+        if (file) {
+            file->Flush(sizeof(T) * (size_t) size);
+        }
+    }
+
+    // madvise hint for the mapping; a no-op for heap storage.
+    void Advise(AccessHint hint) {
+        if (file) {
+            file->Advise(hint);
+        }
+    }
+
+    T Get(int index) override{
+        if (index < 0 || index >= size) {
+            throw IndexOutOfRange();
+        }
+        return data[index];
+    }
+
+    int GetSize() override{
+        return size;
+    }
+
+    CollectionFootprint MemoryFootprint() override {
+        CollectionFootprint footprint;
+        footprint.payloadBytes = sizeof(T) * size;
+        footprint.overheadBytes = sizeof(*this);
+        footprint.allocationCount = 1;
+        if (file) {
+            footprint.overheadBytes += sizeof(MappedFile) + sizeof(T) * (size_t) (capacity - size);
+            footprint.allocationCount = 2;
+        }
+        return footprint;
+    }
+
+    void Set(int index, T value) {
+        if (index < 0 || index >= size) {
+            throw IndexOutOfRange();
+        }
+        data[index] = value;
+    }
+
+    void Resize(int newSize) {
+        if (newSize <= 0) {
+            throw IndexOutOfRange();
+        }
+        if (file && view) {
+            DetachView(newSize);
+            return;
+        }
+        if (file) {
+            ResizeMapped(newSize);
+            return;
+        }
+        T* newData = Allocate(newSize);
+        //null
+        int copySize = (newSize < size) ? newSize : size;
+        for (int i = 0; i < copySize; i++) {
+            newData[i] = data[i];
+        }
+        Release(data, size);
+        data = newData;
+        size = newSize;
+    }
+
+    T& operator[](int index) {
+        if (index < 0 || index >= size) {
+            throw IndexOutOfRange();
+        }
+        return data[index];
+    }
+
+    const T& operator[](int index) const {
+        if (index < 0 || index >= size) {
+            throw IndexOutOfRange();
+        }
+        return data[index];
+    }
+
+    void Append(T item) override{
+        Resize(GetSize() + 1);
+        data[GetSize() - 1] = item;
+    }
+
+    void Prepend(T item) override{
+        Resize(GetSize() + 1);
+        for (int i = GetSize() - 1; i > 0; i--) {
+            data[i] = data[i - 1];
+        }
+        data[0] = item;
+    }
+
+    void Insert(T item, int index) override{
+        if (index < 0 || index > size) {
+            throw IndexOutOfRange();
+        }
+
+        if (index == 0) {
+            Prepend(item);
+        } else if (index == size) {
+            Append(item);
+        } else {
+            Resize(GetSize() + 1);
+            for (int i = GetSize() - 1; i > index; i--) {
+                data[i] = data[i - 1];
+            }
+            Set(index, item);
+        }
+    }
+};
@@ -0,0 +1,398 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "DynamicArray.h"
+#include "Sequence.h"
+#include "MutableArraySequence.h"
+#include "Serialization.h"
+#include "Sorting.h"
+
+using namespace std;
+
+struct ExternalSortOptions {
+    // Upper bound on element buffers held at once, in bytes: the run buffer
+    // while runs are generated, reader plus writer buffers while merging.
+    size_t memoryBytes = 64u << 20;
+    // Smallest per-run read buffer during a merge. Fewer, larger buffers
+    // keep reads sequential; runs beyond memoryBytes / this are merged in
+    // several passes.
+    size_t minMergeBufferBytes = 64u << 10;
+    // Where spill files go; the system temp directory when empty.
+    string tempDirectory;
+};
+
+struct ExternalSortStats {
+    long long elements = 0;
+    int runs = 0;
+    int mergePasses = 0;
+    long long bytesSpilled = 0;
+};
+
+// Buffered sequential reader over the payload of one sorted run.
+template <class T>
+class SortRunReader {
+private:
+    ifstream in;
+    long long remaining;
+    DynamicArray<T> buffer;
+    int position = 0;
+    int length = 0;
+
+    void Refill() {
+        long long wanted = remaining < buffer.GetSize() ? remaining : buffer.GetSize();
+        if (wanted > 0 && !in.read((char*) &buffer[0], (streamsize) (sizeof(T) * wanted))) {
+            throw SerializationError("truncated sort run");
+        }
+        remaining -= wanted;
+        position = 0;
+        length = (int) wanted;
+    }
+
+public:
+    SortRunReader(const string& path, int bufferElements) : in(path, ios::binary), buffer(bufferElements) {
+        if (!in) {
+            throw SerializationError("cannot open " + path);
+        }
+        remaining = (long long) ReadSequenceHeader<T>(in).count;
+        Refill();
+    }
+
+    bool Exhausted() const {
+        return position == length;
+    }
+
+    const T& Head() const {
+        return buffer[position];
+    }
+
+    void Advance() {
+        if (++position == length) {
+            Refill();
+        }
+    }
+};
+
+// Tournament tree of losers over k sorted runs: the winner is at tree[0],
+// each internal node keeps the loser of the match played there, so taking
+// the next element replays one leaf-to-root path of log2(k) comparisons.
+// Ties go to the lower run index, which keeps the merge stable.
+template <class T, class Compare>
+class LoserTree {
+private:
+    vector<SortRunReader<T>*>& runs;
+    Compare& compare;
+    vector<int> tree;
+    int k;
+
+    bool Beats(int a, int b) const {
+        if (runs[a]->Exhausted()) {
+            return false;
+        }
+        if (runs[b]->Exhausted()) {
+            return true;
+        }
+        if (compare(runs[a]->Head(), runs[b]->Head())) {
+            return true;
+        }
+        return !compare(runs[b]->Head(), runs[a]->Head()) && a < b;
+    }
+
+    // Leaves live at k..2k-1 of the implicit heap, internal nodes at 1..k-1.
+    int Build(int node) {
+        if (node >= k) {
+            return node - k;
+        }
+        int left = Build(2 * node);
+        int right = Build(2 * node + 1);
+        if (Beats(left, right)) {
+            tree[node] = right;
+            return left;
+        }
+        tree[node] = left;
+        return right;
+    }
+
+public:
+    LoserTree(vector<SortRunReader<T>*>& runs, Compare& compare)
+        : runs(runs), compare(compare), tree(runs.size()), k((int) runs.size()) {
+        tree[0] = Build(1);
+    }
+
+    bool Empty() const {
+        return runs[tree[0]]->Exhausted();
+    }
+
+    const T& Top() const {
+        return runs[tree[0]]->Head();
+    }
+
+    void Pop() {
+        int winner = tree[0];
+        runs[winner]->Advance();
+        for (int node = (winner + k) / 2; node > 0; node /= 2) {
+            if (Beats(tree[node], winner)) {
+                swap(tree[node], winner);
+            }
+        }
+        tree[0] = winner;
+    }
+};
+
+// Sorts inputs larger than the memory budget: the input is cut into
+// budget-sized runs that are sorted in memory and spilled as sequence files
+// (see Serialization.h), then the runs are merged through a LoserTree with
+// buffered reads and writes, in as many passes as the fan-in requires.
+// Spill files are removed as soon as they are merged, and by the destructor
+// if a sort throws. Needs a trivially copyable T.
+template <class T, class Compare = less<T>>
+class ExternalSorter {
+private:
+    ExternalSortOptions options;
+    Compare compare;
+    ExternalSortStats stats;
+    vector<string> spills;
+
+    // Produces up to `capacity` input elements into `items`; 0 at the end.
+    using Source = function<int(T* items, int capacity)>;
+    // Receives sorted output in order.
+    using Sink = function<void(const T* items, int count)>;
+
+    int BudgetElements() const {
+        size_t elements = options.memoryBytes / sizeof(T);
+        if (elements > (size_t) INT_MAX) {
+            elements = INT_MAX;
+        }
+        return elements < 2 ? 2 : (int) elements;
+    }
+
+    // One buffer per input run plus one for the output.
+    static int MergeBuffer(int budget, int inputs) {
+        return max(budget / (inputs + 1), 1);
+    }
+
+    string SpillPath() {
+        static atomic<long long> counter{0};
+        filesystem::path directory = options.tempDirectory.empty()
+                                     ? filesystem::temp_directory_path()
+                                     : filesystem::path(options.tempDirectory);
+        string name = "lab2_sort_" + to_string(chrono::steady_clock::now().time_since_epoch().count())
+                      + "_" + to_string(counter++) + ".run";
+        spills.push_back((directory / name).string());
+        return spills.back();
+    }
+
+    void RemoveSpill(const string& path) {
+        filesystem::remove(path);
+        spills.erase(find(spills.begin(), spills.end(), path));
+    }
+
+    static Source FileSource(ifstream& in, long long& remaining) {
+        return [&in, &remaining](T* items, int capacity) {
+            long long wanted = remaining < capacity ? remaining : capacity;
+            if (wanted > 0 && !in.read((char*) items, (streamsize) (sizeof(T) * wanted))) {
+                throw SerializationError("truncated payload");
+            }
+            remaining -= wanted;
+            return (int) wanted;
+        };
+    }
+
+    static Source SequenceSource(Sequence<T>* sequence) {
+        int next = 0;
+        return [sequence, next](T* items, int capacity) mutable {
+            int count = sequence->GetSize() - next < capacity ? sequence->GetSize() - next : capacity;
+            T* contiguous = ContiguousData(sequence);
+            if (contiguous != nullptr) {
+                copy(contiguous + next, contiguous + next + count, items);
+            } else {
+                for (int i = 0; i < count; i++) {
+                    items[i] = sequence->Get(next + i);
+                }
+            }
+            next += count;
+            return count;
+        };
+    }
+
+    // Merges `inputs` into one sorted stream, each run reading through a
+    // buffer of `bufferElements`.
+    void MergeRuns(const vector<string>& inputs, int bufferElements, const Sink& sink) {
+        vector<SortRunReader<T>*> readers;
+        DynamicArray<T> output(bufferElements);
+        try {
+            for (const string& input : inputs) {
+                readers.push_back(new SortRunReader<T>(input, bufferElements));
+            }
+            LoserTree<T, Compare> tree(readers, compare);
+            int pending = 0;
+            while (!tree.Empty()) {
+                output[pending++] = tree.Top();
+                tree.Pop();
+                if (pending == bufferElements) {
+                    sink(&output[0], pending);
+                    pending = 0;
+                }
+            }
+            if (pending > 0) {
+                sink(&output[0], pending);
+            }
+        } catch (...) {
+            for (SortRunReader<T>* reader : readers) {
+                delete reader;
+            }
+            throw;
+        }
+        for (SortRunReader<T>* reader : readers) {
+            delete reader;
+        }
+    }
+
+    // `total` is the input length, known up front for files and sequences.
+    void Run(const Source& source, long long total, const Sink& sink) {
+        stats = ExternalSortStats();
+        int budget = BudgetElements();
+        vector<string> runs;
+        {
+            int runLength = (int) min<long long>(budget, max(total, 1LL));
+            DynamicArray<T> buffer(runLength);
+            T* items = &buffer[0];
+            while (true) {
+                int count = 0;
+                while (count < runLength) {
+                    int produced = source(items + count, runLength - count);
+                    if (produced == 0) {
+                        break;
+                    }
+                    count += produced;
+                }
+                if (count == 0) {
+                    break;
+                }
+                stats.elements += count;
+                // In place, so the run buffer is the whole budget.
+                PdqSort(items, items + count, compare);
+                if (total <= budget) {
+                    // Everything fits in one buffer: no spill at all.
+                    stats.runs = 1;
+                    sink(items, count);
+                    return;
+                }
+                SequenceFileWriter<T> writer(SpillPath());
+                writer.Write(items, (size_t) count);
+                writer.Close();
+                runs.push_back(spills.back());
+                stats.bytesSpilled += (long long) sizeof(T) * count;
+                if (count < runLength) {
+                    break;
+                }
+            }
+        }
+        stats.runs = (int) runs.size();
+
+        int minBuffer = (int) max<size_t>(options.minMergeBufferBytes / sizeof(T), 1);
+        int fanIn = max(budget / minBuffer - 1, 2);
+        while ((int) runs.size() > fanIn) {
+            stats.mergePasses++;
+            vector<string> merged;
+            for (size_t first = 0; first < runs.size(); first += fanIn) {
+                vector<string> group(runs.begin() + first, runs.begin() + min(first + fanIn, runs.size()));
+                if (group.size() == 1) {
+                    merged.push_back(group[0]);
+                    continue;
+                }
+                SequenceFileWriter<T> writer(SpillPath());
+                merged.push_back(spills.back());
+                MergeRuns(group, MergeBuffer(budget, (int) group.size()), [&](const T* items, int count) {
+                    writer.Write(items, (size_t) count);
+                });
+                writer.Close();
+                stats.bytesSpilled += (long long) sizeof(T) * (long long) writer.Count();
+                for (const string& run : group) {
+                    RemoveSpill(run);
+                }
+            }
+            runs = merged;
+        }
+        if (!runs.empty()) {
+            stats.mergePasses++;
+            MergeRuns(runs, MergeBuffer(budget, (int) runs.size()), sink);
+        }
+        for (const string& run : runs) {
+            RemoveSpill(run);
+        }
+    }
+
+public:
+    explicit ExternalSorter(ExternalSortOptions options = ExternalSortOptions(), Compare compare = Compare())
+        : options(options), compare(compare) {
+        static_assert(is_trivially_copyable_v<T>, "ExternalSorter needs a trivially copyable T");
+    }
+
+    ~ExternalSorter() {
+        for (const string& path : spills) {
+            error_code ignored;
+            filesystem::remove(path, ignored);
+        }
+    }
+
+    ExternalSorter(const ExternalSorter&) = delete;
+    ExternalSorter& operator=(const ExternalSorter&) = delete;
+
+    // Counters from the most recent sort.
+    const ExternalSortStats& Stats() const {
+        return stats;
+    }
+
+    // Sorts the sequence file at `inputPath` into a new file at `outputPath`;
+    // the two must be different files.
+    void SortFile(const string& inputPath, const string& outputPath) {
+        CheckDistinctFiles(inputPath, outputPath);
+        ifstream in(inputPath, ios::binary);
+        if (!in) {
+            throw SerializationError("cannot open " + inputPath);
+        }
+        long long remaining = (long long) ReadSequenceHeader<T>(in).count;
+        SequenceFileWriter<T> writer(outputPath);
+        Run(FileSource(in, remaining), remaining, [&](const T* items, int count) {
+            writer.Write(items, (size_t) count);
+        });
+        writer.Close();
+    }
+
+    // Sorts any sequence into a sequence file.
+    void SortToFile(Sequence<T>* sequence, const string& outputPath) {
+        SequenceFileWriter<T> writer(outputPath);
+        Run(SequenceSource(sequence), sequence->GetSize(), [&](const T* items, int count) {
+            writer.Write(items, (size_t) count);
+        });
+        writer.Close();
+    }
+
+    // Sorts any sequence into a new MutableArraySequence. Only the working
+    // buffers count against the budget; the result itself is in memory.
+    MutableArraySequence<T>* Sort(Sequence<T>* sequence) {
+        DynamicArray<T>* result = new DynamicArray<T>(sequence->GetSize());
+        int filled = 0;
+        try {
+            Run(SequenceSource(sequence), sequence->GetSize(), [&](const T* items, int count) {
+                copy(items, items + count, &(*result)[0] + filled);
+                filled += count;
+            });
+        } catch (...) {
+            delete result;
+            throw;
+        }
+        return new MutableArraySequence<T>(result);
+    }
+};
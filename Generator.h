@@ -0,0 +1,230 @@
+#pragma once
+
+#include <coroutine>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <utility>
+
+using namespace std;
+
+// A lazy sequence produced by a C++20 coroutine, for data that is consumed
+// once: a range, the records of a file, a sequence walked with AsGenerator().
+//
+//   Generator<int> Evens(int n) {
+//       for (int i = 0; i < n; i += 2) {
+//           co_yield i;
+//       }
+//   }
+//
+// Nothing runs until the consumer asks for an element, and each element is
+// handed over from the coroutine frame without being stored anywhere else.
+// Map, Where, Zip and Take wrap a generator in another one, so a pipeline
+// such as
+//
+//   sequence->AsGenerator().Map(f).Where(p).Reduce(g, 0)
+//
+// runs element by element in O(1) memory instead of building a DynamicArray
+// per step. Reduce and TryFind drain the pipeline; TryFind and Take stop at
+// the element they need and destroy the frames behind them, so the rest of
+// the source is never produced.
+//
+// A generator is move-only and single pass. Map, Where, Zip and Take
+// consume the generator they are called on (and Zip its argument); use the
+// returned one instead. An exception thrown in the coroutine reaches the
+// consumer from the Next() call that resumed it.
+template <class T>
+class Generator {
+public:
+    struct promise_type {
+        // The element being yielded; it lives in the coroutine frame until
+        // the next resume.
+        const T* current = nullptr;
+        exception_ptr error;
+
+        Generator get_return_object() {
+            return Generator(coroutine_handle<promise_type>::from_promise(*this));
+        }
+
+        suspend_always initial_suspend() noexcept {
+            return {};
+        }
+
+        suspend_always final_suspend() noexcept {
+            return {};
+        }
+
+        suspend_always yield_value(const T& value) noexcept {
+            current = addressof(value);
+            return {};
+        }
+
+        void return_void() {}
+
+        void unhandled_exception() {
+            error = current_exception();
+        }
+    };
+
+    // For range-for; Next() is the usual way to pull elements.
+    class Iterator {
+    private:
+        Generator* source;
+        T value = T();
+        bool done;
+
+    public:
+        explicit Iterator(Generator* source) : source(source), done(source == nullptr) {
+            ++*this;
+        }
+
+        const T& operator*() const {
+            return value;
+        }
+
+        Iterator& operator++() {
+            done = done || !source->Next(value);
+            return *this;
+        }
+
+        bool operator!=(const Iterator& other) const {
+            return done != other.done;
+        }
+    };
+
+private:
+    coroutine_handle<promise_type> handle;
+
+    explicit Generator(coroutine_handle<promise_type> handle) : handle(handle) {}
+
+    static Generator MapOf(Generator source, function<T(T)> func) {
+        T item;
+        while (source.Next(item)) {
+            co_yield func(item);
+        }
+    }
+
+    static Generator WhereOf(Generator source, function<bool(T)> predicate) {
+        T item;
+        while (source.Next(item)) {
+            if (predicate(item)) {
+                co_yield item;
+            }
+        }
+    }
+
+    static Generator ZipOf(Generator source, Generator other, function<T(T, T)> func) {
+        T left;
+        T right;
+        while (source.Next(left) && other.Next(right)) {
+            co_yield func(left, right);
+        }
+    }
+
+    static Generator TakeOf(Generator source, int count) {
+        T item;
+        for (int i = 0; i < count && source.Next(item); i++) {
+            co_yield item;
+        }
+    }
+
+public:
+    Generator(Generator&& other) noexcept : handle(exchange(other.handle, nullptr)) {}
+
+    Generator& operator=(Generator&& other) noexcept {
+        if (this != &other) {
+            if (handle) {
+                handle.destroy();
+            }
+            handle = exchange(other.handle, nullptr);
+        }
+        return *this;
+    }
+
+    Generator(const Generator&) = delete;
+    Generator& operator=(const Generator&) = delete;
+
+    // Destroys the frame wherever it is suspended, running the destructors
+    // of its locals.
+    ~Generator() {
+        if (handle) {
+            handle.destroy();
+        }
+    }
+
+    // Resumes the coroutine up to its next co_yield and copies the element
+    // into `value`; false once it has finished.
+    bool Next(T& value) {
+        if (!handle || handle.done()) {
+            return false;
+        }
+        handle.resume();
+        if (handle.promise().error) {
+            rethrow_exception(exchange(handle.promise().error, nullptr));
+        }
+        if (handle.done()) {
+            return false;
+        }
+        value = *handle.promise().current;
+        return true;
+    }
+
+    Iterator begin() {
+        return Iterator(this);
+    }
+
+    Iterator end() {
+        return Iterator(nullptr);
+    }
+
+    Generator Map(function<T(T)> func) {
+        return MapOf(std::move(*this), std::move(func));
+    }
+
+    Generator Where(function<bool(T)> predicate) {
+        return WhereOf(std::move(*this), std::move(predicate));
+    }
+
+    // Stops at the end of the shorter generator.
+    Generator Zip(Generator other, function<T(T, T)> func) {
+        return ZipOf(std::move(*this), std::move(other), std::move(func));
+    }
+
+    // The first `count` elements; the source is not resumed past them.
+    Generator Take(int count) {
+        return TakeOf(std::move(*this), count);
+    }
+
+    T Reduce(function<T(T, T)> func, T startValue) {
+        T result = startValue;
+        T item;
+        while (Next(item)) {
+            result = func(result, item);
+        }
+        return result;
+    }
+
+    // Stops at the first match; the generator can go on from the element
+    // after it.
+    bool TryFind(function<bool(T)> predicate, T& value) {
+        T item;
+        while (Next(item)) {
+            if (predicate(item)) {
+                value = item;
+                return true;
+            }
+        }
+        return false;
+    }
+};
+
+// The integers [start, end) by `step`, which must be positive.
+inline Generator<int> Range(int start, int end, int step = 1) {
+    for (int i = start; i < end; i += step) {
+        co_yield i;
+        // Stop before i + step could overflow.
+        if (i > end - step) {
+            break;
+        }
+    }
+}
@@ -0,0 +1,249 @@
+#pragma once
+
+#include <bit>
+#include <cstdint>
+#include <functional>
+
+#include "Sequence.h"
+#include "DynamicArray.h"
+
+template <class T, class Key>
+class HashIndex;
+
+// A TryFind predicate that compares an element's key with `key`. Built by
+// HashIndex::Matching; sequences that own that index recognise it and
+// answer from the hash table instead of scanning.
+template <class T, class Key>
+struct KeyMatch {
+    const HashIndex<T, Key>* index;
+    Key key;
+
+    bool operator()(T item) const {
+        return index->KeyOf(item) == key;
+    }
+};
+
+// Open-addressing hash table from keys to positions in a sequence. Slots
+// hold an element index and the key's hash, never a copy of the element:
+// probes compare hashes first and only read the sequence on a hash match.
+// Linear probing, power-of-two capacity, load factor at most 0.7, and
+// backward-shift deletion, so there are no tombstones.
+//
+// The index does not watch the sequence: whoever changes it reports the
+// change through OnAppend, OnInsert or OnSet (IndexedSequence does this),
+// or calls Rebuild.
+template <class T, class Key = T>
+class HashIndex {
+public:
+    using KeyFunction = function<Key(const T&)>;
+
+private:
+    struct Slot {
+        int index = -1;
+        uint32_t hash = 0;
+    };
+
+    Sequence<T>* sequence;
+    KeyFunction keyOf;
+    DynamicArray<Slot>* slots = nullptr;
+    int capacity = 0;
+    int shift = 32;
+    int count = 0;
+
+    static Key Identity(const T& item) {
+        return item;
+    }
+
+    // Fibonacci hashing spreads std::hash, which is the identity for
+    // integers, over the high bits that pick the home slot.
+    static uint32_t Mix(const Key& key) {
+        uint64_t hash = (uint64_t) std::hash<Key>()(key) * 0x9E3779B97F4A7C15ull;
+        return (uint32_t) (hash >> 32);
+    }
+
+    int Home(uint32_t hash) const {
+        return (int) (hash >> shift);
+    }
+
+    int Next(int slot) const {
+        return (slot + 1) & (capacity - 1);
+    }
+
+    bool Matches(const Slot& slot, uint32_t hash, const Key& key) const {
+        return slot.hash == hash && keyOf(sequence->Get(slot.index)) == key;
+    }
+
+    void Place(int index, uint32_t hash) {
+        Slot* table = &(*slots)[0];
+        int slot = Home(hash);
+        while (table[slot].index != -1) {
+            slot = Next(slot);
+        }
+        table[slot].index = index;
+        table[slot].hash = hash;
+        count++;
+    }
+
+    void Allocate(int newCapacity) {
+        delete slots;
+        capacity = newCapacity;
+        shift = 32 - countr_zero((unsigned) newCapacity);
+        slots = new DynamicArray<Slot>(newCapacity);
+        for (int i = 0; i < newCapacity; i++) {
+            (*slots)[i] = Slot();
+        }
+        count = 0;
+    }
+
+    void Grow() {
+        DynamicArray<Slot>* old = slots;
+        int oldCapacity = capacity;
+        slots = nullptr;
+        Allocate(capacity * 2);
+        for (int i = 0; i < oldCapacity; i++) {
+            if ((*old)[i].index != -1) {
+                Place((*old)[i].index, (*old)[i].hash);
+            }
+        }
+        delete old;
+    }
+
+    void Add(int index, const Key& key) {
+        if ((long long) (count + 1) * 10 > (long long) capacity * 7) {
+            Grow();
+        }
+        Place(index, Mix(key));
+    }
+
+    // Removes the slot for element `index` under `key` and shifts the rest
+    // of its probe run back.
+    void Remove(int index, const Key& key) {
+        Slot* table = &(*slots)[0];
+        int slot = Home(Mix(key));
+        while (table[slot].index != index) {
+            if (table[slot].index == -1) {
+                return;
+            }
+            slot = Next(slot);
+        }
+        int hole = slot;
+        for (int next = Next(hole); table[next].index != -1; next = Next(next)) {
+            int home = Home(table[next].hash);
+            // Move the entry into the hole unless its home lies cyclically
+            // in (hole, next], where it would no longer be reachable.
+            bool reachable = hole <= next ? (home > hole && home <= next) : (home > hole || home <= next);
+            if (!reachable) {
+                table[hole] = table[next];
+                hole = next;
+            }
+        }
+        table[hole] = Slot();
+        count--;
+    }
+
+public:
+    explicit HashIndex(Sequence<T>* sequence) : HashIndex(sequence, &HashIndex::Identity) {}
+
+    HashIndex(Sequence<T>* sequence, KeyFunction keyOf) : sequence(sequence), keyOf(keyOf) {
+        Rebuild();
+    }
+
+    ~HashIndex() {
+        delete slots;
+    }
+
+    HashIndex(const HashIndex&) = delete;
+    HashIndex& operator=(const HashIndex&) = delete;
+
+    Key KeyOf(const T& item) const {
+        return keyOf(item);
+    }
+
+    // Re-reads the whole sequence.
+    void Rebuild() {
+        int size = sequence->GetSize();
+        int newCapacity = 16;
+        while ((long long) size * 10 > (long long) newCapacity * 7) {
+            newCapacity *= 2;
+        }
+        Allocate(newCapacity);
+        for (int i = 0; i < size; i++) {
+            Place(i, Mix(keyOf(sequence->Get(i))));
+        }
+    }
+
+    // Lowest index of an element with this key, -1 if there is none: the
+    // same element a front-to-back TryFind would return.
+    int Find(const Key& key) const {
+        uint32_t hash = Mix(key);
+        const Slot* table = &(*slots)[0];
+        int found = -1;
+        for (int slot = Home(hash); table[slot].index != -1; slot = Next(slot)) {
+            if ((found == -1 || table[slot].index < found) && Matches(table[slot], hash, key)) {
+                found = table[slot].index;
+            }
+        }
+        return found;
+    }
+
+    bool Contains(const Key& key) const {
+        uint32_t hash = Mix(key);
+        const Slot* table = &(*slots)[0];
+        for (int slot = Home(hash); table[slot].index != -1; slot = Next(slot)) {
+            if (Matches(table[slot], hash, key)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    int Count(const Key& key) const {
+        uint32_t hash = Mix(key);
+        const Slot* table = &(*slots)[0];
+        int matches = 0;
+        for (int slot = Home(hash); table[slot].index != -1; slot = Next(slot)) {
+            if (Matches(table[slot], hash, key)) {
+                matches++;
+            }
+        }
+        return matches;
+    }
+
+    // A predicate for TryFind that sequences owning this index route here.
+    KeyMatch<T, Key> Matching(const Key& key) const {
+        return KeyMatch<T, Key>{this, key};
+    }
+
+    // The last element of the sequence was appended.
+    void OnAppend() {
+        int index = sequence->GetSize() - 1;
+        Add(index, keyOf(sequence->Get(index)));
+    }
+
+    // An element was inserted at `index`; later elements moved up by one,
+    // so every stored index past it is renumbered: O(capacity), like the
+    // shift in the array itself.
+    void OnInsert(int index) {
+        for (int i = 0; i < capacity; i++) {
+            if ((*slots)[i].index >= index) {
+                (*slots)[i].index++;
+            }
+        }
+        Add(index, keyOf(sequence->Get(index)));
+    }
+
+    // Element `index` changed from `oldValue` to its current value.
+    void OnSet(int index, const T& oldValue) {
+        Key oldKey = keyOf(oldValue);
+        Key newKey = keyOf(sequence->Get(index));
+        if (oldKey == newKey) {
+            return;
+        }
+        Remove(index, oldKey);
+        Add(index, newKey);
+    }
+
+    size_t TableBytes() const {
+        return sizeof(Slot) * (size_t) capacity;
+    }
+};
@@ -0,0 +1,17 @@
+#pragma once
+
+#include "IndexOutOfRange.h"
+#include "CollectionFootprint.h"
+
+template <class T>
+class ICollection {
+public:
+    virtual ~ICollection() = default;
+    virtual T Get (int index) = 0;
+    virtual int GetSize() = 0;
+    virtual void Append(T item) = 0;
+    virtual void Prepend(T item) = 0;
+    virtual void Insert(T item, int index) = 0;
+    virtual CollectionFootprint MemoryFootprint() = 0;
+
+};
@@ -0,0 +1,203 @@
+#pragma once
+
+#include "Sequence.h"
+#include "DynamicArray.h"
+#include "MutableArraySequence.h"
+
+template <class T>
+class ImmutableArraySequence : public Sequence<T> {
+protected:
+    DynamicArray<T>* array;
+    ImmutableArraySequence<T>* CreateImmutableArraySequence(){
+        return new ImmutableArraySequence<T>();
+    }
+public:
+    ImmutableArraySequence(T* items, int count) {
+        array = new DynamicArray<T>(items, count);
+    }
+
+    ImmutableArraySequence() {
+        array = new DynamicArray<T>(0);
+    }
+
+    ImmutableArraySequence(MutableArraySequence<T>* other) {
+        array = new DynamicArray<T>(other->GetSize());
+        for (int i = 0; i < other->GetSize(); i++) {
+            (*array)[i] = other->Get(i);
+        }
+    }
+
+    ImmutableArraySequence(ImmutableArraySequence<T>* other) {
+        array = new DynamicArray<T>(*other->array);
+    }
+
+    // Takes ownership of `storage`, e.g. a view mapped from a file.
+    explicit ImmutableArraySequence(DynamicArray<T>* storage) {
+        array = storage;
+    }
+
+    ~ImmutableArraySequence(){
+        delete array;
+    }
+
+    Sequence<T>* GetSubSequence(int startIndex, int endIndex) override {
+        Sequence<T>* subSequence = new ImmutableArraySequence<T>();
+        for (int i = startIndex; i < endIndex; i++) {
+            subSequence->Append(Get(i));
+        }
+        return subSequence;
+    }
+
+    T GetFirst() override{
+        if (array->GetSize() == 0) {
+            throw IndexOutOfRange();
+        }
+        return array->Get(0);
+    }
+
+    T GetLast() override{
+        if (array->GetSize() == 0) {
+            throw IndexOutOfRange();
+        }
+        return array->Get(array->GetSize() - 1);
+    }
+
+    T Get(int index) override{
+        return array->Get(index);
+    }
+
+    int GetSize() override{
+        return array->GetSize();
+    }
+
+    CollectionFootprint MemoryFootprint() override {
+        return array->MemoryFootprint().Wrapped(sizeof(*this));
+    }
+
+    T& operator[](int index) override {
+        return (*array)[index];
+    }
+
+    const T& operator[](int index) const override {
+        return (*array)[index];
+    }
+
+    bool TryGet(int index, T& value) override{
+        if (index < 0 || index >= array->GetSize()) {
+            throw IndexOutOfRange();
+        }
+        value = array->Get(index);
+        return true;
+    }
+
+    bool TryFind(function<bool(T)> predicate, T& value) override{
+        for (int i = 0; i < array->GetSize(); i++) {
+            if (predicate((*array)[i])) {
+                value = array->Get(i);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    Sequence<T>* Map(function<T(T)> func) override{
+        ImmutableArraySequence<T>* newSequence = CreateImmutableArraySequence();
+        for (int i = 0; i < array->GetSize(); ++i) {
+            newSequence->Append(func(array->Get(i)));
+        }
+        return newSequence;
+    }
+
+    T Reduce(function<T(T, T)> func, T startValue) override{
+        T result = startValue;
+        for (int i = 0; i < array->GetSize(); ++i) {
+            result = func(result, array->Get(i));
+        }
+        return result;
+    }
+
+    Sequence<T>* Where(function<bool(T)> predicate) override{
+        ImmutableArraySequence<T>* newSequence = CreateImmutableArraySequence();
+        for (int i = 0; i < array->GetSize(); ++i) {
+            T item = array->Get(i);
+            if (predicate(item)) {
+                newSequence->Append(item);
+            }
+        }
+        return newSequence;
+    }
+
+    Sequence<T>* Zip (Sequence<T>* other, function<T(T, T)> func) override {
+        ImmutableArraySequence<T>* newSequence = CreateImmutableArraySequence();
+        int minLength = min(array->GetSize(), other->GetSize());
+        for (int i = 0; i < minLength; ++i) {
+            newSequence->Append(func(array->Get(i), other->Get(i)));
+        }
+        return newSequence;
+    }
+
+    Sequence<T>* Slice(int index, int count, Sequence<T>* replacement) override {
+        ImmutableArraySequence<T>* newSequence = CreateImmutableArraySequence();
+        if (index < 0) {
+            index = array->GetSize() + index;
+            if (index < 0) {
+                throw IndexOutOfRange();
+            }
+        }
+        if (index >= array->GetSize() || index + count > array->GetSize()) {
+            throw IndexOutOfRange();
+        }
+        for (int i = 0; i < index; ++i) {
+            newSequence->Append(array->Get(i));
+        }
+        if (replacement != nullptr) {
+            for (int i = 0; i < replacement->GetSize(); ++i) {
+                newSequence->Append(replacement->Get(i));
+            }
+        }
+        for (int i = index + count; i < array->GetSize(); ++i) {
+            newSequence->Append(array->Get(i));
+        }
+        return newSequence;
+    }
+
+    Sequence<T>* Split(function<bool(T)> predicate) override {
+        ImmutableArraySequence<T>* newSequence = CreateImmutableArraySequence();
+        ImmutableArraySequence<T>* currentChunk = CreateImmutableArraySequence();
+        for (int i = 0; i < array->GetSize(); ++i) {
+            T item = array->Get(i);
+            if (predicate(item)) {
+                if (currentChunk->GetSize() > 0) {
+                    newSequence->Concat(currentChunk);
+                    currentChunk = CreateImmutableArraySequence();
+                }
+            } else {
+                    currentChunk->Append(item);
+                }
+            }
+            if (currentChunk->GetSize() > 0) {
+                newSequence->Concat(currentChunk);
+            }
+            return newSequence;
+    }
+
+    void Append(T item) override{
+        this->array->Append(item);
+    }
+
+    void Prepend(T item) override{
+        this->array->Prepend(item);
+    }
+
+    void Insert(T item, int index) override{
+        this->array->Insert(item, index);
+    }
+
+    Sequence<T>* Concat(Sequence<T>* list) override{
+        ImmutableArraySequence<T>* newSequence = new ImmutableArraySequence<T>(this);
+        for (int i = 0; i < list->GetSize(); ++i) {
+            newSequence->Append(list->Get(i));
+        }
+        return newSequence;
+    }
+};
@@ -0,0 +1,199 @@
+#pragma once
+
+#include "Sequence.h"
+#include "LinkedList.h"
+#include "MutableListSequence.h"
+#include "ImmutableArraySequence.h"
+
+template <class T>
+class ImmutableListSequence : public Sequence<T> {
+protected:
+    LinkedList<T>* list;
+    ImmutableListSequence<T>* CreateImmutableListSequence(){
+        return new ImmutableListSequence<T>();
+    }
+public:
+    ImmutableListSequence(T* items, int count) {
+        list = new LinkedList<T>(items, count);
+    }
+
+    ImmutableListSequence() {
+        list = new LinkedList<T>();
+    }
+
+    ImmutableListSequence(MutableListSequence<T>* other) {
+        list = new LinkedList<T>();
+        for (int i = 0; i < other->GetSize(); i++) {
+            list->Append(other->Get(i));
+        }
+    }
+
+    ImmutableListSequence(ImmutableListSequence<T>* other) {
+        list = new LinkedList<T>(*other->list);
+    }
+
+    ~ImmutableListSequence() {
+        delete this->list;
+    }
+
+    Sequence<T>* GetSubSequence(int startIndex, int endIndex) override {
+        Sequence<T>* subSequence = new ImmutableArraySequence<T>();
+        for (int i = startIndex; i < endIndex; i++) {
+            subSequence->Append(Get(i));
+        }
+        return subSequence;
+    }
+
+    T GetFirst() override{
+        if (list->GetSize() == 0) {
+            throw IndexOutOfRange();
+        }
+        return list->Get(0);
+    }
+
+    T GetLast() override{
+        if (list->GetSize() == 0) {
+            throw IndexOutOfRange();
+        }
+        return list->GetLast();
+    }
+
+    T Get(int index) override{
+        return list->Get(index);
+    }
+
+    int GetSize() override{
+        return list->GetSize();
+    }
+
+    CollectionFootprint MemoryFootprint() override {
+        return list->MemoryFootprint().Wrapped(sizeof(*this));
+    }
+
+    T& operator[](int index) override {
+        return (*list)[index];
+    }
+
+    const T& operator[](int index) const override {
+        return (*list)[index];
+    }
+
+    bool TryGet(int index, T& value) override{
+        if (index < 0 || index >= list->GetSize()) {
+            throw IndexOutOfRange();
+        }
+        value = list->Get(index);
+        return true;
+    }
+
+    bool TryFind(function<bool(T)> predicate, T& value) override{
+        for (int i = 0; i < list->GetSize(); i++) {
+            if (predicate((*list)[i])) {
+                value = list->Get(i);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    Sequence<T>* Map(function<T(T)> func) override{
+        ImmutableListSequence<T>* newSequence = CreateImmutableListSequence();
+        for (int i = 0; i < list->GetSize(); ++i) {
+            newSequence->Append(func(list->Get(i)));
+        }
+        return newSequence;
+    }
+
+    T Reduce(function<T(T, T)> func, T startValue) override{
+        T result = startValue;
+        for (int i = 0; i < list->GetSize(); ++i) {
+            result = func(result, list->Get(i));
+        }
+        return result;
+    }
+
+    Sequence<T>* Where(function<bool(T)> predicate) override{
+        ImmutableListSequence<T>* newSequence = CreateImmutableListSequence();
+        for (int i = 0; i < list->GetSize(); ++i) {
+            T item = list->Get(i);
+            if (predicate(item)) {
+                newSequence->Append(item);
+            }
+        }
+        return newSequence;
+    }
+
+    Sequence<T>* Zip (Sequence<T>* other, function<T(T, T)> func) override {
+        ImmutableListSequence<T>* newSequence = CreateImmutableListSequence();
+        int minLength = min(list->GetSize(), other->GetSize());
+        for (int i = 0; i < minLength; ++i) {
+            newSequence->Append(func(list->Get(i), other->Get(i)));
+        }
+        return newSequence;
+    }
+
+    Sequence<T>* Slice(int index, int count, Sequence<T>* replacement) override {
+        ImmutableListSequence<T>* newSequence = CreateImmutableListSequence();
+        if (index < 0) {
+            index = list->GetSize() + index;
+            if (index < 0) {
+                throw IndexOutOfRange();
+            }
+        }
+        if (index >= list->GetSize() || index + count > list->GetSize()) {
+            throw IndexOutOfRange();
+        }
+        for (int i = 0; i < index; ++i) {
+            newSequence->Append(list->Get(i));
+        }
+        if (replacement != nullptr) {
+            for (int i = 0; i < replacement->GetSize(); ++i) {
+                newSequence->Append(replacement->Get(i));
+            }
+        }
+        for (int i = index + count; i < list->GetSize(); ++i) {
+            newSequence->Append(list->Get(i));
+        }
+        return newSequence;
+    }
+
+    Sequence<T>* Split(function<bool(T)> predicate) override {
+        ImmutableListSequence<T>* newSequence = CreateImmutableListSequence();
+        ImmutableListSequence<T>* currentChunk = CreateImmutableListSequence();
+        for (int i = 0; i < list->GetSize(); ++i) {
+            T item = list->Get(i);
+            if (predicate(item)) {
+                if (currentChunk->GetSize() > 0) {
+                    newSequence->Concat(currentChunk);
+                    currentChunk = CreateImmutableListSequence();
+                }
+            } else {
+                    currentChunk->Append(item);
+                }
+            }
+            if (currentChunk->GetSize() > 0) {
+                newSequence->Concat(currentChunk);
+            }
+            return newSequence;
+    }
+
+    void Append(T item) override{
+        this->list->Append(item);
+    }
+
+    void Prepend(T item) override{
+        this->list->Prepend(item);
+    }
+
+    void Insert(T item, int index) override{
+        this->list->Insert(item, index);
+    }
+
+    Sequence<T>* Concat(Sequence<T>* list) override{
+        ImmutableListSequence<T>* newSequence = new ImmutableListSequence<T>(this);
+        for (int i = 0; i < list->GetSize(); ++i) {
+            newSequence->Append(list->Get(i));
+        }
+        return newSequence;
+    }
+};
@@ -0,0 +1,12 @@
+#pragma once
+
+#include <exception>
+
+using namespace std;
+
+class IndexOutOfRange : public exception {
+public:
+    const char* what() const noexcept override {
+        return "Index out of range";
+    }
+};
@@ -0,0 +1,197 @@
+#pragma once
+
+#include <functional>
+
+#include "Sequence.h"
+#include "MutableArraySequence.h"
+#include "HashIndex.h"
+
+// A MutableArraySequence with a HashIndex kept up to date on every change,
+// so key lookups are O(1) on average instead of a linear TryFind.
+//
+//   IndexedSequence<Order, int> orders(items, count, [](const Order& o) { return o.id; });
+//   orders.TryFind(orders.KeyEquals(42), order);   // hash lookup
+//
+// TryFind recognises predicates made by KeyEquals and answers them from the
+// index; any other predicate falls back to the scan. Writes through the
+// non-const operator[] cannot be observed, so they mark the index stale and
+// the next lookup rebuilds it; prefer Set.
+template <class T, class Key = T>
+class IndexedSequence : public Sequence<T> {
+public:
+    using KeyFunction = typename HashIndex<T, Key>::KeyFunction;
+
+private:
+    MutableArraySequence<T>* items;
+    HashIndex<T, Key>* index;
+    KeyFunction keyOf;
+    bool stale = false;
+
+    static Key Identity(const T& item) {
+        return item;
+    }
+
+    HashIndex<T, Key>* Index() {
+        if (stale) {
+            index->Rebuild();
+            stale = false;
+        }
+        return index;
+    }
+
+public:
+    explicit IndexedSequence(KeyFunction keyOf = &IndexedSequence::Identity) : keyOf(keyOf) {
+        items = new MutableArraySequence<T>();
+        index = new HashIndex<T, Key>(items, keyOf);
+    }
+
+    IndexedSequence(T* source, int count, KeyFunction keyOf = &IndexedSequence::Identity) : keyOf(keyOf) {
+        items = new MutableArraySequence<T>(source, count);
+        index = new HashIndex<T, Key>(items, keyOf);
+    }
+
+    IndexedSequence(IndexedSequence<T, Key>* other) : keyOf(other->keyOf) {
+        items = new MutableArraySequence<T>(other->items);
+        index = new HashIndex<T, Key>(items, keyOf);
+    }
+
+    ~IndexedSequence() {
+        delete index;
+        delete items;
+    }
+
+    // Lowest index of an element with this key, -1 if none.
+    int Find(const Key& key) {
+        return Index()->Find(key);
+    }
+
+    bool Contains(const Key& key) {
+        return Index()->Contains(key);
+    }
+
+    int Count(const Key& key) {
+        return Index()->Count(key);
+    }
+
+    // A TryFind predicate that this sequence answers from its index.
+    KeyMatch<T, Key> KeyEquals(const Key& key) {
+        return Index()->Matching(key);
+    }
+
+    void Set(int position, T value) {
+        T old = items->Get(position);
+        (*items)[position] = value;
+        if (!stale) {
+            index->OnSet(position, old);
+        }
+    }
+
+    Sequence<T>* GetSubSequence(int startIndex, int endIndex) override {
+        IndexedSequence<T, Key>* subSequence = new IndexedSequence<T, Key>(keyOf);
+        for (int i = startIndex; i < endIndex; i++) {
+            subSequence->Append(Get(i));
+        }
+        return subSequence;
+    }
+
+    T GetFirst() override {
+        return items->GetFirst();
+    }
+
+    T GetLast() override {
+        return items->GetLast();
+    }
+
+    T Get(int position) override {
+        return items->Get(position);
+    }
+
+    int GetSize() override {
+        return items->GetSize();
+    }
+
+    CollectionFootprint MemoryFootprint() override {
+        CollectionFootprint footprint = items->MemoryFootprint().Wrapped(sizeof(*this));
+        footprint.overheadBytes += sizeof(HashIndex<T, Key>) + index->TableBytes();
+        footprint.allocationCount += 2;
+        return footprint;
+    }
+
+    T& operator[](int position) override {
+        stale = true;
+        return (*items)[position];
+    }
+
+    const T& operator[](int position) const override {
+        const MutableArraySequence<T>& constItems = *items;
+        return constItems[position];
+    }
+
+    bool TryGet(int position, T& value) override {
+        return items->TryGet(position, value);
+    }
+
+    bool TryFind(function<bool(T)> predicate, T& value) override {
+        const KeyMatch<T, Key>* match = predicate.template target<KeyMatch<T, Key>>();
+        if (match != nullptr && match->index == index) {
+            int found = Index()->Find(match->key);
+            if (found == -1) {
+                return false;
+            }
+            value = items->Get(found);
+            return true;
+        }
+        return items->TryFind(predicate, value);
+    }
+
+    Sequence<T>* Map(function<T(T)> func) override {
+        return items->Map(func);
+    }
+
+    T Reduce(function<T(T, T)> func, T startValue) override {
+        return items->Reduce(func, startValue);
+    }
+
+    Sequence<T>* Where(function<bool(T)> predicate) override {
+        return items->Where(predicate);
+    }
+
+    Sequence<T>* Zip(Sequence<T>* other, function<T(T, T)> func) override {
+        return items->Zip(other, func);
+    }
+
+    Sequence<T>* Slice(int position, int count, Sequence<T>* replacement) override {
+        return items->Slice(position, count, replacement);
+    }
+
+    Sequence<T>* Split(function<bool(T)> predicate) override {
+        return items->Split(predicate);
+    }
+
+    void Append(T item) override {
+        items->Append(item);
+        if (!stale) {
+            index->OnAppend();
+        }
+    }
+
+    void Prepend(T item) override {
+        Insert(item, 0);
+    }
+
+    void Insert(T item, int position) override {
+        items->Insert(item, position);
+        if (!stale) {
+            index->OnInsert(position);
+        }
+    }
+
+    // Keeps the key function; the result is indexed too.
+    Sequence<T>* Concat(Sequence<T>* list) override {
+        IndexedSequence<T, Key>* newSequence = new IndexedSequence<T, Key>(this);
+        for (int i = 0; i < list->GetSize(); ++i) {
+            newSequence->Append(list->Get(i));
+        }
+        return newSequence;
+    }
+};
@@ -0,0 +1,232 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdlib>
+#include <stdexcept>
+
+#include "CollectionFootprint.h"
+#include "IndexOutOfRange.h"
+
+using namespace std;
+
+// The links an element carries to sit in an IntrusiveList. An element can
+// be in one list per hook it has.
+struct IntrusiveHook {
+    IntrusiveHook* next = nullptr;
+    IntrusiveHook* prev = nullptr;
+
+    bool IsLinked() const {
+        return next != nullptr;
+    }
+};
+
+// A doubly linked list threaded through hooks embedded in the elements:
+//
+//   struct Order { ...; IntrusiveHook hook; };
+//   IntrusiveList<Order, &Order::hook> orders;
+//   orders.Append(order);   // links `order` itself, no copy, no allocation
+//   orders.Remove(order);   // O(1), no search
+//
+// The list never owns its elements: they live wherever the caller put them
+// (an arena, a vector, the stack) and must stay put while linked. Clearing
+// or destroying the list only unlinks them.
+//
+// The hooks form a ring through a sentinel, so Remove needs no search and
+// no null checks. Positional access walks from the head, the tail or the
+// node found by the previous lookup, as LinkedList does.
+template <class T, IntrusiveHook T::*Hook>
+class IntrusiveList {
+private:
+    IntrusiveHook sentinel;
+    int size = 0;
+    mutable IntrusiveHook* finger = nullptr;
+    mutable int fingerIndex = -1;
+
+    static IntrusiveHook& HookOf(T& item) {
+        return item.*Hook;
+    }
+
+    // The element a hook is embedded in, from the hook's offset in T.
+    static T& ElementOf(IntrusiveHook* hook) {
+        static const ptrdiff_t offset = [] {
+            alignas(T) char storage[sizeof(T)];
+            T* probe = reinterpret_cast<T*>(storage);
+            return reinterpret_cast<char*>(&(probe->*Hook)) - storage;
+        }();
+        return *reinterpret_cast<T*>(reinterpret_cast<char*>(hook) - offset);
+    }
+
+    void LinkBefore(IntrusiveHook* position, T& item) {
+        IntrusiveHook& hook = HookOf(item);
+        if (hook.IsLinked()) {
+            throw std::runtime_error("Element is already in an intrusive list");
+        }
+        hook.next = position;
+        hook.prev = position->prev;
+        position->prev->next = &hook;
+        position->prev = &hook;
+        size++;
+    }
+
+    IntrusiveHook* GetHook(int index) const {
+        if (index < 0 || index >= size) {
+            throw IndexOutOfRange();
+        }
+        int position = 0;
+        IntrusiveHook* current = sentinel.next;
+        int distance = index;
+        if (size - 1 - index < distance) {
+            position = size - 1;
+            current = sentinel.prev;
+            distance = size - 1 - index;
+        }
+        if (fingerIndex != -1 && abs(index - fingerIndex) < distance) {
+            position = fingerIndex;
+            current = finger;
+        }
+        for (; position < index; position++) {
+            current = current->next;
+        }
+        for (; position > index; position--) {
+            current = current->prev;
+        }
+        finger = current;
+        fingerIndex = index;
+        return current;
+    }
+
+public:
+    IntrusiveList() {
+        sentinel.next = &sentinel;
+        sentinel.prev = &sentinel;
+    }
+
+    IntrusiveList(const IntrusiveList&) = delete;
+    IntrusiveList& operator=(const IntrusiveList&) = delete;
+
+    ~IntrusiveList() {
+        Clear();
+    }
+
+    int GetSize() const {
+        return size;
+    }
+
+    bool IsEmpty() const {
+        return size == 0;
+    }
+
+    T& GetFirst() {
+        if (size == 0) {
+            throw IndexOutOfRange();
+        }
+        return ElementOf(sentinel.next);
+    }
+
+    T& GetLast() {
+        if (size == 0) {
+            throw IndexOutOfRange();
+        }
+        return ElementOf(sentinel.prev);
+    }
+
+    T& Get(int index) {
+        return ElementOf(GetHook(index));
+    }
+
+    // The element after / before `item` in its list, or nullptr at the end.
+    T* Next(T& item) {
+        IntrusiveHook* next = HookOf(item).next;
+        return next == &sentinel ? nullptr : &ElementOf(next);
+    }
+
+    T* Previous(T& item) {
+        IntrusiveHook* prev = HookOf(item).prev;
+        return prev == &sentinel ? nullptr : &ElementOf(prev);
+    }
+
+    // Links `item` itself; it must not be in a list through this hook yet.
+    void Append(T& item) {
+        LinkBefore(&sentinel, item);
+    }
+
+    void Prepend(T& item) {
+        LinkBefore(sentinel.next, item);
+        if (fingerIndex != -1) {
+            fingerIndex++;
+        }
+    }
+
+    void Insert(T& item, int index) {
+        if (index < 0 || index > size) {
+            throw IndexOutOfRange();
+        }
+        if (index == size) {
+            Append(item);
+            return;
+        }
+        LinkBefore(GetHook(index), item);
+        // The finger is on the element now after `item`.
+        fingerIndex++;
+    }
+
+    // Links `item` right after `position`, which must be in this list.
+    void InsertAfter(T& position, T& item) {
+        LinkBefore(HookOf(position).next, item);
+        finger = nullptr;
+        fingerIndex = -1;
+    }
+
+    // Unlinks `item`, which must be in this list. O(1).
+    void Remove(T& item) {
+        IntrusiveHook& hook = HookOf(item);
+        if (!hook.IsLinked()) {
+            throw std::runtime_error("Element is not in an intrusive list");
+        }
+        hook.prev->next = hook.next;
+        hook.next->prev = hook.prev;
+        hook.next = nullptr;
+        hook.prev = nullptr;
+        size--;
+        finger = nullptr;
+        fingerIndex = -1;
+    }
+
+    void RemoveAt(int index) {
+        Remove(Get(index));
+    }
+
+    // Unlinks every element, leaving them as they are.
+    void Clear() {
+        IntrusiveHook* current = sentinel.next;
+        while (current != &sentinel) {
+            IntrusiveHook* next = current->next;
+            current->next = nullptr;
+            current->prev = nullptr;
+            current = next;
+        }
+        sentinel.next = &sentinel;
+        sentinel.prev = &sentinel;
+        size = 0;
+        finger = nullptr;
+        fingerIndex = -1;
+    }
+
+    // Calls func(T&) for each element in order.
+    template <class Func>
+    void ForEach(Func func) {
+        for (IntrusiveHook* current = sentinel.next; current != &sentinel; current = current->next) {
+            func(ElementOf(current));
+        }
+    }
+
+    // The elements are the caller's, so the payload is zero; the hooks they
+    // carry are this list's overhead.
+    CollectionFootprint MemoryFootprint() {
+        CollectionFootprint footprint;
+        footprint.payloadBytes = 0;
+        footprint.overheadBytes = sizeof(*this) + sizeof(IntrusiveHook) * (size_t) size;
+        footprint.allocationCount = 0;
+        return footprint;
+    }
+};
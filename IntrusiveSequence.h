@@ -0,0 +1,208 @@
+#pragma once
+
+#include <stdexcept>
+#include <vector>
+
+#include "Sequence.h"
+#include "IntrusiveList.h"
+#include "MutableArraySequence.h"
+
+// A Sequence of pointers over an IntrusiveList, for code written against
+// Sequence: Append(&item) links the caller's object, Get returns it.
+//
+// An element is in one list per hook, so results that would hold elements
+// a second time (Map, Where, Concat, ...) are MutableArraySequences of the
+// same pointers: the objects are shared, never copied.
+//
+// The list links the objects themselves and keeps no array of pointers to
+// them, so a T*& would have nothing to refer to and the non-const
+// operator[] throws. The const one hands out a pointer cached in the
+// sequence, valid until the next call.
+template <class T, IntrusiveHook T::*Hook>
+class IntrusiveSequence : public Sequence<T*> {
+private:
+    IntrusiveList<T, Hook>* list;
+    mutable T* lookup = nullptr;
+
+    static Sequence<T*>* FromVector(vector<T*>& items) {
+        return new MutableArraySequence<T*>(items.data(), (int) items.size());
+    }
+
+public:
+    IntrusiveSequence() {
+        list = new IntrusiveList<T, Hook>();
+    }
+
+    IntrusiveSequence(T** items, int count) : IntrusiveSequence() {
+        for (int i = 0; i < count; i++) {
+            Append(items[i]);
+        }
+    }
+
+    IntrusiveSequence(const IntrusiveSequence&) = delete;
+    IntrusiveSequence& operator=(const IntrusiveSequence&) = delete;
+
+    // Unlinks the elements; they stay where they are.
+    ~IntrusiveSequence() {
+        delete list;
+    }
+
+    IntrusiveList<T, Hook>* List() {
+        return list;
+    }
+
+    Sequence<T*>* GetSubSequence(int startIndex, int endIndex) override {
+        if (startIndex < 0 || endIndex > list->GetSize() || startIndex > endIndex) {
+            throw IndexOutOfRange();
+        }
+        vector<T*> items;
+        for (int i = startIndex; i < endIndex; i++) {
+            items.push_back(&list->Get(i));
+        }
+        return FromVector(items);
+    }
+
+    T* GetFirst() override {
+        return &list->GetFirst();
+    }
+
+    T* GetLast() override {
+        return &list->GetLast();
+    }
+
+    T* Get(int index) override {
+        return &list->Get(index);
+    }
+
+    int GetSize() override {
+        return list->GetSize();
+    }
+
+    CollectionFootprint MemoryFootprint() override {
+        return list->MemoryFootprint().Wrapped(sizeof(*this));
+    }
+
+    T*& operator[](int) override {
+        throw std::runtime_error("Operator[] not supported for intrusive storage");
+    }
+
+    T* const& operator[](int index) const override {
+        lookup = &list->Get(index);
+        return lookup;
+    }
+
+    bool TryGet(int index, T*& value) override {
+        if (index < 0 || index >= list->GetSize()) {
+            throw IndexOutOfRange();
+        }
+        value = &list->Get(index);
+        return true;
+    }
+
+    bool TryFind(function<bool(T*)> predicate, T*& value) override {
+        for (T* item = list->IsEmpty() ? nullptr : &list->GetFirst(); item != nullptr; item = list->Next(*item)) {
+            if (predicate(item)) {
+                value = item;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    Sequence<T*>* Map(function<T*(T*)> func) override {
+        vector<T*> items;
+        items.reserve(list->GetSize());
+        list->ForEach([&](T& item) { items.push_back(func(&item)); });
+        return FromVector(items);
+    }
+
+    T* Reduce(function<T*(T*, T*)> func, T* startValue) override {
+        T* result = startValue;
+        list->ForEach([&](T& item) { result = func(result, &item); });
+        return result;
+    }
+
+    Sequence<T*>* Where(function<bool(T*)> predicate) override {
+        vector<T*> items;
+        list->ForEach([&](T& item) {
+            if (predicate(&item)) {
+                items.push_back(&item);
+            }
+        });
+        return FromVector(items);
+    }
+
+    Sequence<T*>* Zip(Sequence<T*>* other, function<T*(T*, T*)> func) override {
+        vector<T*> items;
+        int length = min(list->GetSize(), other->GetSize());
+        T* item = length > 0 ? &list->GetFirst() : nullptr;
+        for (int i = 0; i < length; i++, item = list->Next(*item)) {
+            items.push_back(func(item, other->Get(i)));
+        }
+        return FromVector(items);
+    }
+
+    Sequence<T*>* Slice(int index, int count, Sequence<T*>* replacement) override {
+        int size = list->GetSize();
+        if (index < 0) {
+            index = size + index;
+            if (index < 0) {
+                throw IndexOutOfRange();
+            }
+        }
+        if (index >= size || index + count > size) {
+            throw IndexOutOfRange();
+        }
+        vector<T*> items;
+        int i = 0;
+        list->ForEach([&](T& item) {
+            if (i == index && replacement != nullptr) {
+                for (int r = 0; r < replacement->GetSize(); r++) {
+                    items.push_back(replacement->Get(r));
+                }
+            }
+            if (i < index || i >= index + count) {
+                items.push_back(&item);
+            }
+            i++;
+        });
+        return FromVector(items);
+    }
+
+    // The objects that are not delimiters, as shared pointers in a new
+    // array sequence; the list keeps all of them linked.
+    Sequence<T*>* Split(function<bool(T*)> predicate) override {
+        return Where([&predicate](T* item) { return !predicate(item); });
+    }
+
+    void Append(T* item) override {
+        list->Append(*item);
+    }
+
+    void Prepend(T* item) override {
+        list->Prepend(*item);
+    }
+
+    void Insert(T* item, int index) override {
+        list->Insert(*item, index);
+    }
+
+    // O(1): unlinks `item` without searching for it.
+    void Remove(T* item) {
+        list->Remove(*item);
+    }
+
+    void RemoveAt(int index) {
+        list->RemoveAt(index);
+    }
+
+    Sequence<T*>* Concat(Sequence<T*>* other) override {
+        vector<T*> items;
+        items.reserve(list->GetSize() + other->GetSize());
+        list->ForEach([&](T& item) { items.push_back(&item); });
+        for (int i = 0; i < other->GetSize(); i++) {
+            items.push_back(other->Get(i));
+        }
+        return FromVector(items);
+    }
+};
@@ -0,0 +1,614 @@
+#pragma once
+
+#include <cstdint>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "ICollection.h"
+#include "AllocationTracker.h"
+
+// Positional access starts from the nearest known node: the head, the tail
+// for the last element, or the finger, the node found by the previous
+// access, so `for (i...) list.Get(i)` is linear overall. DOUBLY_LINKED adds
+// a back link per node, so walks can also run backwards from the tail or
+// the finger and descending or scattered access stays short too.
+//
+// Nodes are allocated one at a time, so after many Inserts and Prepends
+// the traversal order jumps around the heap. Compact() moves every node
+// into one slab in traversal order; Locality() measures how far the list
+// has drifted from that, and SetAutoCompact(threshold) compacts whenever
+// it drops below the threshold.
+//
+// Splice, Concat(LinkedList&&) and SplitAt move nodes between lists by
+// relinking them, without copying or allocating.
+template <class T, bool DOUBLY_LINKED = false>
+class LinkedList : public ICollection<T>{
+private:
+    struct NoLink {};
+
+    struct Node {
+        T data;
+        Node* next;
+        [[no_unique_address]] conditional_t<DOUBLY_LINKED, Node*, NoLink> prev{};
+        Node(T data, Node* next) : data(std::move(data)), next(next) {}
+    };
+
+    // A link is local when the successor starts a few nodes further on in
+    // memory, where a forward-streaming prefetcher has it already.
+    static constexpr uintptr_t LOCAL_BYTES = 4 * sizeof(Node);
+    // Auto compaction leaves lists this short alone: they fit in cache.
+    static const int AUTO_COMPACT_MIN_SIZE = 4096;
+
+    Node* head;
+    Node* tail;
+    int size;
+    // Links between local nodes, head to tail.
+    int localLinks = 0;
+    double autoCompactThreshold = 0;
+    // A block of nodes placed by Compact(). Splice and SplitAt can leave
+    // one slab's nodes in several lists, so `live` counts its nodes across
+    // all of them and `owners` the lists that hold it in `slabs`. The nodes
+    // are freed with the last live one, the record with the last owner.
+    struct Slab {
+        Node* nodes;
+        int capacity;
+        int live;
+        int owners;
+    };
+
+    // Every slab that may hold one of this list's nodes, and how many of
+    // them are in one.
+    vector<Slab*> slabs;
+    int slabNodes = 0;
+    // The node at fingerIndex, or fingerIndex == -1.
+    mutable Node* finger = nullptr;
+    mutable int fingerIndex = -1;
+
+    static AllocationStats& Stats() {
+        static AllocationStats& stats = AllocationTracker::Register("LinkedList");
+        return stats;
+    }
+
+    static Node* CreateNode(T data, Node* next) {
+        AllocationTracker::OnAllocate(Stats(), sizeof(Node));
+        return new Node(data, next);
+    }
+
+    static bool InSlab(const Slab* slab, const Node* node) {
+        uintptr_t offset = reinterpret_cast<uintptr_t>(node) - reinterpret_cast<uintptr_t>(slab->nodes);
+        return offset < sizeof(Node) * (size_t) slab->capacity;
+    }
+
+    bool InAnySlab(const Node* node) const {
+        for (const Slab* slab : slabs) {
+            if (InSlab(slab, node)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void DestroyNode(Node* node) {
+        for (size_t i = 0; i < slabs.size(); i++) {
+            Slab* slab = slabs[i];
+            if (!InSlab(slab, node)) {
+                continue;
+            }
+            node->~Node();
+            slabNodes--;
+            if (--slab->live == 0) {
+                AllocationTracker::OnFree(Stats(), sizeof(Node) * slab->capacity);
+                ::operator delete(slab->nodes);
+                slab->nodes = nullptr;
+                slab->capacity = 0;
+                slabs.erase(slabs.begin() + i);
+                ReleaseSlab(slab);
+            }
+            return;
+        }
+        AllocationTracker::OnFree(Stats(), sizeof(Node));
+        delete node;
+    }
+
+    // Drops this list's claim on `slab`, already removed from `slabs`.
+    static void ReleaseSlab(Slab* slab) {
+        if (--slab->owners == 0) {
+            delete slab;
+        }
+    }
+
+    // Claims every slab of `other`; shared ones are claimed once.
+    void ShareSlabs(const vector<Slab*>& other) {
+        for (Slab* slab : other) {
+            bool held = false;
+            for (Slab* own : slabs) {
+                held = held || own == slab;
+            }
+            if (!held) {
+                slab->owners++;
+                slabs.push_back(slab);
+            }
+        }
+    }
+
+    void ReleaseSlabs() {
+        for (Slab* slab : slabs) {
+            ReleaseSlab(slab);
+        }
+        slabs.clear();
+        slabNodes = 0;
+    }
+
+    static bool IsLocal(const Node* node, const Node* next) {
+        uintptr_t distance = reinterpret_cast<uintptr_t>(next) - reinterpret_cast<uintptr_t>(node);
+        return next != nullptr && distance - 1 < LOCAL_BYTES;
+    }
+
+    // Points node->next at `next`, keeping the back link and localLinks.
+    void SetNext(Node* node, Node* next) {
+        localLinks += (IsLocal(node, next) ? 1 : 0) - (IsLocal(node, node->next) ? 1 : 0);
+        node->next = next;
+        SetPrev(next, node);
+    }
+
+    void MaybeCompact() {
+        if (autoCompactThreshold > 0 && size >= AUTO_COMPACT_MIN_SIZE && Locality() < autoCompactThreshold) {
+            Compact();
+        }
+    }
+
+    // Stable merge of two null-terminated chains; returns the new head.
+    template <class Compare>
+    static Node* MergeChains(Node* left, Node* right, Compare& compare) {
+        Node* merged = nullptr;
+        Node** link = &merged;
+        while (left != nullptr && right != nullptr) {
+            if (compare(right->data, left->data)) {
+                *link = right;
+                right = right->next;
+            } else {
+                *link = left;
+                left = left->next;
+            }
+            link = &(*link)->next;
+        }
+        *link = left != nullptr ? left : right;
+        return merged;
+    }
+
+    void SetPrev(Node* node, Node* prev) {
+        if constexpr (DOUBLY_LINKED) {
+            if (node != nullptr) {
+                node->prev = prev;
+            }
+        }
+    }
+
+    void ResetFinger() const {
+        finger = nullptr;
+        fingerIndex = -1;
+    }
+
+    // Walks from whichever of head, tail and finger is closest; without
+    // back links only forward walks are possible.
+    Node* GetNode(int index) const {
+        if (index < 0 || index >= size) {
+            throw IndexOutOfRange();
+        }
+        if (index == size - 1) {
+            return tail;
+        }
+        Node* current = head;
+        int position = 0;
+        if (fingerIndex != -1 && fingerIndex <= index) {
+            current = finger;
+            position = fingerIndex;
+        }
+        if constexpr (DOUBLY_LINKED) {
+            int backward = size - 1 - index;
+            Node* from = tail;
+            if (fingerIndex > index && fingerIndex - index < backward) {
+                backward = fingerIndex - index;
+                from = finger;
+            }
+            if (backward < index - position) {
+                for (int i = 0; i < backward; i++) {
+                    from = from->prev;
+                }
+                finger = from;
+                fingerIndex = index;
+                return from;
+            }
+        }
+        for (; position < index; position++) {
+            current = current->next;
+        }
+        finger = current;
+        fingerIndex = index;
+        return current;
+    }
+
+public:
+    LinkedList() : head(nullptr), tail(nullptr), size(0) {}
+
+    LinkedList(T* items, int count) : LinkedList() {
+        for (int i = 0; i < count; i++) {
+            Append(items[i]);
+        }
+    }
+
+    LinkedList(const LinkedList<T, DOUBLY_LINKED> & list) : LinkedList() {
+        Node* current = list.head;
+        while (current != nullptr) {
+            Append(current->data);
+            current = current->next;
+        }
+    }
+
+    ~LinkedList() {
+        while (head != nullptr) {
+            Node* temp = head;
+            head = head->next;
+            DestroyNode(temp);
+        }
+        ReleaseSlabs();
+    }
+
+    // The share of links that are local, 1 for a compacted list.
+    double Locality() const {
+        return size < 2 ? 1.0 : (double) localLinks / (size - 1);
+    }
+
+    // Compacts automatically once Locality() drops below `threshold`,
+    // checked after each change; 0 turns it off. Every change moves at most
+    // two links, so compactions are at least (1 - threshold) * size / 2
+    // changes apart and cost O(1) amortised per change.
+    void SetAutoCompact(double threshold) {
+        autoCompactThreshold = threshold;
+        MaybeCompact();
+    }
+
+    // Moves every node into one new slab in traversal order, so a walk
+    // reads memory sequentially. O(n); node addresses change, values don't.
+    void Compact() {
+        if (size == 0) {
+            return;
+        }
+        Node* placed = static_cast<Node*>(::operator new(sizeof(Node) * size));
+        AllocationTracker::OnAllocate(Stats(), sizeof(Node) * size);
+        Slab* slab = new Slab{placed, size, size, 1};
+        Node* current = head;
+        for (int i = 0; i < size; i++) {
+            Node* next = current->next;
+            Node* node = new (placed + i) Node(std::move(current->data), nullptr);
+            if (i > 0) {
+                placed[i - 1].next = node;
+                SetPrev(node, placed + i - 1);
+            }
+            DestroyNode(current);
+            current = next;
+        }
+        // None of the nodes are in the old slabs any more.
+        ReleaseSlabs();
+        slabs.push_back(slab);
+        slabNodes = size;
+        head = placed;
+        tail = placed + size - 1;
+        localLinks = size - 1;
+        finger = fingerIndex == -1 ? nullptr : placed + fingerIndex;
+    }
+
+    T GetFirst() {
+        if (head == nullptr) {
+            throw IndexOutOfRange();
+        }
+        return head->data;
+    }
+
+    T GetLast() {
+        if (tail == nullptr) {
+            throw IndexOutOfRange();
+        }
+        return tail->data;
+    }
+
+    T Get(int index) override {
+        return GetNode(index)->data;
+    }
+
+    int GetSize() override {
+        return size;
+    }
+
+    CollectionFootprint MemoryFootprint() override {
+        CollectionFootprint footprint;
+        footprint.payloadBytes = sizeof(T) * size;
+        footprint.overheadBytes = sizeof(*this) + (sizeof(Node) - sizeof(T)) * size
+                                  + sizeof(Slab) * slabs.size();
+        footprint.allocationCount = size - slabNodes;
+        for (const Slab* slab : slabs) {
+            // Slots freed in a slab stay allocated until all of them are.
+            footprint.overheadBytes += sizeof(Node) * (size_t) (slab->capacity - slab->live);
+            footprint.allocationCount += 2;
+        }
+        return footprint;
+    }
+
+    T& operator[](int index) {
+        return GetNode(index)->data;
+    }
+
+    const T& operator[](int index) const {
+        return GetNode(index)->data;
+    }
+
+    // Stable bottom-up merge sort that relinks the nodes: no allocation,
+    // O(n log n) comparisons. bins[i] holds a sorted chain of 2^i nodes
+    // (the carry scheme of a binary counter), so each node is merged
+    // O(log n) times and the chains stay short while they are hot.
+    template <class Compare = less<T>>
+    void Sort(Compare compare = Compare()) {
+        if (size < 2) {
+            return;
+        }
+        Node* bins[64] = {};
+        int used = 0;
+        Node* current = head;
+        while (current != nullptr) {
+            Node* carry = current;
+            current = current->next;
+            carry->next = nullptr;
+            int i = 0;
+            for (; i < used && bins[i] != nullptr; i++) {
+                // bins[i] holds earlier nodes, so it goes on the left.
+                carry = MergeChains(bins[i], carry, compare);
+                bins[i] = nullptr;
+            }
+            bins[i] = carry;
+            if (i == used) {
+                used++;
+            }
+        }
+        Node* sorted = nullptr;
+        for (int i = 0; i < used; i++) {
+            if (bins[i] != nullptr) {
+                sorted = sorted == nullptr ? bins[i] : MergeChains(bins[i], sorted, compare);
+            }
+        }
+        head = sorted;
+        tail = head;
+        SetPrev(head, nullptr);
+        localLinks = 0;
+        while (tail->next != nullptr) {
+            SetPrev(tail->next, tail);
+            localLinks += IsLocal(tail, tail->next) ? 1 : 0;
+            tail = tail->next;
+        }
+        ResetFinger();
+        MaybeCompact();
+    }
+
+    LinkedList<T, DOUBLY_LINKED>* GetSubList(int startIndex, int endIndex) {
+        if (startIndex < 0 || endIndex >= size || startIndex > endIndex) {
+            throw IndexOutOfRange();
+        }
+
+        LinkedList<T, DOUBLY_LINKED>* subList = new LinkedList<T, DOUBLY_LINKED>();
+        Node* current = GetNode(startIndex);
+        for (int i = startIndex; i < endIndex; i++) {
+            subList->Append(current->data);
+            current = current->next;
+        }
+        return subList;
+    }
+
+    void Append(T item) override{
+        Node* newNode = CreateNode(item, nullptr);
+        if (head == nullptr) {
+            head = tail = newNode;
+        } else {
+            SetNext(tail, newNode);
+            tail = newNode;
+        }
+        size++;
+        MaybeCompact();
+    }
+
+    void Prepend(T item) override{
+        Node* newNode = CreateNode(item, nullptr);
+        if (head == nullptr) {
+            tail = newNode;
+        } else {
+            SetNext(newNode, head);
+        }
+        head = newNode;
+        size++;
+        if (fingerIndex != -1) {
+            fingerIndex++;
+        }
+        MaybeCompact();
+    }
+
+    void Insert(T item, int index) override{
+        if (index < 0 || index > size) {
+            throw IndexOutOfRange();
+        }
+
+        if (index == 0) {
+            Prepend(item);
+        } else if (index == size) {
+            Append(item);
+        } else {
+            Node* current = GetNode(index - 1);
+            Node* newNode = CreateNode(item, nullptr);
+            SetNext(newNode, current->next);
+            SetNext(current, newNode);
+            size++;
+            // The finger is at index - 1, before the new node.
+            MaybeCompact();
+        }
+    }
+
+    void RemoveAt(int index) {
+        if (index < 0 || index >= size) {
+            throw IndexOutOfRange();
+        }
+        Node* removed;
+        if (index == 0) {
+            removed = head;
+            head = head->next;
+            SetPrev(head, nullptr);
+            if (head == nullptr) {
+                tail = nullptr;
+            }
+            ResetFinger();
+        } else {
+            // Leaves the finger at index - 1, before the removed node.
+            Node* previous = GetNode(index - 1);
+            removed = previous->next;
+            SetNext(previous, removed->next);
+            if (removed == tail) {
+                tail = previous;
+            }
+        }
+        SetNext(removed, nullptr);
+        DestroyNode(removed);
+        size--;
+        MaybeCompact();
+    }
+
+    LinkedList<T, DOUBLY_LINKED>* Concat(LinkedList<T, DOUBLY_LINKED> *list) {
+        LinkedList<T, DOUBLY_LINKED>* newList = new LinkedList<T, DOUBLY_LINKED>(*this);
+        Node* current = list->head;
+        while (current != nullptr) {
+            newList->Append(current->data);
+            current = current->next;
+        }
+        return newList;
+    }
+
+    // Moves every node of `list` to the end of this one in O(1), leaving
+    // `list` empty. Nothing is copied or allocated.
+    void Splice(LinkedList<T, DOUBLY_LINKED>& list) {
+        Splice(list, size);
+    }
+
+    // Moves every node of `list` in before position `index`: O(index) to
+    // find the position, O(1) to relink.
+    void Splice(LinkedList<T, DOUBLY_LINKED>& list, int index) {
+        if (index < 0 || index > size) {
+            throw IndexOutOfRange();
+        }
+        if (&list == this) {
+            throw std::runtime_error("Cannot splice a list into itself");
+        }
+        if (list.size == 0) {
+            return;
+        }
+        Node* first = list.head;
+        Node* last = list.tail;
+        int moved = list.size;
+        localLinks += list.localLinks;
+        ShareSlabs(list.slabs);
+        slabNodes += list.slabNodes;
+        list.ReleaseSlabs();
+        list.head = list.tail = nullptr;
+        list.size = 0;
+        list.localLinks = 0;
+        list.ResetFinger();
+        if (index == 0) {
+            if (head == nullptr) {
+                tail = last;
+            } else {
+                SetNext(last, head);
+            }
+            head = first;
+            if (fingerIndex != -1) {
+                fingerIndex += moved;
+            }
+        } else {
+            // Leaves the finger at index - 1, before the spliced nodes.
+            Node* previous = GetNode(index - 1);
+            SetNext(last, previous->next);
+            SetNext(previous, first);
+            if (previous == tail) {
+                tail = last;
+            }
+        }
+        size += moved;
+        MaybeCompact();
+    }
+
+    // Appends the nodes of `list` in O(1) and leaves it empty:
+    // `a.Concat(std::move(b))` where b is not needed afterwards.
+    void Concat(LinkedList<T, DOUBLY_LINKED>&& list) {
+        Splice(list);
+    }
+
+    // Cuts the list before `index` and returns the nodes from there on as a
+    // new list, without copying them. O(index) to find the cut, or
+    // O(size - index) from the tail when doubly linked.
+    LinkedList<T, DOUBLY_LINKED>* SplitAt(int index) {
+        if (index < 0 || index > size) {
+            throw IndexOutOfRange();
+        }
+        LinkedList<T, DOUBLY_LINKED>* rest = new LinkedList<T, DOUBLY_LINKED>();
+        if (index == 0) {
+            rest->Splice(*this);
+            return rest;
+        }
+        if (index == size) {
+            return rest;
+        }
+        // Local links and slab nodes are counted on the side that is walked;
+        // the other side gets the remainder.
+        int restSize = size - index;
+        int restLocal = 0;
+        int restSlabNodes = 0;
+        Node* last = nullptr;
+        bool fromTail = false;
+        if constexpr (DOUBLY_LINKED) {
+            fromTail = restSize < index;
+            if (fromTail) {
+                Node* current = tail;
+                for (int i = 0; i < restSize; i++) {
+                    restSlabNodes += InAnySlab(current) ? 1 : 0;
+                    restLocal += i > 0 && IsLocal(current, current->next) ? 1 : 0;
+                    last = current->prev;
+                    current = current->prev;
+                }
+            }
+        }
+        if (!fromTail) {
+            int headLocal = 0;
+            int headSlabNodes = 0;
+            Node* current = head;
+            for (int i = 0; i < index; i++) {
+                headSlabNodes += InAnySlab(current) ? 1 : 0;
+                headLocal += i < index - 1 && IsLocal(current, current->next) ? 1 : 0;
+                last = current;
+                current = current->next;
+            }
+            restLocal = localLinks - headLocal - (IsLocal(last, last->next) ? 1 : 0);
+            restSlabNodes = slabNodes - headSlabNodes;
+        }
+        rest->head = last->next;
+        rest->tail = tail;
+        rest->size = restSize;
+        rest->localLinks = restLocal;
+        rest->ShareSlabs(slabs);
+        rest->slabNodes = restSlabNodes;
+        SetPrev(rest->head, nullptr);
+        localLinks -= restLocal + (IsLocal(last, last->next) ? 1 : 0);
+        slabNodes -= restSlabNodes;
+        last->next = nullptr;
+        tail = last;
+        size = index;
+        if (fingerIndex >= index) {
+            ResetFinger();
+        }
+        return rest;
+    }
+};
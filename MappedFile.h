@@ -0,0 +1,192 @@
+#pragma once
+
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define LAB2_HAS_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+enum class AccessHint { Normal, Sequential, Random, WillNeed };
+
+// A read-write, shared mapping of a whole file. The file length is the
+// mapping's capacity; callers that store a logical size smaller than that
+// pass it to Close() so the file is trimmed back to its contents. A
+// copy-on-write mapping opens the file read-only and never changes it.
+// Only available on POSIX systems; elsewhere the constructor throws.
+class MappedFile {
+private:
+    int fd = -1;
+    void* address = nullptr;
+    size_t length = 0;
+    bool copyOnWrite = false;
+
+    static void Fail(const string& what, const string& path) {
+        throw runtime_error("MappedFile: " + what + " failed for " + path);
+    }
+
+#if LAB2_HAS_MMAP
+    void Map(const string& path) {
+        if (length == 0) {
+            address = nullptr;
+            return;
+        }
+        address = mmap(nullptr, length, PROT_READ | PROT_WRITE, copyOnWrite ? MAP_PRIVATE : MAP_SHARED, fd, 0);
+        if (address == MAP_FAILED) {
+            address = nullptr;
+            Fail("mmap", path);
+        }
+    }
+#endif
+
+public:
+    // Maps an existing file (create == false) or creates/truncates one to
+    // `bytes` (create == true). Opening an existing file does no I/O: pages
+    // are faulted in on first touch.
+    MappedFile(const string& path, bool create, size_t bytes = 0, bool copyOnWrite = false)
+        : copyOnWrite(copyOnWrite && !create) {
+#if LAB2_HAS_MMAP
+        int flags = create ? (O_RDWR | O_CREAT | O_TRUNC) : (this->copyOnWrite ? O_RDONLY : O_RDWR);
+        fd = open(path.c_str(), flags, 0644);
+        if (fd < 0) {
+            Fail("open", path);
+        }
+        if (create) {
+            if (ftruncate(fd, (off_t) bytes) != 0) {
+                close(fd);
+                Fail("ftruncate", path);
+            }
+            length = bytes;
+        } else {
+            struct stat info;
+            if (fstat(fd, &info) != 0) {
+                close(fd);
+                Fail("fstat", path);
+            }
+            length = (size_t) info.st_size;
+        }
+        try {
+            Map(path);
+        } catch (...) {
+            close(fd);
+            throw;
+        }
+#else
+        (void) create;
+        (void) bytes;
+        Fail("memory mapping (unsupported platform)", path);
+#endif
+    }
+
+    ~MappedFile() {
+        Close(length);
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    void* Data() const {
+        return address;
+    }
+
+    size_t Length() const {
+        return length;
+    }
+
+    // Extends the file with ftruncate and the mapping with mremap, which
+    // may move it; callers must re-read Data().
+    void Grow(size_t bytes) {
+#if LAB2_HAS_MMAP
+        if (bytes <= length) {
+            return;
+        }
+        if (copyOnWrite) {
+            Fail("grow of a copy-on-write mapping", "grow");
+        }
+        if (ftruncate(fd, (off_t) bytes) != 0) {
+            Fail("ftruncate", "grow");
+        }
+        if (address == nullptr) {
+            length = bytes;
+            Map("grow");
+            return;
+        }
+#if defined(__linux__)
+        void* moved = mremap(address, length, bytes, MREMAP_MAYMOVE);
+        if (moved == MAP_FAILED) {
+            Fail("mremap", "grow");
+        }
+        address = moved;
+        length = bytes;
+#else
+        munmap(address, length);
+        length = bytes;
+        Map("grow");
+#endif
+#else
+        (void) bytes;
+#endif
+    }
+
+    // msync of the first `bytes` bytes (the whole mapping by default).
+    void Flush(size_t bytes = (size_t) -1) {
+#if LAB2_HAS_MMAP
+        if (address != nullptr && !copyOnWrite) {
+            size_t count = bytes < length ? bytes : length;
+            if (count > 0 && msync(address, count, MS_SYNC) != 0) {
+                Fail("msync", "flush");
+            }
+        }
+#else
+        (void) bytes;
+#endif
+    }
+
+    void Advise(AccessHint hint) {
+#if LAB2_HAS_MMAP
+        if (address == nullptr) {
+            return;
+        }
+        int advice = MADV_NORMAL;
+        if (hint == AccessHint::Sequential) {
+            advice = MADV_SEQUENTIAL;
+        } else if (hint == AccessHint::Random) {
+            advice = MADV_RANDOM;
+        } else if (hint == AccessHint::WillNeed) {
+            advice = MADV_WILLNEED;
+        }
+        madvise(address, length, advice);
+#else
+        (void) hint;
+#endif
+    }
+
+    // Unmaps and trims the file to `bytes`. Safe to call more than once.
+    void Close(size_t bytes) {
+#if LAB2_HAS_MMAP
+        if (fd < 0) {
+            return;
+        }
+        if (address != nullptr) {
+            munmap(address, length);
+            address = nullptr;
+        }
+        if (bytes < length && !copyOnWrite) {
+            // A failed trim only leaves zeroed slack at the end of the file.
+            int trimmed = ftruncate(fd, (off_t) bytes);
+            (void) trimmed;
+        }
+        close(fd);
+        fd = -1;
+#else
+        (void) bytes;
+#endif
+    }
+};
@@ -0,0 +1,245 @@
+#pragma once
+
+#include "Sequence.h"
+#include "DynamicArray.h"
+#include "Sorting.h"
+
+template <class T>
+class MutableArraySequence : public Sequence<T> {
+protected:
+    DynamicArray<T>* array;
+    MutableArraySequence<T>* CreateMutableArraySequence(){
+        return new MutableArraySequence<T>();
+    }
+public:
+    MutableArraySequence(T* items, int count) {
+        array = new DynamicArray<T>(items, count);
+    }
+
+    MutableArraySequence() {
+        array = new DynamicArray<T>(0);
+    }
+
+    MutableArraySequence(MutableArraySequence<T>* other) {
+        array = new DynamicArray<T>(*other->array);
+    }
+
+    // Drains `source`, e.g. the end of a Generator pipeline.
+    explicit MutableArraySequence(Generator<T> source) {
+        vector<T> items;
+        for (const T& item : source) {
+            items.push_back(item);
+        }
+        array = new DynamicArray<T>(items.data(), (int) items.size());
+    }
+
+    // Takes ownership of `storage`, e.g. a file-backed DynamicArray.
+    explicit MutableArraySequence(DynamicArray<T>* storage) {
+        array = storage;
+    }
+
+    ~MutableArraySequence(){
+        delete array;
+    }
+
+    // A sequence stored in `path` (see DynamicArray::CreateMapped); only for
+    // trivially copyable T.
+    static MutableArraySequence<T>* CreateMapped(const string& path, int count = 0) {
+        return new MutableArraySequence<T>(DynamicArray<T>::CreateMapped(path, count));
+    }
+
+    // Adopts an existing file of raw elements in O(1) without copying.
+    static MutableArraySequence<T>* OpenMapped(const string& path) {
+        return new MutableArraySequence<T>(DynamicArray<T>::OpenMapped(path));
+    }
+
+    bool IsMapped() const {
+        return array->IsMapped();
+    }
+
+    void Flush() {
+        array->Flush();
+    }
+
+    void Advise(AccessHint hint) {
+        array->Advise(hint);
+    }
+
+    // Sorts in place (see Sorting.h): pdqsort, or radix sort for arithmetic
+    // T in ascending order; parallel sample sort for large arrays.
+    template <class Compare = less<T>>
+    void Sort(Compare compare = Compare()) {
+        if (array->GetSize() > 1) {
+            SortRange(&(*array)[0], array->GetSize(), compare);
+        }
+    }
+
+    // Like Sort, but equal elements keep their relative order.
+    template <class Compare = less<T>>
+    void StableSort(Compare compare = Compare()) {
+        if (array->GetSize() > 1) {
+            StableSortRange(&(*array)[0], array->GetSize(), compare);
+        }
+    }
+
+    Sequence<T>* GetSubSequence(int startIndex, int endIndex) override {
+        Sequence<T>* subSequence = new MutableArraySequence<T>();
+        for (int i = startIndex; i < endIndex; i++) {
+            subSequence->Append(Get(i));
+        }
+        return subSequence;
+    }
+
+    T GetFirst() override{
+        if (array->GetSize() == 0) {
+            throw IndexOutOfRange();
+        }
+        return array->Get(0);
+    }
+
+    T GetLast() override{
+        if (array->GetSize() == 0) {
+            throw IndexOutOfRange();
+        }
+        return array->Get(array->GetSize() - 1);
+    }
+
+    T Get(int index) override{
+        return array->Get(index);
+    }
+
+    int GetSize() override{
+        return array->GetSize();
+    }
+
+    CollectionFootprint MemoryFootprint() override {
+        return array->MemoryFootprint().Wrapped(sizeof(*this));
+    }
+
+    T& operator[](int index) override {
+        return (*array)[index];
+    }
+
+    const T& operator[](int index) const override {
+        return (*array)[index];
+    }
+
+    bool TryGet(int index, T& value) override{
+        if (index < 0 || index >= array->GetSize()) {
+            throw IndexOutOfRange();
+        }
+        value = array->Get(index);
+        return true;
+    }
+
+    bool TryFind(function<bool(T)> predicate, T& value) override{
+        for (int i = 0; i < array->GetSize(); i++) {
+            if (predicate((*array)[i])) {
+                value = array->Get(i);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    Sequence<T>* Map(function<T(T)> func) override{
+        MutableArraySequence<T>* newSequence = CreateMutableArraySequence();
+        for (int i = 0; i < array->GetSize(); ++i) {
+            newSequence->Append(func(array->Get(i)));
+        }
+        return newSequence;
+    }
+
+    T Reduce(function<T(T, T)> func, T startValue) override{
+        T result = startValue;
+        for (int i = 0; i < array->GetSize(); ++i) {
+            result = func(result, array->Get(i));
+        }
+        return result;
+    }
+
+    Sequence<T>* Where(function<bool(T)> predicate) override{
+        MutableArraySequence<T>* newSequence = CreateMutableArraySequence();
+        for (int i = 0; i < array->GetSize(); ++i) {
+            T item = array->Get(i);
+            if (predicate(item)) {
+                newSequence->Append(item);
+            }
+        }
+        return newSequence;
+    }
+
+    Sequence<T>* Zip (Sequence<T>* other, function<T(T, T)> func) override {
+        MutableArraySequence<T>* newSequence = CreateMutableArraySequence();
+        int minLength = min(array->GetSize(), other->GetSize());
+        for (int i = 0; i < minLength; ++i) {
+            newSequence->Append(func(array->Get(i), other->Get(i)));
+        }
+        return newSequence;
+    }
+
+    Sequence<T>* Slice(int index, int count, Sequence<T>* replacement) override {
+        MutableArraySequence<T>* newSequence = CreateMutableArraySequence();
+        if (index < 0) {
+            index = array->GetSize() + index;
+            if (index < 0) {
+                throw IndexOutOfRange();
+            }
+        }
+        if (index >= array->GetSize() || index + count > array->GetSize()) {
+            throw IndexOutOfRange();
+        }
+        for (int i = 0; i < index; ++i) {
+            newSequence->Append(array->Get(i));
+        }
+        if (replacement != nullptr) {
+            for (int i = 0; i < replacement->GetSize(); ++i) {
+                newSequence->Append(replacement->Get(i));
+            }
+        }
+        for (int i = index + count; i < array->GetSize(); ++i) {
+            newSequence->Append(array->Get(i));
+        }
+        return newSequence;
+    }
+
+    Sequence<T>* Split(function<bool(T)> predicate) override {
+        MutableArraySequence<T>* newSequence = CreateMutableArraySequence();
+        MutableArraySequence<T>* currentChunk = CreateMutableArraySequence();
+        for (int i = 0; i < array->GetSize(); ++i) {
+            T item = array->Get(i);
+            if (predicate(item)) {
+                if (currentChunk->GetSize() > 0) {
+                    newSequence->Concat(currentChunk);
+                    currentChunk = CreateMutableArraySequence();
+                }
+            } else {
+                    currentChunk->Append(item);
+                }
+            }
+            if (currentChunk->GetSize() > 0) {
+                newSequence->Concat(currentChunk);
+            }
+            return newSequence;
+    }
+
+    void Append(T item) override{
+        this->array->Append(item);
+    }
+
+    void Prepend(T item) override{
+        this->array->Prepend(item);
+    }
+
+    void Insert(T item, int index) override{
+        this->array->Insert(item, index);
+    }
+
+    Sequence<T>* Concat(Sequence<T>* list) override{
+        MutableArraySequence<T>* newSequence = new MutableArraySequence<T>(this);
+        for (int i = 0; i < list->GetSize(); ++i) {
+            newSequence->Append(list->Get(i));
+        }
+        return newSequence;
+    }
+};
@@ -0,0 +1,230 @@
+#pragma once
+
+#include "Sequence.h"
+#include "LinkedList.h"
+
+// `List` is the node storage: LinkedList by default, or SkipList for
+// O(log n) positional access (MutableListSequence<T, SkipList<T>>).
+template <class T, class List = LinkedList<T>>
+class MutableListSequence : public Sequence<T> {
+protected:
+    List* list;
+    MutableListSequence<T, List>* CreateMutableListSequence(){
+        return new MutableListSequence<T, List>();
+    }
+public:
+    MutableListSequence(T* items, int count) {
+        list = new List(items, count);
+    }
+
+    MutableListSequence() {
+        list = new List();
+    }
+
+    MutableListSequence(MutableListSequence<T, List>* other) {
+        list = new List(*other->list);
+    }
+
+    // Takes ownership of `storage`.
+    explicit MutableListSequence(List* storage) {
+        list = storage;
+    }
+
+    ~MutableListSequence() {
+        delete this->list;
+    }
+
+    // Relinks the nodes in sorted order (LinkedList::Sort); stable and
+    // allocation-free.
+    template <class Compare = less<T>>
+    void Sort(Compare compare = Compare()) {
+        list->Sort(compare);
+    }
+
+    // The list merge sort is already stable.
+    template <class Compare = less<T>>
+    void StableSort(Compare compare = Compare()) {
+        list->Sort(compare);
+    }
+
+    Sequence<T>* GetSubSequence(int startIndex, int endIndex) override {
+        Sequence<T>* subSequence = new MutableListSequence<T, List>();
+        for (int i = startIndex; i < endIndex; i++) {
+            subSequence->Append(Get(i));
+        }
+        return subSequence;
+    }
+
+    T GetFirst() override{
+        if (list->GetSize() == 0) {
+            throw IndexOutOfRange();
+        }
+        return list->Get(0);
+    }
+
+    T GetLast() override{
+        if (list->GetSize() == 0) {
+            throw IndexOutOfRange();
+        }
+        return list->GetLast();
+    }
+
+    T Get(int index) override{
+        return list->Get(index);
+    }
+
+    int GetSize() override{
+        return list->GetSize();
+    }
+
+    CollectionFootprint MemoryFootprint() override {
+        return list->MemoryFootprint().Wrapped(sizeof(*this));
+    }
+
+    T& operator[](int index) override {
+        return (*list)[index];
+    }
+
+    const T& operator[](int index) const override {
+        return (*list)[index];
+    }
+
+    bool TryGet(int index, T& value) override{
+        if (index < 0 || index >= list->GetSize()) {
+            throw IndexOutOfRange();
+        }
+        value = list->Get(index);
+        return true;
+    }
+
+    bool TryFind(function<bool(T)> predicate, T& value) override{
+        for (int i = 0; i < list->GetSize(); i++) {
+            if (predicate((*list)[i])) {
+                value = list->Get(i);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    Sequence<T>* Map(function<T(T)> func) override{
+        MutableListSequence<T, List>* newSequence = CreateMutableListSequence();
+        for (int i = 0; i < list->GetSize(); ++i) {
+            newSequence->Append(func(list->Get(i)));
+        }
+        return newSequence;
+    }
+
+    T Reduce(function<T(T, T)> func, T startValue) override{
+        T result = startValue;
+        for (int i = 0; i < list->GetSize(); ++i) {
+            result = func(result, list->Get(i));
+        }
+        return result;
+    }
+
+    Sequence<T>* Where(function<bool(T)> predicate) override{
+        MutableListSequence<T, List>* newSequence = CreateMutableListSequence();
+        for (int i = 0; i < list->GetSize(); ++i) {
+            T item = list->Get(i);
+            if (predicate(item)) {
+                newSequence->Append(item);
+            }
+        }
+        return newSequence;
+    }
+
+    Sequence<T>* Zip (Sequence<T>* other, function<T(T, T)> func) override {
+        MutableListSequence<T, List>* newSequence = CreateMutableListSequence();
+        int minLength = min(list->GetSize(), other->GetSize());
+        for (int i = 0; i < minLength; ++i) {
+            newSequence->Append(func(list->Get(i), other->Get(i)));
+        }
+        return newSequence;
+    }
+
+    Sequence<T>* Slice(int index, int count, Sequence<T>* replacement) override {
+        MutableListSequence<T, List>* newSequence = CreateMutableListSequence();
+        if (index < 0) {
+            index = list->GetSize() + index;
+            if (index < 0) {
+                throw IndexOutOfRange();
+            }
+        }
+        if (index >= list->GetSize() || index + count > list->GetSize()) {
+            throw IndexOutOfRange();
+        }
+        for (int i = 0; i < index; ++i) {
+            newSequence->Append(list->Get(i));
+        }
+        if (replacement != nullptr) {
+            for (int i = 0; i < replacement->GetSize(); ++i) {
+                newSequence->Append(replacement->Get(i));
+            }
+        }
+        for (int i = index + count; i < list->GetSize(); ++i) {
+            newSequence->Append(list->Get(i));
+        }
+        return newSequence;
+    }
+
+    Sequence<T>* Split(function<bool(T)> predicate) override {
+        MutableListSequence<T, List>* newSequence = CreateMutableListSequence();
+        MutableListSequence<T, List>* currentChunk = CreateMutableListSequence();
+        for (int i = 0; i < list->GetSize(); ++i) {
+            T item = list->Get(i);
+            if (predicate(item)) {
+                if (currentChunk->GetSize() > 0) {
+                    newSequence->Concat(currentChunk);
+                    currentChunk = CreateMutableListSequence();
+                }
+            } else {
+                    currentChunk->Append(item);
+                }
+            }
+            if (currentChunk->GetSize() > 0) {
+                newSequence->Concat(currentChunk);
+            }
+            return newSequence;
+    }
+
+    void Append(T item) override{
+        this->list->Append(item);
+    }
+
+    void Prepend(T item) override{
+        this->list->Prepend(item);
+    }
+
+    void Insert(T item, int index) override{
+        this->list->Insert(item, index);
+    }
+
+    void RemoveAt(int index) {
+        this->list->RemoveAt(index);
+    }
+
+    // Moves the elements of `other` to the end of this sequence by relinking
+    // (LinkedList::Splice), leaving `other` empty.
+    void Splice(MutableListSequence<T, List>& other) {
+        this->list->Splice(*other.list);
+    }
+
+    void Concat(MutableListSequence<T, List>&& other) {
+        this->list->Splice(*other.list);
+    }
+
+    // Keeps [0, index) and returns the rest as a new sequence, relinked
+    // rather than copied.
+    MutableListSequence<T, List>* SplitAt(int index) {
+        return new MutableListSequence<T, List>(this->list->SplitAt(index));
+    }
+
+    Sequence<T>* Concat(Sequence<T>* list) override{
+        MutableListSequence<T, List>* newSequence = new MutableListSequence<T, List>(this);
+        for (int i = 0; i < list->GetSize(); ++i) {
+            newSequence->Append(list->Get(i));
+        }
+        return newSequence;
+    }
+};
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <stdexcept>
+
+using namespace std;
+
+template <class T>
+class Option {
+private:
+    T value;
+    bool hasValue;
+public:
+    Option() : hasValue(false) {}
+    Option(T val) : value(val), hasValue(true) {}
+    static Option<T> None() {
+        return Option<T>();
+    }
+
+    bool IsSome() {
+        return hasValue;
+    }
+
+    bool IsNone() {
+        return !hasValue;
+    }
+
+    T GetValue() {
+        if (!hasValue) {
+            throw runtime_error("Option is None");
+        }
+        return value;
+    }
+};
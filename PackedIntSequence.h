@@ -0,0 +1,329 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <climits>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+#include "DynamicArray.h"
+#include "Sequence.h"
+#include "IndexOutOfRange.h"
+
+// An append-only integer sequence compressed in blocks of 128 values.
+// Each block is bit-packed at the width of its widest value after one of
+// two transforms, whichever packs smaller:
+//
+//   frame of reference   value - block minimum
+//   delta                gap to the previous value - smallest gap
+//                        (non-decreasing blocks only: sorted ids, times)
+//
+// A directory holds each block's reference value and the offset of its
+// first word (the skip pointer), so Get jumps straight to its block: it
+// reads a frame-of-reference value in place and decodes a delta block,
+// which is cached for the sequential reads that usually follow.
+// Values that do not fill a block yet wait uncompressed, so Append is O(1).
+//
+// Blocks are packed in LANES interleaved bit streams: value i goes to lane
+// i % LANES and word w of every lane is stored together. Every lane then
+// needs the same shift at the same step, so Unpack, instantiated for each
+// bit width, is a loop the compiler turns into vector shifts and masks.
+template <class T>
+class PackedIntSequence {
+    static_assert(is_integral_v<T> && !is_same_v<T, bool>, "PackedIntSequence holds integers");
+
+public:
+    static const int BLOCK_SIZE = 128;
+
+private:
+    using U = make_unsigned_t<T>;
+    using Unpacker = void (*)(const uint64_t*, U*);
+
+    static const int LANES = 4;
+    static const int LANE_VALUES = BLOCK_SIZE / LANES;
+    static const int MAX_BITS = (int) sizeof(T) * CHAR_BIT;
+
+    struct Block {
+        T reference;   // frame of reference: the minimum; delta: the first value
+        U step;        // delta: the smallest gap, added back to every gap
+        int offset;    // first word of the block in `words`
+        uint8_t bits;
+        bool delta;
+    };
+
+    DynamicArray<uint64_t>* words;
+    DynamicArray<Block>* blocks;
+    int wordCount = 0;
+    int blockCount = 0;
+    T pending[BLOCK_SIZE];
+    int pendingCount = 0;
+
+    mutable int cachedBlock = -1;
+    mutable T cache[BLOCK_SIZE];
+
+    static int WordsFor(int bits) {
+        return LANES * ((LANE_VALUES * bits + 63) / 64);
+    }
+
+    template <int BITS>
+    static void Unpack(const uint64_t* in, U* out) {
+        if constexpr (BITS == 0) {
+            for (int i = 0; i < BLOCK_SIZE; i++) {
+                out[i] = 0;
+            }
+        } else {
+            constexpr uint64_t MASK = BITS == 64 ? ~0ull : (1ull << BITS) - 1;
+            for (int step = 0; step < LANE_VALUES; step++) {
+                const int bit = step * BITS;
+                const int word = bit >> 6;
+                const int shift = bit & 63;
+                for (int lane = 0; lane < LANES; lane++) {
+                    uint64_t value = in[word * LANES + lane] >> shift;
+                    if (shift + BITS > 64) {
+                        value |= in[(word + 1) * LANES + lane] << (64 - shift);
+                    }
+                    out[step * LANES + lane] = (U) (value & MASK);
+                }
+            }
+        }
+    }
+
+    template <size_t... Bits>
+    static constexpr array<Unpacker, sizeof...(Bits)> MakeUnpackers(index_sequence<Bits...>) {
+        return {&Unpack<(int) Bits>...};
+    }
+
+    static inline const array<Unpacker, MAX_BITS + 1> UNPACKERS = MakeUnpackers(make_index_sequence<MAX_BITS + 1>());
+
+    static void Pack(const U* in, int bits, uint64_t* out) {
+        int count = WordsFor(bits);
+        for (int i = 0; i < count; i++) {
+            out[i] = 0;
+        }
+        for (int step = 0; step < LANE_VALUES && bits > 0; step++) {
+            const int bit = step * bits;
+            const int word = bit >> 6;
+            const int shift = bit & 63;
+            for (int lane = 0; lane < LANES; lane++) {
+                uint64_t value = in[step * LANES + lane];
+                out[word * LANES + lane] |= value << shift;
+                if (shift + bits > 64) {
+                    out[(word + 1) * LANES + lane] |= value >> (64 - shift);
+                }
+            }
+        }
+    }
+
+    template <class Item>
+    static void Grow(DynamicArray<Item>* array, int count) {
+        int capacity = array->GetSize();
+        if (count <= capacity) {
+            return;
+        }
+        int newCapacity = GrowCapacity(capacity, count, 16);
+        array->Resize(newCapacity);
+    }
+
+    // Compresses the full pending buffer into a new block.
+    void Flush() {
+        U packed[BLOCK_SIZE];
+        T low = pending[0];
+        T high = pending[0];
+        bool sorted = true;
+        U lowGap = ~(U) 0;
+        U highGap = 0;
+        for (int i = 1; i < BLOCK_SIZE; i++) {
+            low = pending[i] < low ? pending[i] : low;
+            high = high < pending[i] ? pending[i] : high;
+            sorted = sorted && !(pending[i] < pending[i - 1]);
+            U gap = (U) pending[i] - (U) pending[i - 1];
+            lowGap = gap < lowGap ? gap : lowGap;
+            highGap = highGap < gap ? gap : highGap;
+        }
+        Block block;
+        int referenceBits = (int) bit_width((U) ((U) high - (U) low));
+        int deltaBits = sorted ? (int) bit_width((U) (highGap - lowGap)) : MAX_BITS + 1;
+        block.delta = deltaBits < referenceBits;
+        if (block.delta) {
+            block.reference = pending[0];
+            block.step = lowGap;
+            block.bits = (uint8_t) deltaBits;
+            packed[0] = 0;
+            for (int i = 1; i < BLOCK_SIZE; i++) {
+                packed[i] = (U) ((U) pending[i] - (U) pending[i - 1] - lowGap);
+            }
+        } else {
+            block.reference = low;
+            block.step = 0;
+            block.bits = (uint8_t) referenceBits;
+            for (int i = 0; i < BLOCK_SIZE; i++) {
+                packed[i] = (U) ((U) pending[i] - (U) low);
+            }
+        }
+        block.offset = wordCount;
+        int blockWords = WordsFor(block.bits);
+        Grow(words, wordCount + blockWords + 1);
+        Pack(packed, block.bits, &(*words)[0] + wordCount);
+        wordCount += blockWords;
+        Grow(blocks, blockCount + 1);
+        (*blocks)[blockCount++] = block;
+        pendingCount = 0;
+    }
+
+    // Decodes block `index` into out[0, BLOCK_SIZE).
+    void DecodeBlock(int index, T* out) const {
+        const Block& block = (*blocks)[index];
+        U raw[BLOCK_SIZE];
+        UNPACKERS[block.bits](&(*words)[0] + block.offset, raw);
+        if (block.delta) {
+            U value = (U) block.reference;
+            out[0] = block.reference;
+            for (int i = 1; i < BLOCK_SIZE; i++) {
+                value += block.step + raw[i];
+                out[i] = (T) value;
+            }
+        } else {
+            for (int i = 0; i < BLOCK_SIZE; i++) {
+                out[i] = (T) ((U) block.reference + raw[i]);
+            }
+        }
+    }
+
+    // One value of a frame-of-reference block, without decoding the rest.
+    T Extract(int index, int position) const {
+        const Block& block = (*blocks)[index];
+        if (block.bits == 0) {
+            return block.reference;
+        }
+        const uint64_t* in = &(*words)[0] + block.offset;
+        const int bit = position / LANES * block.bits;
+        const int word = bit >> 6;
+        const int shift = bit & 63;
+        const int lane = position % LANES;
+        uint64_t value = in[word * LANES + lane] >> shift;
+        if (shift + block.bits > 64) {
+            value |= in[(word + 1) * LANES + lane] << (64 - shift);
+        }
+        if (block.bits < 64) {
+            value &= (1ull << block.bits) - 1;
+        }
+        return (T) ((U) block.reference + (U) value);
+    }
+
+public:
+    PackedIntSequence() {
+        words = new DynamicArray<uint64_t>(0);
+        blocks = new DynamicArray<Block>(0);
+    }
+
+    PackedIntSequence(const T* items, int count) : PackedIntSequence() {
+        for (int i = 0; i < count; i++) {
+            Append(items[i]);
+        }
+    }
+
+    explicit PackedIntSequence(Sequence<T>* sequence) : PackedIntSequence() {
+        for (int i = 0; i < sequence->GetSize(); i++) {
+            Append(sequence->Get(i));
+        }
+    }
+
+    PackedIntSequence(const PackedIntSequence<T>&) = delete;
+    PackedIntSequence& operator=(const PackedIntSequence<T>&) = delete;
+
+    ~PackedIntSequence() {
+        delete blocks;
+        delete words;
+    }
+
+    int GetSize() const {
+        return blockCount * BLOCK_SIZE + pendingCount;
+    }
+
+    int BlockCount() const {
+        return blockCount;
+    }
+
+    void Append(T item) {
+        pending[pendingCount++] = item;
+        if (pendingCount == BLOCK_SIZE) {
+            Flush();
+        }
+    }
+
+    T Get(int index) const {
+        if (index < 0 || index >= GetSize()) {
+            throw IndexOutOfRange();
+        }
+        int block = index / BLOCK_SIZE;
+        if (block == blockCount) {
+            return pending[index % BLOCK_SIZE];
+        }
+        if (block != cachedBlock && !(*blocks)[block].delta) {
+            return Extract(block, index % BLOCK_SIZE);
+        }
+        if (block != cachedBlock) {
+            DecodeBlock(block, cache);
+            cachedBlock = block;
+        }
+        return cache[index % BLOCK_SIZE];
+    }
+
+    // Calls func(values, count) with each decoded block in order, then with
+    // the values not yet packed.
+    template <class Func>
+    void ForEachBlock(Func func) const {
+        T decoded[BLOCK_SIZE];
+        for (int b = 0; b < blockCount; b++) {
+            DecodeBlock(b, decoded);
+            func((const T*) decoded, BLOCK_SIZE);
+        }
+        if (pendingCount > 0) {
+            func((const T*) pending, pendingCount);
+        }
+    }
+
+    template <class Func>
+    T Reduce(Func func, T startValue) const {
+        T result = startValue;
+        ForEachBlock([&](const T* values, int count) {
+            for (int i = 0; i < count; i++) {
+                result = func(result, values[i]);
+            }
+        });
+        return result;
+    }
+
+    template <class Predicate>
+    PackedIntSequence<T>* Where(Predicate predicate) const {
+        PackedIntSequence<T>* result = new PackedIntSequence<T>();
+        ForEachBlock([&](const T* values, int count) {
+            for (int i = 0; i < count; i++) {
+                if (predicate(values[i])) {
+                    result->Append(values[i]);
+                }
+            }
+        });
+        return result;
+    }
+
+    // Uncompressed size over the bytes held, directory included.
+    double CompressionRatio() {
+        CollectionFootprint footprint = MemoryFootprint();
+        return footprint.TotalBytes() == 0 ? 1.0 : (double) sizeof(T) * GetSize() / footprint.TotalBytes();
+    }
+
+    // The payload is what the elements occupy compressed: the packed words
+    // and the values still waiting for a block.
+    CollectionFootprint MemoryFootprint() {
+        CollectionFootprint footprint;
+        footprint.payloadBytes = sizeof(uint64_t) * (size_t) wordCount + sizeof(T) * (size_t) pendingCount;
+        footprint.overheadBytes = sizeof(*this) - sizeof(T) * (size_t) pendingCount
+                                  + 2 * sizeof(DynamicArray<uint64_t>)
+                                  + sizeof(uint64_t) * (size_t) (words->GetSize() - wordCount)
+                                  + sizeof(Block) * (size_t) blocks->GetSize();
+        footprint.allocationCount = 4;
+        return footprint;
+    }
+};
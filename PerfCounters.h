@@ -0,0 +1,168 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cstring>
+#endif
+
+using namespace std;
+
+// Hardware counters for the timed region of a benchmark, read through Linux
+// perf_event_open. Every event is opened on its own so a PMU that lacks one
+// (or a container that forbids all of them) only loses what it cannot count;
+// on other platforms, or when nothing opens, Available() is false and the
+// harness reports wall-clock numbers only.
+//
+// The counters are inherited by threads the calling thread creates, so a
+// parallel benchmark is counted in full as long as its workers are started
+// after Start() and joined before Stop(): a worker's counts are added to
+// the totals when it exits.
+class PerfCounters {
+public:
+    struct Sample {
+        string name;
+        double value;
+    };
+
+private:
+    struct Counter {
+        string name;
+        int fd;
+        uint64_t total;
+        uint64_t enabledAtStart;
+        uint64_t runningAtStart;
+    };
+
+    vector<Counter> counters;
+
+#if defined(__linux__)
+    static int Open(uint32_t type, uint64_t config) {
+        perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = type;
+        attr.config = config;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.inherit = 1;
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        return (int) syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+    }
+
+    static uint64_t CacheConfig(uint64_t cache, uint64_t op, uint64_t result) {
+        return cache | (op << 8) | (result << 16);
+    }
+
+    void Add(const string& name, uint32_t type, uint64_t config) {
+        int fd = Open(type, config);
+        if (fd >= 0) {
+            counters.push_back({name, fd, 0, 0, 0});
+        }
+    }
+
+    // {count, time enabled, time running}; the times keep accumulating
+    // across PERF_EVENT_IOC_RESET, so intervals are measured as deltas.
+    static bool ReadRaw(int fd, uint64_t values[3]) {
+        return read(fd, values, 3 * sizeof(uint64_t)) == (ssize_t) (3 * sizeof(uint64_t));
+    }
+#endif
+
+public:
+    PerfCounters() {
+#if defined(__linux__)
+        Add("cycles", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+        Add("instructions", PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+        Add("l1d_misses", PERF_TYPE_HW_CACHE, CacheConfig(PERF_COUNT_HW_CACHE_L1D,
+            PERF_COUNT_HW_CACHE_OP_READ, PERF_COUNT_HW_CACHE_RESULT_MISS));
+        Add("llc_misses", PERF_TYPE_HW_CACHE, CacheConfig(PERF_COUNT_HW_CACHE_LL,
+            PERF_COUNT_HW_CACHE_OP_READ, PERF_COUNT_HW_CACHE_RESULT_MISS));
+        Add("branch_misses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+        Add("dtlb_misses", PERF_TYPE_HW_CACHE, CacheConfig(PERF_COUNT_HW_CACHE_DTLB,
+            PERF_COUNT_HW_CACHE_OP_READ, PERF_COUNT_HW_CACHE_RESULT_MISS));
+#endif
+    }
+
+    ~PerfCounters() {
+#if defined(__linux__)
+        for (Counter& counter : counters) {
+            close(counter.fd);
+        }
+#endif
+    }
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    bool Available() const {
+        return !counters.empty();
+    }
+
+    // Zeroes the accumulated totals before a new benchmark case.
+    void Reset() {
+        for (Counter& counter : counters) {
+            counter.total = 0;
+        }
+    }
+
+    void Start() {
+#if defined(__linux__)
+        for (Counter& counter : counters) {
+            uint64_t values[3] = {0, 0, 0};
+            ioctl(counter.fd, PERF_EVENT_IOC_RESET, 0);
+            ReadRaw(counter.fd, values);
+            counter.enabledAtStart = values[1];
+            counter.runningAtStart = values[2];
+            ioctl(counter.fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+#endif
+    }
+
+    // Stops counting and adds this interval to the running totals.
+    void Stop() {
+#if defined(__linux__)
+        for (Counter& counter : counters) {
+            ioctl(counter.fd, PERF_EVENT_IOC_DISABLE, 0);
+        }
+        // Scales for multiplexing when the PMU had to time-share a counter.
+        for (Counter& counter : counters) {
+            uint64_t values[3] = {0, 0, 0};
+            if (!ReadRaw(counter.fd, values)) {
+                continue;
+            }
+            uint64_t enabled = values[1] - counter.enabledAtStart;
+            uint64_t running = values[2] - counter.runningAtStart;
+            if (running > 0) {
+                counter.total += (uint64_t) ((double) values[0] * enabled / running);
+            }
+        }
+#endif
+    }
+
+    // Totals since the last Reset, plus IPC when both cycles and instructions
+    // were counted.
+    vector<Sample> Totals() const {
+        vector<Sample> samples;
+        double cycles = -1;
+        double instructions = -1;
+        for (const Counter& counter : counters) {
+            samples.push_back({counter.name, (double) counter.total});
+            if (counter.name == "cycles") {
+                cycles = (double) counter.total;
+            } else if (counter.name == "instructions") {
+                instructions = (double) counter.total;
+            }
+        }
+        if (cycles > 0 && instructions >= 0) {
+            samples.push_back({"ipc", instructions / cycles});
+        }
+        return samples;
+    }
+};
@@ -0,0 +1,12 @@
+#pragma once
+
+// Hint that `address` will be read soon, so the cache line is in flight
+// while the current one is still being compared. A no-op on compilers
+// without __builtin_prefetch.
+inline void Prefetch(const void* address) {
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_prefetch(address);
+#else
+    (void) address;
+#endif
+}
@@ -0,0 +1,379 @@
+#pragma once
+
+#include <climits>
+#include <functional>
+#include <stdexcept>
+
+#include "Sequence.h"
+#include "DynamicArray.h"
+#include "IndexOutOfRange.h"
+#include "Prefetch.h"
+
+// A run-length encoded sequence for data made of long runs of equal values
+// (status codes, category labels). Runs are a value and the index one past
+// their last element; those end indices are the prefix index that Get
+// binary searches, O(log runs). Adjacent runs always differ, so Append
+// either extends the last run or starts a new one, O(1) amortised.
+//
+// Map, Where, TryFind and Zip with another RleSequence call their callback
+// once per run rather than once per element, so callbacks must be pure.
+// Reduce has to fold every element, but ReduceRuns takes (accumulator,
+// value, length) for folds that can use the length, such as sums.
+//
+// An element is not stored on its own, only as part of its run, and a
+// write through a reference would have to split that run behind the
+// caller's back. The non-const operator[] therefore throws; Insert and
+// Slice change contents and keep the runs merged.
+template <class T>
+class RleSequence : public Sequence<T> {
+private:
+    DynamicArray<T>* values;
+    DynamicArray<int>* ends;
+    int runCount = 0;
+
+    void Reserve(int count) {
+        int capacity = values->GetSize();
+        if (count <= capacity) {
+            return;
+        }
+        int newCapacity = GrowCapacity(capacity, count, 8);
+        values->Resize(newCapacity);
+        ends->Resize(newCapacity);
+    }
+
+    int Start(int run) const {
+        return run == 0 ? 0 : (*ends)[run - 1];
+    }
+
+    // The run holding element `index`: the first run ending past it. The
+    // same branchless search as SortedSequence::UpperBoundIndex.
+    int RunOf(int index) const {
+        const int* first = &(*ends)[0];
+        const int* base = first;
+        int length = runCount;
+        while (length > 1) {
+            int half = length / 2;
+            Prefetch(base + half / 2);
+            Prefetch(base + half + half / 2);
+            base = index < base[half] ? base : base + half;
+            length -= half;
+        }
+        return (int) (base - first) + (index < *base ? 0 : 1);
+    }
+
+    // Opens `count` empty run slots at `run`; the caller fills them.
+    void OpenRuns(int run, int count) {
+        Reserve(runCount + count);
+        for (int r = runCount - 1; r >= run; r--) {
+            (*values)[r + count] = (*values)[r];
+            (*ends)[r + count] = (*ends)[r];
+        }
+        runCount += count;
+    }
+
+    void ShiftEnds(int fromRun, int delta) {
+        for (int r = fromRun; r < runCount; r++) {
+            (*ends)[r] += delta;
+        }
+    }
+
+    void CheckIndex(int index) const {
+        if (index < 0 || index >= GetSizeConst()) {
+            throw IndexOutOfRange();
+        }
+    }
+
+    int GetSizeConst() const {
+        return runCount == 0 ? 0 : (*ends)[runCount - 1];
+    }
+
+public:
+    RleSequence() {
+        values = new DynamicArray<T>(0);
+        ends = new DynamicArray<int>(0);
+    }
+
+    RleSequence(T* items, int count) : RleSequence() {
+        for (int i = 0; i < count; i++) {
+            Append(items[i]);
+        }
+    }
+
+    RleSequence(Sequence<T>* other) : RleSequence() {
+        for (int i = 0; i < other->GetSize(); i++) {
+            Append(other->Get(i));
+        }
+    }
+
+    RleSequence(RleSequence<T>* other) : RleSequence() {
+        Reserve(other->runCount);
+        for (int r = 0; r < other->runCount; r++) {
+            (*values)[r] = (*other->values)[r];
+            (*ends)[r] = (*other->ends)[r];
+        }
+        runCount = other->runCount;
+    }
+
+    ~RleSequence() {
+        delete ends;
+        delete values;
+    }
+
+    int RunCount() const {
+        return runCount;
+    }
+
+    // Appends `count` copies of `item`, merging with the last run.
+    void AppendRun(T item, int count) {
+        if (count < 0) {
+            throw IndexOutOfRange();
+        }
+        if (count == 0) {
+            return;
+        }
+        int size = GetSizeConst();
+        if (runCount > 0 && (*values)[runCount - 1] == item) {
+            (*ends)[runCount - 1] = size + count;
+            return;
+        }
+        Reserve(runCount + 1);
+        (*values)[runCount] = item;
+        (*ends)[runCount] = size + count;
+        runCount++;
+    }
+
+    // Calls func(value, length) for each run in order.
+    template <class Func>
+    void ForEachRun(Func func) const {
+        for (int r = 0; r < runCount; r++) {
+            func((*values)[r], (*ends)[r] - Start(r));
+        }
+    }
+
+    // Folds func(accumulator, value, length) over the runs.
+    template <class Func>
+    T ReduceRuns(Func func, T startValue) const {
+        T result = startValue;
+        for (int r = 0; r < runCount; r++) {
+            result = func(result, (*values)[r], (*ends)[r] - Start(r));
+        }
+        return result;
+    }
+
+    Sequence<T>* GetSubSequence(int startIndex, int endIndex) override {
+        if (startIndex < 0 || endIndex > GetSize() || startIndex > endIndex) {
+            throw IndexOutOfRange();
+        }
+        RleSequence<T>* subSequence = new RleSequence<T>();
+        if (startIndex == endIndex) {
+            return subSequence;
+        }
+        for (int r = RunOf(startIndex); r < runCount && Start(r) < endIndex; r++) {
+            int from = max(Start(r), startIndex);
+            int to = min((*ends)[r], endIndex);
+            subSequence->AppendRun((*values)[r], to - from);
+        }
+        return subSequence;
+    }
+
+    T GetFirst() override {
+        if (runCount == 0) {
+            throw IndexOutOfRange();
+        }
+        return (*values)[0];
+    }
+
+    T GetLast() override {
+        if (runCount == 0) {
+            throw IndexOutOfRange();
+        }
+        return (*values)[runCount - 1];
+    }
+
+    T Get(int index) override {
+        CheckIndex(index);
+        return (*values)[RunOf(index)];
+    }
+
+    int GetSize() override {
+        return GetSizeConst();
+    }
+
+    // Payload is one value per run; the end indices are overhead.
+    CollectionFootprint MemoryFootprint() override {
+        CollectionFootprint footprint;
+        footprint.payloadBytes = sizeof(T) * (size_t) runCount;
+        footprint.overheadBytes = sizeof(*this) + sizeof(DynamicArray<T>) + sizeof(DynamicArray<int>)
+                                  + sizeof(T) * (size_t) (values->GetSize() - runCount)
+                                  + sizeof(int) * (size_t) ends->GetSize();
+        footprint.allocationCount = 4;
+        return footprint;
+    }
+
+    T& operator[](int) override {
+        throw std::runtime_error("Operator[] not supported for run-length storage");
+    }
+
+    const T& operator[](int index) const override {
+        CheckIndex(index);
+        return (*values)[RunOf(index)];
+    }
+
+    bool TryGet(int index, T& value) override {
+        CheckIndex(index);
+        value = (*values)[RunOf(index)];
+        return true;
+    }
+
+    bool TryFind(function<bool(T)> predicate, T& value) override {
+        for (int r = 0; r < runCount; r++) {
+            if (predicate((*values)[r])) {
+                value = (*values)[r];
+                return true;
+            }
+        }
+        return false;
+    }
+
+    Sequence<T>* Map(function<T(T)> func) override {
+        RleSequence<T>* newSequence = new RleSequence<T>();
+        ForEachRun([&](const T& value, int length) { newSequence->AppendRun(func(value), length); });
+        return newSequence;
+    }
+
+    T Reduce(function<T(T, T)> func, T startValue) override {
+        T result = startValue;
+        for (int r = 0; r < runCount; r++) {
+            for (int i = Start(r); i < (*ends)[r]; i++) {
+                result = func(result, (*values)[r]);
+            }
+        }
+        return result;
+    }
+
+    Sequence<T>* Where(function<bool(T)> predicate) override {
+        RleSequence<T>* newSequence = new RleSequence<T>();
+        ForEachRun([&](const T& value, int length) {
+            if (predicate(value)) {
+                newSequence->AppendRun(value, length);
+            }
+        });
+        return newSequence;
+    }
+
+    // With another RleSequence, func runs once per stretch where neither
+    // side changes value.
+    Sequence<T>* Zip(Sequence<T>* other, function<T(T, T)> func) override {
+        RleSequence<T>* newSequence = new RleSequence<T>();
+        int length = min(GetSize(), other->GetSize());
+        RleSequence<T>* runs = dynamic_cast<RleSequence<T>*>(other);
+        if (runs == nullptr) {
+            for (int i = 0; i < length; i++) {
+                newSequence->AppendRun(func(Get(i), other->Get(i)), 1);
+            }
+            return newSequence;
+        }
+        int a = 0;
+        int b = 0;
+        int position = 0;
+        while (position < length) {
+            int end = min(min((*ends)[a], (*runs->ends)[b]), length);
+            newSequence->AppendRun(func((*values)[a], (*runs->values)[b]), end - position);
+            position = end;
+            a += (*ends)[a] == end ? 1 : 0;
+            b += (*runs->ends)[b] == end ? 1 : 0;
+        }
+        return newSequence;
+    }
+
+    Sequence<T>* Slice(int index, int count, Sequence<T>* replacement) override {
+        int size = GetSize();
+        if (index < 0) {
+            index = size + index;
+            if (index < 0) {
+                throw IndexOutOfRange();
+            }
+        }
+        if (index >= size || index + count > size) {
+            throw IndexOutOfRange();
+        }
+        RleSequence<T>* newSequence = dynamic_cast<RleSequence<T>*>(GetSubSequence(0, index));
+        if (replacement != nullptr) {
+            for (int i = 0; i < replacement->GetSize(); ++i) {
+                newSequence->Append(replacement->Get(i));
+            }
+        }
+        if (index + count < size) {
+            for (int r = RunOf(index + count); r < runCount; r++) {
+                int from = max(Start(r), index + count);
+                newSequence->AppendRun((*values)[r], (*ends)[r] - from);
+            }
+        }
+        return newSequence;
+    }
+
+    // Drops the delimiters and keeps the rest in order: a Where on the
+    // negated predicate, so the predicate runs once per run.
+    Sequence<T>* Split(function<bool(T)> predicate) override {
+        return Where([&predicate](T item) { return !predicate(item); });
+    }
+
+    void Append(T item) override {
+        AppendRun(item, 1);
+    }
+
+    void Prepend(T item) override {
+        Insert(item, 0);
+    }
+
+    // Extends the run at `index` (or the one ending there) when the value
+    // matches, otherwise splits it: O(runs) for the moved end indices.
+    void Insert(T item, int index) override {
+        int size = GetSize();
+        if (index < 0 || index > size) {
+            throw IndexOutOfRange();
+        }
+        if (index == size) {
+            Append(item);
+            return;
+        }
+        int run = RunOf(index);
+        int start = Start(run);
+        if ((*values)[run] == item) {
+            ShiftEnds(run, 1);
+            return;
+        }
+        if (index == start) {
+            if (run > 0 && (*values)[run - 1] == item) {
+                ShiftEnds(run - 1, 1);
+                return;
+            }
+            OpenRuns(run, 1);
+            (*values)[run] = item;
+            (*ends)[run] = index;
+            ShiftEnds(run, 1);
+            return;
+        }
+        // Split the run around the new element.
+        OpenRuns(run + 1, 2);
+        (*values)[run + 2] = (*values)[run];
+        (*ends)[run + 2] = (*ends)[run];
+        (*ends)[run] = index;
+        (*values)[run + 1] = item;
+        (*ends)[run + 1] = index;
+        ShiftEnds(run + 1, 1);
+    }
+
+    Sequence<T>* Concat(Sequence<T>* list) override {
+        RleSequence<T>* newSequence = new RleSequence<T>(this);
+        RleSequence<T>* runs = dynamic_cast<RleSequence<T>*>(list);
+        if (runs != nullptr) {
+            runs->ForEachRun([newSequence](const T& value, int length) { newSequence->AppendRun(value, length); });
+            return newSequence;
+        }
+        for (int i = 0; i < list->GetSize(); ++i) {
+            newSequence->Append(list->Get(i));
+        }
+        return newSequence;
+    }
+};
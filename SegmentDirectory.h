@@ -0,0 +1,154 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+using namespace std;
+
+// A fixed block of SLOTS elements that concurrent writers fill one slot
+// each, for the blocks of ConcurrentSegmentedList and ShardedArraySequence.
+//
+// Slots are raw storage, so T needs no default constructor: Construct
+// builds the element in place and then sets the slot's ready flag with a
+// release store, and a reader that sees the flag with an acquire load sees
+// the whole element. The destructor destroys only the slots that were
+// constructed. The storage of a block made with `new SlotBlock()` starts
+// zeroed.
+template <class T, int SLOTS>
+class SlotBlock {
+private:
+    alignas(T) unsigned char storage[sizeof(T) * SLOTS];
+    atomic<bool> ready[SLOTS];
+
+    T* Slot(int offset) {
+        return launder(reinterpret_cast<T*>(storage + sizeof(T) * offset));
+    }
+
+    const T* Slot(int offset) const {
+        return launder(reinterpret_cast<const T*>(storage + sizeof(T) * offset));
+    }
+
+public:
+    ~SlotBlock() {
+        if constexpr (!is_trivially_destructible_v<T>) {
+            for (int i = 0; i < SLOTS; i++) {
+                if (ready[i].load(memory_order_relaxed)) {
+                    Slot(i)->~T();
+                }
+            }
+        }
+    }
+
+    // Builds the element at `offset`, which no one else writes, and
+    // publishes it.
+    void Construct(int offset, T item) {
+        new (storage + sizeof(T) * offset) T(std::move(item));
+        ready[offset].store(true, memory_order_release);
+    }
+
+    bool IsReady(int offset) const {
+        return ready[offset].load(memory_order_acquire);
+    }
+
+    // Only for slots that are ready.
+    T& operator[](int offset) {
+        return *Slot(offset);
+    }
+
+    const T& operator[](int offset) const {
+        return *Slot(offset);
+    }
+};
+
+// Up to MAX_BLOCKS blocks, each allocated by whichever thread needs it
+// first and freed with the directory.
+//
+// The directory is two levels: a small fixed array of pages, each page
+// PAGE_SIZE block pointers allocated on first use. A container holding a
+// few blocks pays for one page instead of a pointer per possible block,
+// and the destructor and footprint only visit the pages that exist.
+// Pages and blocks are both published with a CAS, and the losers of a
+// race free their copy, so lookups never take a lock.
+template <class Block, int MAX_BLOCKS>
+class SegmentDirectory {
+private:
+    static const int PAGE_SIZE = 512;
+    static const int PAGES = (MAX_BLOCKS + PAGE_SIZE - 1) / PAGE_SIZE;
+
+    atomic<atomic<Block*>*> pages[PAGES] = {};
+    atomic<int> pageCount{0};
+    atomic<int> blockCount{0};
+
+    atomic<Block*>* PublishPage(int page) {
+        atomic<Block*>* entries = pages[page].load(memory_order_acquire);
+        if (entries != nullptr) {
+            return entries;
+        }
+        atomic<Block*>* created = new atomic<Block*>[PAGE_SIZE]();
+        if (pages[page].compare_exchange_strong(entries, created, memory_order_acq_rel, memory_order_acquire)) {
+            pageCount.fetch_add(1, memory_order_relaxed);
+            return created;
+        }
+        delete[] created;
+        return entries;
+    }
+
+public:
+    SegmentDirectory() = default;
+
+    SegmentDirectory(const SegmentDirectory&) = delete;
+    SegmentDirectory& operator=(const SegmentDirectory&) = delete;
+
+    // Not safe while other threads still use the directory.
+    ~SegmentDirectory() {
+        for (int p = 0; p < PAGES; p++) {
+            atomic<Block*>* entries = pages[p].load(memory_order_relaxed);
+            if (entries == nullptr) {
+                continue;
+            }
+            for (int i = 0; i < PAGE_SIZE; i++) {
+                delete entries[i].load(memory_order_relaxed);
+            }
+            delete[] entries;
+        }
+    }
+
+    // The block `index`, or nullptr if no one has published it yet.
+    Block* Get(int index) const {
+        atomic<Block*>* entries = pages[index / PAGE_SIZE].load(memory_order_acquire);
+        return entries == nullptr ? nullptr : entries[index % PAGE_SIZE].load(memory_order_acquire);
+    }
+
+    // The block `index`, allocated with `new Block()` if it does not exist.
+    Block* Publish(int index) {
+        atomic<Block*>& entry = PublishPage(index / PAGE_SIZE)[index % PAGE_SIZE];
+        Block* block = entry.load(memory_order_acquire);
+        if (block != nullptr) {
+            return block;
+        }
+        Block* created = new Block();
+        if (entry.compare_exchange_strong(block, created, memory_order_acq_rel, memory_order_acquire)) {
+            blockCount.fetch_add(1, memory_order_relaxed);
+            return created;
+        }
+        // Another thread published first; `block` now holds its block.
+        delete created;
+        return block;
+    }
+
+    int BlockCount() const {
+        return blockCount.load(memory_order_relaxed);
+    }
+
+    int PageCount() const {
+        return pageCount.load(memory_order_relaxed);
+    }
+
+    // The pages, which live outside the directory object itself.
+    size_t PageBytes() const {
+        return sizeof(atomic<Block*>) * PAGE_SIZE * (size_t) PageCount();
+    }
+};
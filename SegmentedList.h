@@ -0,0 +1,350 @@
+#pragma once
+
+#include <concepts>
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include "ICollection.h"
+#include "AllocationTracker.h"
+
+using namespace std;
+
+template <class T>
+class SegmentedList : public ICollection<T> {
+private:
+    static const size_t SEGMENT_SIZE = 32;
+
+    // Bounds of a segment's elements and a 64-bit Bloom filter of their
+    // hashes. Allocated per non-empty segment only once zone maps are
+    // enabled, so lists that never query by value pay one null pointer.
+    struct ZoneMap {
+        T min;
+        T max;
+        uint64_t bloom;
+    };
+
+    struct Segment {
+        T data[SEGMENT_SIZE];
+        size_t size = 0;
+        Segment* next = nullptr;
+        ZoneMap* zone = nullptr;
+
+        ~Segment() {
+            delete zone;
+            delete next;
+        }
+    };
+
+    Segment* head = nullptr;
+    Segment* tail = nullptr;
+    size_t totalSize = 0;
+    // The segment the last lookup ended in and the index of its first
+    // element, where the next lookup at or after it starts walking.
+    Segment* finger = nullptr;
+    size_t fingerStart = 0;
+    bool zoneMaps = false;
+
+    static constexpr bool Ordered = requires(const T& a, const T& b) {
+        { a < b } -> convertible_to<bool>;
+    };
+    static constexpr bool Hashable = requires(const T& a) {
+        { std::hash<T>()(a) } -> convertible_to<size_t>;
+    };
+
+    static AllocationStats& Stats() {
+        static AllocationStats& stats = AllocationTracker::Register("SegmentedList");
+        return stats;
+    }
+
+    static Segment* CreateSegment() {
+        AllocationTracker::OnAllocate(Stats(), sizeof(Segment));
+        return new Segment();
+    }
+
+    static void DestroySegment(Segment* segment) {
+        AllocationTracker::OnFree(Stats(), sizeof(Segment) + (segment->zone != nullptr ? sizeof(ZoneMap) : 0));
+        delete segment;
+    }
+
+    // Two bits of a 64-bit word per value.
+    static uint64_t BloomBits(const T& item) {
+        if constexpr (Hashable) {
+            uint64_t hash = (uint64_t) std::hash<T>()(item) * 0x9E3779B97F4A7C15ull;
+            return (1ull << (hash >> 58)) | (1ull << ((hash >> 52) & 63));
+        } else {
+            return ~0ull;
+        }
+    }
+
+    // Folds `item`, just stored in `segment`, into its zone map.
+    void Summarize(Segment* segment, const T& item) {
+        if constexpr (Ordered) {
+            if (!zoneMaps) {
+                return;
+            }
+            ZoneMap* zone = segment->zone;
+            if (zone == nullptr) {
+                Resummarize(segment);
+                return;
+            }
+            if (item < zone->min) {
+                zone->min = item;
+            } else if (zone->max < item) {
+                zone->max = item;
+            }
+            zone->bloom |= BloomBits(item);
+        }
+    }
+
+    // Rebuilds the zone map of `segment` from its elements, allocating it
+    // the first time the segment holds any.
+    void Resummarize(Segment* segment) {
+        if constexpr (Ordered) {
+            if (!zoneMaps || segment->size == 0) {
+                return;
+            }
+            const T& first = segment->data[0];
+            if (segment->zone == nullptr) {
+                AllocationTracker::OnAllocate(Stats(), sizeof(ZoneMap));
+                segment->zone = new ZoneMap{first, first, 0};
+            }
+            ZoneMap* zone = segment->zone;
+            zone->min = zone->max = first;
+            zone->bloom = BloomBits(first);
+            for (size_t i = 1; i < segment->size; i++) {
+                if (segment->data[i] < zone->min) {
+                    zone->min = segment->data[i];
+                } else if (zone->max < segment->data[i]) {
+                    zone->max = segment->data[i];
+                }
+                zone->bloom |= BloomBits(segment->data[i]);
+            }
+        }
+    }
+
+    // Starts from the tail, the finger or the head, whichever is the
+    // closest segment at or before `index`.
+    pair<Segment*, size_t> GetSegment(size_t index) {
+        if (index >= totalSize) {
+            throw IndexOutOfRange();
+        }
+        size_t tailStart = totalSize - tail->size;
+        if (index >= tailStart) {
+            return {tail, index - tailStart};
+        }
+        Segment* current = head;
+        size_t start = 0;
+        if (finger && fingerStart <= index) {
+            current = finger;
+            start = fingerStart;
+        }
+        while (index - start >= current->size) {
+            start += current->size;
+            current = current->next;
+        }
+        finger = current;
+        fingerStart = start;
+        return {current, index - start};
+    }
+
+public:
+    ~SegmentedList() {
+        while (head) {
+            Segment* next = head->next;
+            head->next = nullptr;
+            DestroySegment(head);
+            head = next;
+        }
+    }
+
+    // Starts keeping a zone map per segment (min, max and a Bloom filter),
+    // updated on every Append, Prepend and Insert, so the range and key
+    // queries below skip segments that cannot match. Without zone maps the
+    // queries still work, scanning every element.
+    void EnableZoneMaps() {
+        static_assert(Ordered, "zone maps need an operator< on T");
+        zoneMaps = true;
+        for (Segment* current = head; current; current = current->next) {
+            Resummarize(current);
+        }
+    }
+
+    bool ZoneMapsEnabled() const {
+        return zoneMaps;
+    }
+
+    // Elements with lo <= x <= hi, in order. Segments entirely outside the
+    // range are skipped and segments entirely inside it are copied without
+    // comparisons.
+    SegmentedList<T>* WhereInRange(const T& lo, const T& hi) {
+        static_assert(Ordered, "WhereInRange needs an operator< on T");
+        SegmentedList<T>* result = new SegmentedList<T>();
+        for (Segment* current = head; current; current = current->next) {
+            if (const ZoneMap* zone = current->zone) {
+                if (zone->max < lo || hi < zone->min) {
+                    continue;
+                }
+                if (!(zone->min < lo) && !(hi < zone->max)) {
+                    for (size_t i = 0; i < current->size; i++) {
+                        result->Append(current->data[i]);
+                    }
+                    continue;
+                }
+            }
+            for (size_t i = 0; i < current->size; i++) {
+                if (!(current->data[i] < lo) && !(hi < current->data[i])) {
+                    result->Append(current->data[i]);
+                }
+            }
+        }
+        return result;
+    }
+
+    // Index of the first element greater than `value`, -1 if none; skips
+    // segments whose maximum is not greater.
+    int FindFirstGreaterThan(const T& value) {
+        static_assert(Ordered, "FindFirstGreaterThan needs an operator< on T");
+        size_t offset = 0;
+        for (Segment* current = head; current; offset += current->size, current = current->next) {
+            if (current->zone != nullptr && !(value < current->zone->max)) {
+                continue;
+            }
+            for (size_t i = 0; i < current->size; i++) {
+                if (value < current->data[i]) {
+                    return (int) (offset + i);
+                }
+            }
+        }
+        return -1;
+    }
+
+    // Index of the first element equal to `key`, -1 if none; skips
+    // segments whose bounds exclude it or whose Bloom filter lacks it.
+    int IndexOf(const T& key) {
+        size_t offset = 0;
+        uint64_t bits = BloomBits(key);
+        for (Segment* current = head; current; offset += current->size, current = current->next) {
+            if constexpr (Ordered) {
+                const ZoneMap* zone = current->zone;
+                if (zone != nullptr && ((zone->bloom & bits) != bits || key < zone->min || zone->max < key)) {
+                    continue;
+                }
+            }
+            for (size_t i = 0; i < current->size; i++) {
+                if (current->data[i] == key) {
+                    return (int) (offset + i);
+                }
+            }
+        }
+        return -1;
+    }
+
+    T Get(int index) override {
+        pair<Segment*, size_t> segmentInfo = GetSegment(index);
+        return segmentInfo.first->data[segmentInfo.second];
+    }
+
+    int GetSize() override {
+        return totalSize;
+    }
+
+    // Partially filled segments show up as overhead: every segment reserves
+    // SEGMENT_SIZE slots whether or not they are used. Zone maps count as
+    // overhead too.
+    CollectionFootprint MemoryFootprint() override {
+        size_t segments = 0;
+        size_t zones = 0;
+        for (Segment* current = head; current; current = current->next) {
+            segments++;
+            zones += current->zone != nullptr ? 1 : 0;
+        }
+        CollectionFootprint footprint;
+        footprint.payloadBytes = sizeof(T) * totalSize;
+        footprint.overheadBytes = sizeof(*this) + sizeof(Segment) * segments + sizeof(ZoneMap) * zones
+                                  - footprint.payloadBytes;
+        footprint.allocationCount = segments + zones;
+        return footprint;
+    }
+
+    void Append(T item) override {
+        if (!head) {
+            head = tail = CreateSegment();
+        }
+
+        Segment* current = tail;
+        if (current->size == SEGMENT_SIZE) {
+            current->next = CreateSegment();
+            current = tail = current->next;
+        }
+
+        current->data[current->size++] = item;
+        totalSize++;
+        Summarize(current, item);
+    }
+
+    void Prepend(T item) override {
+        if (!head) {
+            head = tail = CreateSegment();
+        }
+        if (head->size == SEGMENT_SIZE) {
+            Segment* newSegment = CreateSegment();
+            newSegment->next = head;
+            head = newSegment;
+        }
+        for (size_t i = head->size; i > 0; --i) {
+            head->data[i] = head->data[i - 1];
+        }
+        head->data[0] = item;
+        head->size++;
+        totalSize++;
+        if (finger && finger != head) {
+            fingerStart++;
+        }
+        Summarize(head, item);
+    }
+
+    void Insert(T item, int index) override {
+        if (index == 0) {
+            Prepend(item);
+            return;
+        }
+        if ((size_t) index == totalSize) {
+            Append(item);
+            return;
+        }
+        pair<Segment*, size_t> segmentInfo = GetSegment(index);
+        Segment* segment = segmentInfo.first;
+        size_t offset = segmentInfo.second;
+        if (segment->size == SEGMENT_SIZE) {
+            Segment* newSegment = CreateSegment();
+            size_t moveCount = SEGMENT_SIZE / 2;
+            size_t startIndex = SEGMENT_SIZE - moveCount;
+            for (size_t i = 0; i < moveCount; ++i) {
+                newSegment->data[i] = segment->data[startIndex + i];
+            }
+            newSegment->size = moveCount;
+            segment->size -= moveCount;
+            newSegment->next = segment->next;
+            segment->next = newSegment;
+            if (tail == segment) {
+                tail = newSegment;
+            }
+            Resummarize(segment);
+            Resummarize(newSegment);
+            if (offset >= segment->size) {
+                offset -= segment->size;
+                segment = newSegment;
+            }
+        }
+        for (size_t i = segment->size; i > offset; --i) {
+            segment->data[i] = segment->data[i - 1];
+        }
+        segment->data[offset] = item;
+        segment->size++;
+        totalSize++;
+        Summarize(segment, item);
+        // Segments after this one moved up by one.
+        finger = segment;
+        fingerStart = index - offset;
+    }
+};
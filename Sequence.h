@@ -0,0 +1,41 @@
+#pragma once
+
+#include <functional>
+#include "Generator.h"
+#include "ICollection.h"
+
+using namespace std;
+
+template <class T>
+class Sequence : public ICollection<T>{
+public:
+    virtual ~Sequence() = default;
+    virtual T GetFirst() = 0;
+    virtual T GetLast() = 0;
+    virtual T Get(int index) = 0;
+    virtual Sequence<T>* GetSubSequence(int startIndex, int endIndex) = 0;
+    virtual int GetSize() = 0;
+    virtual void Append(T item) = 0;
+    virtual void Prepend(T item) = 0;
+    virtual void Insert (T item, int index) = 0;
+    virtual Sequence<T>* Concat(Sequence<T>* list) = 0;
+    virtual Sequence<T>* Map(function<T(T)> func) = 0;
+    virtual T Reduce(function<T(T, T)> func, T startValue) = 0;
+    virtual Sequence<T>* Where(function<bool(T)> predicate) = 0;
+    virtual Sequence<T>* Zip(Sequence<T>* other, function<T(T, T)> func) = 0;
+    virtual Sequence<T>* Slice(int index, int count, Sequence<T>* replacement) = 0;
+    virtual Sequence<T>* Split(function<bool(T)> predicate) =0;
+    virtual bool TryGet(int index, T& value) = 0;
+    virtual bool TryFind(function<bool(T)> predicate, T& value) = 0;
+    virtual T& operator[](int index) = 0;
+    virtual const T& operator[](int index) const = 0;
+
+    // The elements in order, one Get at a time, for streaming Map/Where/Zip
+    // (see Generator.h). The sequence must outlive the generator and not
+    // change while it runs.
+    virtual Generator<T> AsGenerator() {
+        for (int i = 0; i < GetSize(); i++) {
+            co_yield Get(i);
+        }
+    }
+};
@@ -0,0 +1,408 @@
+#pragma once
+
+#include <bit>
+#include <climits>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "Sequence.h"
+#include "DynamicArray.h"
+#include "MutableArraySequence.h"
+#include "ImmutableArraySequence.h"
+#include "AdaptiveSequence.h"
+
+using namespace std;
+
+// Binary sequence format, version 1:
+//
+//   offset 0   SequenceFileHeader (32 bytes, host byte order, see flags)
+//   offset 32  zero padding up to payloadOffset (a multiple of 64)
+//   payload    trivially copyable T: count * elementSize raw bytes, so the
+//              payload can be read in one call or mapped in place;
+//              std::string: count records of uint32 length + bytes.
+//
+// Readers reject other magics, newer versions, a different element type or
+// size and files written with the other byte order.
+
+class SerializationError : public runtime_error {
+public:
+    explicit SerializationError(const string& message) : runtime_error("Serialization: " + message) {}
+};
+
+enum class SerialTypeId : uint16_t {
+    Raw = 0,
+    Int8 = 1, UInt8 = 2, Int16 = 3, UInt16 = 4,
+    Int32 = 5, UInt32 = 6, Int64 = 7, UInt64 = 8,
+    Float32 = 9, Float64 = 10, Bool = 11, String = 12,
+};
+
+struct SequenceFileHeader {
+    char magic[8];
+    uint16_t version;
+    uint16_t typeId;
+    // sizeof(T) for fixed-size elements, 0 for length-prefixed strings.
+    uint32_t elementSize;
+    uint64_t count;
+    uint32_t payloadOffset;
+    uint32_t flags;
+};
+
+static_assert(sizeof(SequenceFileHeader) == 32, "SequenceFileHeader must stay 32 bytes");
+
+const char SEQUENCE_MAGIC[8] = {'L', 'A', 'B', '2', 'S', 'E', 'Q', '\0'};
+const uint16_t SEQUENCE_FORMAT_VERSION = 1;
+const uint32_t SEQUENCE_PAYLOAD_ALIGNMENT = 64;
+const uint32_t SEQUENCE_FLAG_BIG_ENDIAN = 1;
+
+// Type id written for T. Trivially copyable types without a dedicated id
+// (records, enums, ...) are stored as Raw and matched on elementSize.
+template <class T>
+constexpr SerialTypeId SerialTypeOf() {
+    if constexpr (is_same_v<T, string>) {
+        return SerialTypeId::String;
+    } else if constexpr (is_same_v<T, bool>) {
+        return SerialTypeId::Bool;
+    } else if constexpr (is_floating_point_v<T> && sizeof(T) == 4) {
+        return SerialTypeId::Float32;
+    } else if constexpr (is_floating_point_v<T> && sizeof(T) == 8) {
+        return SerialTypeId::Float64;
+    } else if constexpr (is_integral_v<T>) {
+        constexpr bool isSigned = is_signed_v<T>;
+        if constexpr (sizeof(T) == 1) {
+            return isSigned ? SerialTypeId::Int8 : SerialTypeId::UInt8;
+        } else if constexpr (sizeof(T) == 2) {
+            return isSigned ? SerialTypeId::Int16 : SerialTypeId::UInt16;
+        } else if constexpr (sizeof(T) == 4) {
+            return isSigned ? SerialTypeId::Int32 : SerialTypeId::UInt32;
+        } else {
+            return isSigned ? SerialTypeId::Int64 : SerialTypeId::UInt64;
+        }
+    } else {
+        return SerialTypeId::Raw;
+    }
+}
+
+template <class T>
+constexpr bool IsSerializable() {
+    return is_same_v<T, string> || is_trivially_copyable_v<T>;
+}
+
+// Raw pointer to the elements when the sequence keeps them in one array,
+// nullptr otherwise (lists, AdaptiveSequence in list mode, empty sequences).
+template <class T>
+T* ContiguousData(Sequence<T>* sequence) {
+    if (sequence->GetSize() == 0) {
+        return nullptr;
+    }
+    if (dynamic_cast<MutableArraySequence<T>*>(sequence) != nullptr
+        || dynamic_cast<ImmutableArraySequence<T>*>(sequence) != nullptr) {
+        return &(*sequence)[0];
+    }
+    AdaptiveSequence<T>* adaptive = dynamic_cast<AdaptiveSequence<T>*>(sequence);
+    if (adaptive != nullptr && adaptive->IsArray()) {
+        return &(*sequence)[0];
+    }
+    return nullptr;
+}
+
+template <class T>
+SequenceFileHeader MakeSequenceHeader(uint64_t count) {
+    SequenceFileHeader header;
+    memcpy(header.magic, SEQUENCE_MAGIC, sizeof(header.magic));
+    header.version = SEQUENCE_FORMAT_VERSION;
+    header.typeId = (uint16_t) SerialTypeOf<T>();
+    header.elementSize = is_same_v<T, string> ? 0 : (uint32_t) sizeof(T);
+    header.count = count;
+    header.payloadOffset = SEQUENCE_PAYLOAD_ALIGNMENT;
+    header.flags = endian::native == endian::big ? SEQUENCE_FLAG_BIG_ENDIAN : 0;
+    return header;
+}
+
+// Header plus padding up to the payload.
+inline void WriteSequenceHeader(ostream& out, const SequenceFileHeader& header) {
+    out.write((const char*) &header, sizeof(header));
+    char padding[SEQUENCE_PAYLOAD_ALIGNMENT] = {};
+    out.write(padding, header.payloadOffset - sizeof(header));
+}
+
+template <class T>
+void Serialize(Sequence<T>* sequence, ostream& out) {
+    static_assert(IsSerializable<T>(), "Serialize needs std::string or a trivially copyable T");
+    WriteSequenceHeader(out, MakeSequenceHeader<T>((uint64_t) sequence->GetSize()));
+
+    int count = sequence->GetSize();
+    if constexpr (is_same_v<T, string>) {
+        for (int i = 0; i < count; i++) {
+            string item = sequence->Get(i);
+            if (item.size() > UINT32_MAX) {
+                throw SerializationError("string too long for its 32-bit length prefix");
+            }
+            uint32_t length = (uint32_t) item.size();
+            out.write((const char*) &length, sizeof(length));
+            out.write(item.data(), length);
+        }
+    } else {
+        T* contiguous = ContiguousData(sequence);
+        if (contiguous != nullptr) {
+            out.write((const char*) contiguous, (streamsize) (sizeof(T) * (size_t) count));
+        } else {
+            const int chunk = 4096;
+            vector<T> buffer;
+            buffer.reserve(chunk);
+            for (int i = 0; i < count; i++) {
+                buffer.push_back(sequence->Get(i));
+                if ((int) buffer.size() == chunk || i == count - 1) {
+                    out.write((const char*) buffer.data(), (streamsize) (sizeof(T) * buffer.size()));
+                    buffer.clear();
+                }
+            }
+        }
+    }
+    if (!out) {
+        throw SerializationError("write failed");
+    }
+}
+
+template <class T>
+void SerializeToFile(Sequence<T>* sequence, const string& path) {
+    ofstream out(path, ios::binary | ios::trunc);
+    if (!out) {
+        throw SerializationError("cannot open " + path);
+    }
+    Serialize(sequence, out);
+}
+
+// Reads and validates the header for T and leaves `in` at the payload.
+template <class T>
+SequenceFileHeader ReadSequenceHeader(istream& in) {
+    SequenceFileHeader header;
+    if (!in.read((char*) &header, sizeof(header))) {
+        throw SerializationError("truncated header");
+    }
+    if (memcmp(header.magic, SEQUENCE_MAGIC, sizeof(header.magic)) != 0) {
+        throw SerializationError("not a sequence file");
+    }
+    if (header.version > SEQUENCE_FORMAT_VERSION) {
+        throw SerializationError("unsupported format version " + to_string(header.version));
+    }
+    if ((header.flags & SEQUENCE_FLAG_BIG_ENDIAN) != (endian::native == endian::big ? SEQUENCE_FLAG_BIG_ENDIAN : 0)) {
+        throw SerializationError("written with the other byte order");
+    }
+    uint32_t elementSize = is_same_v<T, string> ? 0 : (uint32_t) sizeof(T);
+    if (header.typeId != (uint16_t) SerialTypeOf<T>() || header.elementSize != elementSize) {
+        throw SerializationError("element type does not match");
+    }
+    if (header.payloadOffset < sizeof(header)
+        || !in.ignore(header.payloadOffset - sizeof(header))) {
+        throw SerializationError("truncated header padding");
+    }
+    return header;
+}
+
+// Bytes between the read position and the end of the stream, or -1 for
+// streams that cannot seek (pipes).
+inline long long RemainingBytes(istream& in) {
+    streampos position = in.tellg();
+    if (position == streampos(-1) || !in.seekg(0, ios::end)) {
+        in.clear();
+        return -1;
+    }
+    streampos end = in.tellg();
+    in.seekg(position);
+    return (long long) (end - position);
+}
+
+// Reads a string of `length` bytes in bounded chunks, so a corrupt length
+// from a stream that cannot be measured fails once the data runs out
+// instead of allocating the whole length up front.
+inline void ReadStringChunked(istream& in, string& item, uint32_t length) {
+    const uint32_t CHUNK = 64u << 10;
+    item.clear();
+    uint32_t done = 0;
+    while (done < length) {
+        uint32_t size = length - done < CHUNK ? length - done : CHUNK;
+        item.resize(done + size);
+        if (!in.read(&item[done], size)) {
+            throw SerializationError("truncated payload");
+        }
+        done += size;
+    }
+}
+
+template <class T>
+void ReadPayload(istream& in, T* items, int count) {
+    if constexpr (is_same_v<T, string>) {
+        // Measured once: a seek per string would drop the stream's buffer.
+        long long remaining = RemainingBytes(in);
+        for (int i = 0; i < count; i++) {
+            uint32_t length = 0;
+            if (!in.read((char*) &length, sizeof(length))) {
+                throw SerializationError("truncated payload");
+            }
+            if (remaining < 0) {
+                ReadStringChunked(in, items[i], length);
+                continue;
+            }
+            remaining -= sizeof(length);
+            if (length > remaining) {
+                throw SerializationError("string length exceeds the payload");
+            }
+            remaining -= length;
+            items[i].resize(length);
+            if (length > 0 && !in.read(&items[i][0], length)) {
+                throw SerializationError("truncated payload");
+            }
+        }
+    } else if (count > 0 && !in.read((char*) items, (streamsize) (sizeof(T) * (size_t) count))) {
+        throw SerializationError("truncated payload");
+    }
+}
+
+// In-memory sequences are indexed by int.
+inline int CheckedCount(const SequenceFileHeader& header) {
+    if (header.count > (uint64_t) INT_MAX) {
+        throw SerializationError("too many elements for an in-memory sequence");
+    }
+    return (int) header.count;
+}
+
+// A count from the header has to fit in what is left of the stream before
+// anything is allocated for it, so a corrupt count fails here rather than
+// in a huge allocation. Each element takes at least sizeof(T) bytes, or
+// its 4-byte length prefix for strings. Streams that cannot seek (pipes)
+// are not checked; their payload read fails once it runs out instead.
+template <class T>
+void CheckCountFits(istream& in, int count) {
+    long long remaining = RemainingBytes(in);
+    if (remaining < 0) {
+        return;
+    }
+    uint64_t minimumBytes = is_same_v<T, string> ? sizeof(uint32_t) : sizeof(T);
+    if ((uint64_t) count * minimumBytes > (uint64_t) remaining) {
+        throw SerializationError("element count exceeds the payload");
+    }
+}
+
+// Reads a sequence written by Serialize into a new S<T>, e.g.
+// Deserialize<MutableListSequence, int>(in). Array sequences receive the
+// payload with a single read straight into their storage; the others are
+// built from one buffered read through their (items, count) constructor.
+template <template <class> class S, class T>
+S<T>* Deserialize(istream& in) {
+    static_assert(IsSerializable<T>(), "Deserialize needs std::string or a trivially copyable T");
+    SequenceFileHeader header = ReadSequenceHeader<T>(in);
+    int count = CheckedCount(header);
+    CheckCountFits<T>(in, count);
+    if constexpr (is_constructible_v<S<T>, DynamicArray<T>*>) {
+        DynamicArray<T>* array = new DynamicArray<T>(count);
+        try {
+            ReadPayload(in, count > 0 ? &(*array)[0] : (T*) nullptr, count);
+        } catch (...) {
+            delete array;
+            throw;
+        }
+        return new S<T>(array);
+    } else {
+        vector<T> items(count);
+        ReadPayload(in, items.data(), count);
+        return new S<T>(items.data(), count);
+    }
+}
+
+template <template <class> class S, class T>
+S<T>* DeserializeFromFile(const string& path) {
+    ifstream in(path, ios::binary);
+    if (!in) {
+        throw SerializationError("cannot open " + path);
+    }
+    return Deserialize<S, T>(in);
+}
+
+// Adopts the payload of a file written by Serialize as the storage of an
+// ImmutableArraySequence: the header is read, the payload is mapped
+// copy-on-write and no element is touched until it is accessed.
+template <class T>
+ImmutableArraySequence<T>* MapImmutableArraySequence(const string& path) {
+    static_assert(is_trivially_copyable_v<T>, "only fixed-size payloads can be mapped");
+    ifstream in(path, ios::binary);
+    if (!in) {
+        throw SerializationError("cannot open " + path);
+    }
+    SequenceFileHeader header = ReadSequenceHeader<T>(in);
+    in.close();
+    return new ImmutableArraySequence<T>(
+        DynamicArray<T>::MapView(path, header.payloadOffset, CheckedCount(header)));
+}
+
+// For passes that read one sequence file while writing another: opening
+// the writer truncates its file, so an output that is the input under
+// another name (a relative path, a link) would be emptied before it is
+// read. An output that does not exist yet is always distinct.
+inline void CheckDistinctFiles(const string& inputPath, const string& outputPath) {
+    error_code ignored;
+    if (filesystem::equivalent(inputPath, outputPath, ignored)) {
+        throw SerializationError(outputPath + " is the input file " + inputPath);
+    }
+}
+
+// Writes a fixed-size-element sequence file incrementally, for producers
+// that never hold the whole sequence (streaming passes, sort runs). The
+// count in the header is patched in by Close().
+template <class T>
+class SequenceFileWriter {
+private:
+    ofstream out;
+    string path;
+    uint64_t count = 0;
+    bool closed = false;
+
+public:
+    explicit SequenceFileWriter(const string& path) : out(path, ios::binary | ios::trunc), path(path) {
+        static_assert(is_trivially_copyable_v<T>, "SequenceFileWriter needs a trivially copyable T");
+        if (!out) {
+            throw SerializationError("cannot open " + path);
+        }
+        WriteSequenceHeader(out, MakeSequenceHeader<T>(0));
+    }
+
+    ~SequenceFileWriter() {
+        if (!closed) {
+            try {
+                Close();
+            } catch (...) {
+            }
+        }
+    }
+
+    void Write(const T* items, size_t itemCount) {
+        out.write((const char*) items, (streamsize) (sizeof(T) * itemCount));
+        count += itemCount;
+    }
+
+    void Write(const T& item) {
+        Write(&item, 1);
+    }
+
+    uint64_t Count() const {
+        return count;
+    }
+
+    void Close() {
+        closed = true;
+        SequenceFileHeader header = MakeSequenceHeader<T>(count);
+        out.seekp(0);
+        out.write((const char*) &header, sizeof(header));
+        out.close();
+        if (!out) {
+            throw SerializationError("write failed for " + path);
+        }
+    }
+};
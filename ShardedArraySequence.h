@@ -0,0 +1,234 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "CollectionFootprint.h"
+#include "DynamicArray.h"
+#include "IndexOutOfRange.h"
+#include "MutableArraySequence.h"
+#include "SegmentDirectory.h"
+#include "Sorting.h"
+
+using namespace std;
+
+// A mutable array sequence many threads read, update by index and append
+// to at once. Storage is split into fixed shards of SHARD_SIZE elements,
+// each behind its own reader/writer lock, so threads working on different
+// shards never wait for each other and readers of one shard only wait
+// for its writers.
+//
+// Append and AppendRange reserve their slots with one fetch-add on the
+// size counter, a whole chunk at a time for AppendRange, then construct
+// them without the shard locks: reserved slots belong to the appender
+// alone, and each is published by its ready flag as in
+// ConcurrentSegmentedList. GetSize() is the watermark below which every
+// slot is ready: an appended element joins it once every slot reserved
+// before it has been written, so indices below GetSize() are always
+// written.
+//
+// Map and Reduce run over the shards in parallel, each shard under its
+// read lock. They see every shard at some moment during the call, not the
+// whole sequence at a single instant.
+template <class T>
+class ShardedArraySequence {
+public:
+    static const int SHARD_SIZE = 1 << 14;
+
+private:
+    static const int MAX_SHARDS = INT_MAX / SHARD_SIZE + 1;
+    // Bulk operations on fewer elements run on the calling thread.
+    static const int PARALLEL_THRESHOLD = 1 << 16;
+    static const size_t CACHE_LINE = 64;
+
+    struct Shard {
+        shared_mutex lock;
+        SlotBlock<T, SHARD_SIZE> slots;
+    };
+
+    SegmentDirectory<Shard, MAX_SHARDS> shards;
+    alignas(CACHE_LINE) atomic<long long> reserved{0};
+    alignas(CACHE_LINE) atomic<long long> committed{0};
+
+    bool IsReady(long long index) const {
+        const Shard* shard = shards.Get((int) (index / SHARD_SIZE));
+        return shard != nullptr && shard->slots.IsReady((int) (index % SHARD_SIZE));
+    }
+
+    Shard* ShardOf(int index) {
+        if (index < 0 || (index >= committed.load(memory_order_acquire) && index >= GetSize())) {
+            throw IndexOutOfRange();
+        }
+        return shards.Get(index / SHARD_SIZE);
+    }
+
+    long long Reserve(int count) {
+        long long start = reserved.fetch_add(count, memory_order_relaxed);
+        if (start + count > INT_MAX) {
+            throw std::length_error("ShardedArraySequence is full");
+        }
+        return start;
+    }
+
+    // Constructs items[0, count) in the reserved slots from `start` on.
+    // Nothing reaches a slot before Construct marks it ready, so no lock.
+    void Fill(long long start, const T* items, int count) {
+        int done = 0;
+        while (done < count) {
+            long long index = start + done;
+            Shard* shard = shards.Publish((int) (index / SHARD_SIZE));
+            int offset = (int) (index % SHARD_SIZE);
+            int length = min(count - done, SHARD_SIZE - offset);
+            for (int i = 0; i < length; i++) {
+                shard->slots.Construct(offset + i, items[done + i]);
+            }
+            done += length;
+        }
+    }
+
+    // Calls func(shard, from, to) for the shards covering [0, size), on up
+    // to SortThreads() threads for large sequences.
+    template <class Func>
+    void ForEachShard(int size, Func func) {
+        int count = (size + SHARD_SIZE - 1) / SHARD_SIZE;
+        int threads = size >= PARALLEL_THRESHOLD ? min(SortThreads(), count) : 1;
+        atomic<int> next{0};
+        auto work = [&]() {
+            for (int s = next.fetch_add(1); s < count; s = next.fetch_add(1)) {
+                int from = s * SHARD_SIZE;
+                int to = size - from < SHARD_SIZE ? size : from + SHARD_SIZE;
+                func(shards.Get(s), from, to);
+            }
+        };
+        vector<thread> workers;
+        for (int t = 1; t < threads; t++) {
+            workers.emplace_back(work);
+        }
+        work();
+        for (thread& worker : workers) {
+            worker.join();
+        }
+    }
+
+public:
+    ShardedArraySequence() = default;
+
+    ShardedArraySequence(const T* items, int count) {
+        AppendRange(items, count);
+    }
+
+    ShardedArraySequence(const ShardedArraySequence&) = delete;
+    ShardedArraySequence& operator=(const ShardedArraySequence&) = delete;
+
+    // Not safe while other threads still use the sequence.
+    ~ShardedArraySequence() = default;
+
+    // Elements whose appends, and all appends before them, have finished.
+    // Moves the watermark over every slot that has become ready since the
+    // last call.
+    int GetSize() {
+        long long mark = committed.load(memory_order_acquire);
+        long long end = reserved.load(memory_order_acquire);
+        long long limit = end < INT_MAX ? end : INT_MAX;
+        long long reached = mark;
+        while (reached < limit && IsReady(reached)) {
+            reached++;
+        }
+        while (mark < reached && !committed.compare_exchange_weak(mark, reached, memory_order_release, memory_order_acquire)) {
+        }
+        return (int) max(mark, reached);
+    }
+
+    T Get(int index) {
+        Shard* shard = ShardOf(index);
+        shared_lock<shared_mutex> guard(shard->lock);
+        return shard->slots[index % SHARD_SIZE];
+    }
+
+    void Set(int index, T item) {
+        Shard* shard = ShardOf(index);
+        unique_lock<shared_mutex> guard(shard->lock);
+        shard->slots[index % SHARD_SIZE] = std::move(item);
+    }
+
+    // Replaces the element with func(element) under its shard's write lock,
+    // so concurrent updates of one index do not lose each other.
+    template <class Func>
+    void Update(int index, Func func) {
+        Shard* shard = ShardOf(index);
+        unique_lock<shared_mutex> guard(shard->lock);
+        T& item = shard->slots[index % SHARD_SIZE];
+        item = func(item);
+    }
+
+    // Returns the index `item` was appended at.
+    int Append(T item) {
+        long long start = Reserve(1);
+        Fill(start, &item, 1);
+        return (int) start;
+    }
+
+    // Appends items[0, count) contiguously with a single reservation and
+    // returns the index of the first.
+    int AppendRange(const T* items, int count) {
+        if (count < 0) {
+            throw IndexOutOfRange();
+        }
+        long long start = Reserve(count);
+        Fill(start, items, count);
+        return (int) start;
+    }
+
+    MutableArraySequence<T>* Map(function<T(T)> func) {
+        int size = GetSize();
+        DynamicArray<T>* mapped = new DynamicArray<T>(size);
+        ForEachShard(size, [&](Shard* shard, int from, int to) {
+            shared_lock<shared_mutex> guard(shard->lock);
+            for (int i = from; i < to; i++) {
+                (*mapped)[i] = func(shard->slots[i - from]);
+            }
+        });
+        return new MutableArraySequence<T>(mapped);
+    }
+
+    // Folds each shard on its own, then the shard results in order, so
+    // `func` must be associative; the result then equals a left fold.
+    T Reduce(function<T(T, T)> func, T startValue) {
+        int size = GetSize();
+        if (size == 0) {
+            return startValue;
+        }
+        int count = (size + SHARD_SIZE - 1) / SHARD_SIZE;
+        vector<optional<T>> partial(count);
+        ForEachShard(size, [&](Shard* shard, int from, int to) {
+            shared_lock<shared_mutex> guard(shard->lock);
+            T result = shard->slots[0];
+            for (int i = from + 1; i < to; i++) {
+                result = func(result, shard->slots[i - from]);
+            }
+            partial[from / SHARD_SIZE] = result;
+        });
+        T result = startValue;
+        for (int s = 0; s < count; s++) {
+            result = func(result, *partial[s]);
+        }
+        return result;
+    }
+
+    CollectionFootprint MemoryFootprint() {
+        size_t allocated = (size_t) shards.BlockCount();
+        CollectionFootprint footprint;
+        footprint.payloadBytes = sizeof(T) * (size_t) GetSize();
+        footprint.overheadBytes = sizeof(*this) + shards.PageBytes() + sizeof(Shard) * allocated
+                                  - footprint.payloadBytes;
+        footprint.allocationCount = allocated + (size_t) shards.PageCount();
+        return footprint;
+    }
+};
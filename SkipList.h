@@ -0,0 +1,343 @@
+#pragma once
+
+#include <bit>
+#include <cstdint>
+#include <functional>
+#include <new>
+#include <vector>
+
+#include "ICollection.h"
+#include "AllocationTracker.h"
+#include "IndexOutOfRange.h"
+#include "Sorting.h"
+
+// An indexable skip list: a linked list whose nodes also carry links that
+// skip ahead, each with its width (how many positions it spans), so
+// Get, Insert and RemoveAt find position i in expected O(log n) instead of
+// walking from the head. Node heights are geometric with p = 1/4, about
+// 1.33 links per node on average.
+//
+// It has LinkedList's interface and can back a MutableListSequence:
+//
+//   MutableListSequence<int, SkipList<int>> sequence;
+//
+// The last node of every level is remembered, so Append links the new node
+// in O(its height), O(1) expected.
+template <class T>
+class SkipList : public ICollection<T> {
+private:
+    static const int MAX_LEVEL = 32;
+
+    struct Node;
+
+    struct Link {
+        Node* next;
+        int width;   // positions from this node to `next`; unused when null
+    };
+
+    // The links of a node follow it in the same allocation.
+    struct alignas(Link) Node {
+        T data;
+        int height;
+
+        Node(const T& data, int height) : data(data), height(height) {}
+
+        Link* Links() {
+            return reinterpret_cast<Link*>(this + 1);
+        }
+    };
+
+    // Positions count from the head sentinel at 0: element i is at i + 1.
+    Node* head;
+    Node* last[MAX_LEVEL];
+    int lastPosition[MAX_LEVEL];
+    int level = 1;
+    int size = 0;
+    long long linkCount = 0;
+    uint64_t seed = 0x9E3779B97F4A7C15ull;
+
+    static AllocationStats& Stats() {
+        static AllocationStats& stats = AllocationTracker::Register("SkipList");
+        return stats;
+    }
+
+    static size_t NodeBytes(int height) {
+        return sizeof(Node) + sizeof(Link) * (size_t) height;
+    }
+
+    Node* CreateNode(const T& data, int height) {
+        AllocationTracker::OnAllocate(Stats(), NodeBytes(height));
+        Node* node = new (::operator new(NodeBytes(height))) Node(data, height);
+        Link* links = node->Links();
+        for (int l = 0; l < height; l++) {
+            links[l] = Link{nullptr, 0};
+        }
+        linkCount += height;
+        return node;
+    }
+
+    void DestroyNode(Node* node) {
+        AllocationTracker::OnFree(Stats(), NodeBytes(node->height));
+        linkCount -= node->height;
+        node->~Node();
+        ::operator delete(node);
+    }
+
+    // Geometric with p = 1/4: two zero bits of a xorshift word per level.
+    int RandomHeight() {
+        seed ^= seed << 13;
+        seed ^= seed >> 7;
+        seed ^= seed << 17;
+        int height = 1 + countr_zero(seed | (1ull << 62)) / 2;
+        return height < MAX_LEVEL ? height : MAX_LEVEL;
+    }
+
+    // Raises the list to `height` levels; the new levels start at the head.
+    void Raise(int height) {
+        for (; level < height; level++) {
+            last[level] = head;
+            lastPosition[level] = 0;
+        }
+    }
+
+    // The node at `position` (0 is the head).
+    Node* Find(int position) const {
+        Node* current = head;
+        int reached = 0;
+        for (int l = level - 1; l >= 0; l--) {
+            Link* links = current->Links();
+            while (links[l].next != nullptr && reached + links[l].width <= position) {
+                reached += links[l].width;
+                current = links[l].next;
+                links = current->Links();
+            }
+        }
+        return current;
+    }
+
+    // For each level, the last node before `position` and where it is.
+    void FindPredecessors(int position, Node** update, int* rank) const {
+        Node* current = head;
+        int reached = 0;
+        for (int l = level - 1; l >= 0; l--) {
+            Link* links = current->Links();
+            while (links[l].next != nullptr && reached + links[l].width < position) {
+                reached += links[l].width;
+                current = links[l].next;
+                links = current->Links();
+            }
+            update[l] = current;
+            rank[l] = reached;
+        }
+    }
+
+    Node* GetNode(int index) const {
+        if (index < 0 || index >= size) {
+            throw IndexOutOfRange();
+        }
+        return Find(index + 1);
+    }
+
+public:
+    SkipList() {
+        head = CreateNode(T(), MAX_LEVEL);
+        for (int l = 0; l < MAX_LEVEL; l++) {
+            last[l] = head;
+            lastPosition[l] = 0;
+        }
+    }
+
+    SkipList(T* items, int count) : SkipList() {
+        for (int i = 0; i < count; i++) {
+            Append(items[i]);
+        }
+    }
+
+    SkipList(const SkipList<T>& list) : SkipList() {
+        for (Node* current = list.head->Links()[0].next; current != nullptr; current = current->Links()[0].next) {
+            Append(current->data);
+        }
+    }
+
+    ~SkipList() {
+        Node* current = head;
+        while (current != nullptr) {
+            Node* next = current->Links()[0].next;
+            DestroyNode(current);
+            current = next;
+        }
+    }
+
+    T GetFirst() {
+        if (size == 0) {
+            throw IndexOutOfRange();
+        }
+        return head->Links()[0].next->data;
+    }
+
+    T GetLast() {
+        if (size == 0) {
+            throw IndexOutOfRange();
+        }
+        return last[0]->data;
+    }
+
+    T Get(int index) override {
+        return GetNode(index)->data;
+    }
+
+    int GetSize() override {
+        return size;
+    }
+
+    CollectionFootprint MemoryFootprint() override {
+        CollectionFootprint footprint;
+        footprint.payloadBytes = sizeof(T) * size;
+        footprint.overheadBytes = sizeof(*this) + (sizeof(Node) - sizeof(T)) * (size_t) (size + 1)
+                                  + sizeof(T) + sizeof(Link) * (size_t) linkCount;
+        footprint.allocationCount = size + 1;
+        return footprint;
+    }
+
+    T& operator[](int index) {
+        return GetNode(index)->data;
+    }
+
+    const T& operator[](int index) const {
+        return GetNode(index)->data;
+    }
+
+    // Stable: sorts a copy of the values and writes them back in order, so
+    // the links and widths stay as they are.
+    template <class Compare = less<T>>
+    void Sort(Compare compare = Compare()) {
+        if (size < 2) {
+            return;
+        }
+        vector<T> values;
+        values.reserve(size);
+        for (Node* current = head->Links()[0].next; current != nullptr; current = current->Links()[0].next) {
+            values.push_back(current->data);
+        }
+        StableSortRange(values.data(), size, compare);
+        int i = 0;
+        for (Node* current = head->Links()[0].next; current != nullptr; current = current->Links()[0].next) {
+            current->data = values[i++];
+        }
+    }
+
+    SkipList<T>* GetSubList(int startIndex, int endIndex) {
+        if (startIndex < 0 || endIndex >= size || startIndex > endIndex) {
+            throw IndexOutOfRange();
+        }
+        SkipList<T>* subList = new SkipList<T>();
+        Node* current = startIndex < endIndex ? GetNode(startIndex) : nullptr;
+        for (int i = startIndex; i < endIndex; i++) {
+            subList->Append(current->data);
+            current = current->Links()[0].next;
+        }
+        return subList;
+    }
+
+    void Append(T item) override {
+        int height = RandomHeight();
+        Raise(height);
+        Node* node = CreateNode(item, height);
+        int position = size + 1;
+        Link* links = node->Links();
+        for (int l = 0; l < height; l++) {
+            Link& link = last[l]->Links()[l];
+            link.next = node;
+            link.width = position - lastPosition[l];
+            links[l] = Link{nullptr, 0};
+            last[l] = node;
+            lastPosition[l] = position;
+        }
+        size++;
+    }
+
+    void Prepend(T item) override {
+        Insert(item, 0);
+    }
+
+    void Insert(T item, int index) override {
+        if (index < 0 || index > size) {
+            throw IndexOutOfRange();
+        }
+        if (index == size) {
+            Append(item);
+            return;
+        }
+        int height = RandomHeight();
+        Raise(height);
+        Node* update[MAX_LEVEL] = {};
+        int rank[MAX_LEVEL];
+        int position = index + 1;
+        FindPredecessors(position, update, rank);
+        Node* node = CreateNode(item, height);
+        Link* links = node->Links();
+        for (int l = 0; l < level; l++) {
+            Link& link = update[l]->Links()[l];
+            if (l < height) {
+                links[l].next = link.next;
+                // The old successor moves up one position.
+                links[l].width = rank[l] + link.width + 1 - position;
+                link.next = node;
+                link.width = position - rank[l];
+                if (links[l].next == nullptr) {
+                    last[l] = node;
+                    lastPosition[l] = position;
+                }
+            } else if (link.next != nullptr) {
+                link.width++;
+            }
+            if (last[l] != node && lastPosition[l] >= position) {
+                lastPosition[l]++;
+            }
+        }
+        size++;
+    }
+
+    // Unlinks and frees the element at `index`.
+    void RemoveAt(int index) {
+        if (index < 0 || index >= size) {
+            throw IndexOutOfRange();
+        }
+        Node* update[MAX_LEVEL] = {};
+        int rank[MAX_LEVEL];
+        int position = index + 1;
+        FindPredecessors(position, update, rank);
+        Node* node = update[0]->Links()[0].next;
+        Link* links = node->Links();
+        for (int l = 0; l < level; l++) {
+            Link& link = update[l]->Links()[l];
+            if (l < node->height) {
+                link.next = links[l].next;
+                if (link.next != nullptr) {
+                    link.width += links[l].width - 1;
+                } else {
+                    last[l] = update[l];
+                    lastPosition[l] = rank[l];
+                }
+            } else if (link.next != nullptr) {
+                link.width--;
+            }
+            if (lastPosition[l] > position) {
+                lastPosition[l]--;
+            }
+        }
+        DestroyNode(node);
+        size--;
+        while (level > 1 && head->Links()[level - 1].next == nullptr) {
+            level--;
+        }
+    }
+
+    SkipList<T>* Concat(SkipList<T>* list) {
+        SkipList<T>* newList = new SkipList<T>(*this);
+        for (Node* current = list->head->Links()[0].next; current != nullptr; current = current->Links()[0].next) {
+            newList->Append(current->data);
+        }
+        return newList;
+    }
+};
@@ -0,0 +1,365 @@
+#pragma once
+
+#include <functional>
+
+#include "Sequence.h"
+#include "DynamicArray.h"
+#include "MutableArraySequence.h"
+#include "Prefetch.h"
+#include "Sorting.h"
+
+// A sequence that keeps its elements ordered by Compare, so lookups are
+// O(log n) binary searches instead of TryFind's linear scan. Elements live
+// in a DynamicArray with spare capacity; InsertSorted shifts the tail, O(n).
+//
+// As a Sequence<T> it accepts every mutation, but never breaks the order:
+// Append, Prepend and Insert put the item at its sorted position (Insert
+// still validates its index). Writes through operator[] must not change an
+// element's position in the order.
+template <class T, class Compare = less<T>>
+class SortedSequence : public Sequence<T> {
+protected:
+    DynamicArray<T>* array;
+    int size = 0;
+    Compare compare;
+
+    SortedSequence<T, Compare>* CreateSortedSequence() {
+        return new SortedSequence<T, Compare>(compare);
+    }
+
+    T* Data() const {
+        return size > 0 ? &(*array)[0] : nullptr;
+    }
+
+    void Reserve(int count) {
+        int capacity = array->GetSize();
+        if (count <= capacity) {
+            return;
+        }
+        int newCapacity = GrowCapacity(capacity, count, 8);
+        array->Resize(newCapacity);
+    }
+
+    // Branchless binary search: the loop has no data-dependent branch, only
+    // a conditional move, and prefetches both halves the next step can
+    // pick, so a probe overlaps the cache miss of the one after it.
+    int LowerBoundIndex(const T& key) const {
+        if (size == 0) {
+            return 0;
+        }
+        const T* first = Data();
+        const T* base = first;
+        int length = size;
+        while (length > 1) {
+            int half = length / 2;
+            Prefetch(base + half / 2);
+            Prefetch(base + half + half / 2);
+            base = compare(base[half], key) ? base + half : base;
+            length -= half;
+        }
+        return (int) (base - first) + (compare(*base, key) ? 1 : 0);
+    }
+
+    int UpperBoundIndex(const T& key) const {
+        if (size == 0) {
+            return 0;
+        }
+        const T* first = Data();
+        const T* base = first;
+        int length = size;
+        while (length > 1) {
+            int half = length / 2;
+            Prefetch(base + half / 2);
+            Prefetch(base + half + half / 2);
+            base = compare(key, base[half]) ? base : base + half;
+            length -= half;
+        }
+        return (int) (base - first) + (compare(key, *base) ? 0 : 1);
+    }
+
+    // Adopts `storage` as `count` unsorted elements and sorts them.
+    void Adopt(DynamicArray<T>* storage, int count) {
+        array = storage;
+        size = count;
+        SortRange(Data(), size, compare);
+    }
+
+public:
+    explicit SortedSequence(Compare compare = Compare()) : compare(compare) {
+        array = new DynamicArray<T>(0);
+    }
+
+    SortedSequence(T* items, int count, Compare compare = Compare()) : compare(compare) {
+        Adopt(new DynamicArray<T>(items, count), count);
+    }
+
+    SortedSequence(Sequence<T>* other, Compare compare = Compare()) : compare(compare) {
+        DynamicArray<T>* storage = new DynamicArray<T>(other->GetSize());
+        for (int i = 0; i < other->GetSize(); i++) {
+            (*storage)[i] = other->Get(i);
+        }
+        Adopt(storage, other->GetSize());
+    }
+
+    SortedSequence(SortedSequence<T, Compare>* other) : compare(other->compare) {
+        array = new DynamicArray<T>(*other->array);
+        size = other->size;
+    }
+
+    // Takes ownership of `storage` and sorts it.
+    explicit SortedSequence(DynamicArray<T>* storage, Compare compare = Compare()) : compare(compare) {
+        Adopt(storage, storage->GetSize());
+    }
+
+    ~SortedSequence() {
+        delete array;
+    }
+
+    // Index of the first element not less than `key`; GetSize() if none.
+    int LowerBound(const T& key) const {
+        return LowerBoundIndex(key);
+    }
+
+    // Index of the first element greater than `key`; GetSize() if none.
+    int UpperBound(const T& key) const {
+        return UpperBoundIndex(key);
+    }
+
+    bool Contains(const T& key) const {
+        int index = LowerBoundIndex(key);
+        return index < size && !compare(key, (*array)[index]);
+    }
+
+    // Number of elements equivalent to `key`.
+    int Count(const T& key) const {
+        return UpperBoundIndex(key) - LowerBoundIndex(key);
+    }
+
+    // The elements in [lo, hi), as a new sorted sequence.
+    SortedSequence<T, Compare>* Range(const T& lo, const T& hi) {
+        SortedSequence<T, Compare>* range = CreateSortedSequence();
+        int begin = LowerBoundIndex(lo);
+        int end = LowerBoundIndex(hi);
+        if (end > begin) {
+            range->Reserve(end - begin);
+            for (int i = begin; i < end; i++) {
+                (*range->array)[i - begin] = (*array)[i];
+            }
+            range->size = end - begin;
+        }
+        return range;
+    }
+
+    // Inserts after any equivalent elements and returns the new index.
+    int InsertSorted(T item) {
+        int index = UpperBoundIndex(item);
+        Reserve(size + 1);
+        T* data = &(*array)[0];
+        for (int i = size; i > index; i--) {
+            data[i] = data[i - 1];
+        }
+        data[index] = item;
+        size++;
+        return index;
+    }
+
+    // Removes one element equivalent to `key`; false if there is none.
+    bool Remove(const T& key) {
+        int index = LowerBoundIndex(key);
+        if (index == size || compare(key, (*array)[index])) {
+            return false;
+        }
+        T* data = &(*array)[0];
+        for (int i = index; i < size - 1; i++) {
+            data[i] = data[i + 1];
+        }
+        size--;
+        return true;
+    }
+
+    Sequence<T>* GetSubSequence(int startIndex, int endIndex) override {
+        if (startIndex < 0 || endIndex > size || startIndex > endIndex) {
+            throw IndexOutOfRange();
+        }
+        SortedSequence<T, Compare>* subSequence = CreateSortedSequence();
+        subSequence->Reserve(endIndex - startIndex);
+        for (int i = startIndex; i < endIndex; i++) {
+            (*subSequence->array)[i - startIndex] = (*array)[i];
+        }
+        subSequence->size = endIndex - startIndex;
+        return subSequence;
+    }
+
+    T GetFirst() override {
+        if (size == 0) {
+            throw IndexOutOfRange();
+        }
+        return (*array)[0];
+    }
+
+    T GetLast() override {
+        if (size == 0) {
+            throw IndexOutOfRange();
+        }
+        return (*array)[size - 1];
+    }
+
+    T Get(int index) override {
+        if (index < 0 || index >= size) {
+            throw IndexOutOfRange();
+        }
+        return (*array)[index];
+    }
+
+    int GetSize() override {
+        return size;
+    }
+
+    CollectionFootprint MemoryFootprint() override {
+        CollectionFootprint footprint = array->MemoryFootprint().Wrapped(sizeof(*this));
+        size_t slack = sizeof(T) * (size_t) (array->GetSize() - size);
+        footprint.payloadBytes -= slack;
+        footprint.overheadBytes += slack;
+        return footprint;
+    }
+
+    T& operator[](int index) override {
+        if (index < 0 || index >= size) {
+            throw IndexOutOfRange();
+        }
+        return (*array)[index];
+    }
+
+    const T& operator[](int index) const override {
+        if (index < 0 || index >= size) {
+            throw IndexOutOfRange();
+        }
+        return (*array)[index];
+    }
+
+    bool TryGet(int index, T& value) override {
+        if (index < 0 || index >= size) {
+            throw IndexOutOfRange();
+        }
+        value = (*array)[index];
+        return true;
+    }
+
+    // Arbitrary predicates need the linear scan; for a key use Contains.
+    bool TryFind(function<bool(T)> predicate, T& value) override {
+        for (int i = 0; i < size; i++) {
+            if (predicate((*array)[i])) {
+                value = (*array)[i];
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // The mapped values are in no particular order, so the result is a
+    // plain MutableArraySequence.
+    Sequence<T>* Map(function<T(T)> func) override {
+        MutableArraySequence<T>* newSequence = new MutableArraySequence<T>();
+        for (int i = 0; i < size; ++i) {
+            newSequence->Append(func((*array)[i]));
+        }
+        return newSequence;
+    }
+
+    T Reduce(function<T(T, T)> func, T startValue) override {
+        T result = startValue;
+        for (int i = 0; i < size; ++i) {
+            result = func(result, (*array)[i]);
+        }
+        return result;
+    }
+
+    // A subset of a sorted sequence is sorted: filled in order, no search.
+    Sequence<T>* Where(function<bool(T)> predicate) override {
+        SortedSequence<T, Compare>* newSequence = CreateSortedSequence();
+        for (int i = 0; i < size; ++i) {
+            T item = (*array)[i];
+            if (predicate(item)) {
+                newSequence->Reserve(newSequence->size + 1);
+                (*newSequence->array)[newSequence->size++] = item;
+            }
+        }
+        return newSequence;
+    }
+
+    Sequence<T>* Zip(Sequence<T>* other, function<T(T, T)> func) override {
+        MutableArraySequence<T>* newSequence = new MutableArraySequence<T>();
+        int minLength = min(size, other->GetSize());
+        for (int i = 0; i < minLength; ++i) {
+            newSequence->Append(func((*array)[i], other->Get(i)));
+        }
+        return newSequence;
+    }
+
+    // Drops `count` elements from `index` and adds the replacement at its
+    // sorted positions.
+    Sequence<T>* Slice(int index, int count, Sequence<T>* replacement) override {
+        if (index < 0) {
+            index = size + index;
+            if (index < 0) {
+                throw IndexOutOfRange();
+            }
+        }
+        if (index >= size || index + count > size) {
+            throw IndexOutOfRange();
+        }
+        SortedSequence<T, Compare>* newSequence = CreateSortedSequence();
+        newSequence->Reserve(size - count);
+        for (int i = 0; i < index; ++i) {
+            (*newSequence->array)[newSequence->size++] = (*array)[i];
+        }
+        for (int i = index + count; i < size; ++i) {
+            (*newSequence->array)[newSequence->size++] = (*array)[i];
+        }
+        if (replacement != nullptr) {
+            for (int i = 0; i < replacement->GetSize(); ++i) {
+                newSequence->InsertSorted(replacement->Get(i));
+            }
+        }
+        return newSequence;
+    }
+
+    // The elements between delimiters, which stay in order.
+    Sequence<T>* Split(function<bool(T)> predicate) override {
+        return Where([&predicate](T item) { return !predicate(item); });
+    }
+
+    void Append(T item) override {
+        InsertSorted(item);
+    }
+
+    void Prepend(T item) override {
+        InsertSorted(item);
+    }
+
+    void Insert(T item, int index) override {
+        if (index < 0 || index > size) {
+            throw IndexOutOfRange();
+        }
+        InsertSorted(item);
+    }
+
+    // Merges in linear time when `list` is sorted by the same order, and
+    // sorts a copy of it first otherwise.
+    Sequence<T>* Concat(Sequence<T>* list) override {
+        SortedSequence<T, Compare>* other = dynamic_cast<SortedSequence<T, Compare>*>(list);
+        SortedSequence<T, Compare>* sorted = other != nullptr ? other : new SortedSequence<T, Compare>(list, compare);
+        SortedSequence<T, Compare>* newSequence = CreateSortedSequence();
+        newSequence->Reserve(size + sorted->size);
+        int a = 0;
+        int b = 0;
+        while (a < size || b < sorted->size) {
+            bool takeOther = a == size || (b < sorted->size && compare((*sorted->array)[b], (*array)[a]));
+            (*newSequence->array)[newSequence->size++] = takeOther ? (*sorted->array)[b++] : (*array)[a++];
+        }
+        if (sorted != other) {
+            delete sorted;
+        }
+        return newSequence;
+    }
+};
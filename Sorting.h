@@ -0,0 +1,504 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <random>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "DynamicArray.h"
+
+using namespace std;
+
+// In-memory sorting of contiguous ranges, used by the array sequences.
+//
+//   SortRange        pdqsort (pattern-defeating quicksort), or LSD radix sort
+//                    for arithmetic keys with the default order.
+//   StableSortRange  bottom-up merge sort, or the same radix sort (which is
+//                    stable).
+//
+// Both switch to a parallel sample sort from SORT_PARALLEL_THRESHOLD
+// elements when more than one hardware thread is available.
+
+const int SORT_INSERTION_THRESHOLD = 24;
+const int SORT_NINTHER_THRESHOLD = 128;
+const int SORT_PARTIAL_INSERTION_LIMIT = 8;
+const int SORT_MERGE_RUN = 32;
+const int SORT_RADIX_THRESHOLD = 1024;
+const int SORT_PARALLEL_THRESHOLD = 1 << 20;
+
+// Radix sort orders by the bit pattern of the key, which agrees with
+// Compare only for arithmetic T under the default ascending order. Keys are
+// at most 64 bits, so wider types (long double, __int128) use pdqsort.
+template <class T, class Compare>
+constexpr bool IsRadixSortable() {
+    return (is_integral_v<T> || is_floating_point_v<T>) && !is_same_v<T, bool> && sizeof(T) <= 8
+           && (is_same_v<Compare, less<T>> || is_same_v<Compare, less<>>);
+}
+
+inline int SortThreads() {
+    unsigned threads = thread::hardware_concurrency();
+    return threads == 0 ? 1 : (int) threads;
+}
+
+template <class T, class Compare>
+void InsertionSort(T* begin, T* end, Compare& compare) {
+    if (begin == end) {
+        return;
+    }
+    for (T* current = begin + 1; current != end; current++) {
+        T* sift = current;
+        T* previous = current - 1;
+        if (compare(*sift, *previous)) {
+            T item = move(*sift);
+            do {
+                *sift-- = move(*previous);
+            } while (sift != begin && compare(item, *--previous));
+            *sift = move(item);
+        }
+    }
+}
+
+// Insertion sort that relies on *(begin - 1) being no greater than any
+// element of the range, so the inner loop has no bounds check.
+template <class T, class Compare>
+void UnguardedInsertionSort(T* begin, T* end, Compare& compare) {
+    if (begin == end) {
+        return;
+    }
+    for (T* current = begin + 1; current != end; current++) {
+        T* sift = current;
+        T* previous = current - 1;
+        if (compare(*sift, *previous)) {
+            T item = move(*sift);
+            do {
+                *sift-- = move(*previous);
+            } while (compare(item, *--previous));
+            *sift = move(item);
+        }
+    }
+}
+
+// Insertion sort that gives up after SORT_PARTIAL_INSERTION_LIMIT moves;
+// true when the range ended up sorted. Same precondition as the unguarded
+// version.
+template <class T, class Compare>
+bool PartialInsertionSort(T* begin, T* end, Compare& compare) {
+    if (begin == end) {
+        return true;
+    }
+    int moves = 0;
+    for (T* current = begin + 1; current != end; current++) {
+        T* sift = current;
+        T* previous = current - 1;
+        if (compare(*sift, *previous)) {
+            T item = move(*sift);
+            do {
+                *sift-- = move(*previous);
+            } while (sift != begin && compare(item, *--previous));
+            *sift = move(item);
+            moves += (int) (current - sift);
+        }
+        if (moves > SORT_PARTIAL_INSERTION_LIMIT) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template <class T, class Compare>
+void Sort2(T* a, T* b, Compare& compare) {
+    if (compare(*b, *a)) {
+        swap(*a, *b);
+    }
+}
+
+template <class T, class Compare>
+void Sort3(T* a, T* b, T* c, Compare& compare) {
+    Sort2(a, b, compare);
+    Sort2(b, c, compare);
+    Sort2(a, b, compare);
+}
+
+// Partitions around the pivot at *begin into [< pivot] pivot [>= pivot] and
+// returns the pivot position, plus whether the range was already
+// partitioned (no element had to move).
+template <class T, class Compare>
+pair<T*, bool> PartitionRight(T* begin, T* end, Compare& compare) {
+    T pivot = move(*begin);
+    T* first = begin;
+    T* last = end;
+    // Median selection left an element >= pivot near the end, which stops
+    // the first scan; the second is unguarded only once the first scan has
+    // passed an element < pivot.
+    while (compare(*++first, pivot)) {
+    }
+    if (first - 1 == begin) {
+        while (first < last && !compare(*--last, pivot)) {
+        }
+    } else {
+        while (!compare(*--last, pivot)) {
+        }
+    }
+    bool alreadyPartitioned = first >= last;
+    while (first < last) {
+        swap(*first, *last);
+        while (compare(*++first, pivot)) {
+        }
+        while (!compare(*--last, pivot)) {
+        }
+    }
+    T* pivotPosition = first - 1;
+    *begin = move(*pivotPosition);
+    *pivotPosition = move(pivot);
+    return {pivotPosition, alreadyPartitioned};
+}
+
+// Used when the pivot equals the element before the range: puts everything
+// equal to it on the left, so runs of duplicates are finished in one pass.
+template <class T, class Compare>
+T* PartitionLeft(T* begin, T* end, Compare& compare) {
+    T pivot = move(*begin);
+    T* first = begin;
+    T* last = end;
+    while (compare(pivot, *--last)) {
+    }
+    if (last + 1 == end) {
+        while (first < last && !compare(pivot, *++first)) {
+        }
+    } else {
+        while (!compare(pivot, *++first)) {
+        }
+    }
+    while (first < last) {
+        swap(*first, *last);
+        while (compare(pivot, *--last)) {
+        }
+        while (!compare(pivot, *++first)) {
+        }
+    }
+    T* pivotPosition = last;
+    *begin = move(*pivotPosition);
+    *pivotPosition = move(pivot);
+    return pivotPosition;
+}
+
+template <class T, class Compare>
+void PdqSortLoop(T* begin, T* end, Compare& compare, int badAllowed, bool leftmost) {
+    while (true) {
+        int size = (int) (end - begin);
+        if (size < SORT_INSERTION_THRESHOLD) {
+            if (leftmost) {
+                InsertionSort(begin, end, compare);
+            } else {
+                UnguardedInsertionSort(begin, end, compare);
+            }
+            return;
+        }
+
+        // Median of three, or Tukey's ninther for larger ranges, moved to
+        // *begin.
+        int half = size / 2;
+        if (size > SORT_NINTHER_THRESHOLD) {
+            Sort3(begin, begin + half, end - 1, compare);
+            Sort3(begin + 1, begin + (half - 1), end - 2, compare);
+            Sort3(begin + 2, begin + (half + 1), end - 3, compare);
+            Sort3(begin + (half - 1), begin + half, begin + (half + 1), compare);
+            swap(*begin, *(begin + half));
+        } else {
+            Sort3(begin + half, begin, end - 1, compare);
+        }
+
+        if (!leftmost && !compare(*(begin - 1), *begin)) {
+            begin = PartitionLeft(begin, end, compare) + 1;
+            continue;
+        }
+
+        pair<T*, bool> partition = PartitionRight(begin, end, compare);
+        T* pivot = partition.first;
+        int leftSize = (int) (pivot - begin);
+        int rightSize = (int) (end - (pivot + 1));
+        bool unbalanced = leftSize < size / 8 || rightSize < size / 8;
+
+        if (unbalanced) {
+            // Too many bad pivots: the input is adversarial, finish with
+            // heapsort for the O(n log n) bound.
+            if (--badAllowed == 0) {
+                make_heap(begin, end, compare);
+                sort_heap(begin, end, compare);
+                return;
+            }
+            // Otherwise break up the pattern that produced the bad pivot.
+            if (leftSize >= SORT_INSERTION_THRESHOLD) {
+                swap(*begin, *(begin + leftSize / 4));
+                swap(*(pivot - 1), *(pivot - leftSize / 4));
+                if (leftSize > SORT_NINTHER_THRESHOLD) {
+                    swap(*(begin + 1), *(begin + (leftSize / 4 + 1)));
+                    swap(*(begin + 2), *(begin + (leftSize / 4 + 2)));
+                    swap(*(pivot - 2), *(pivot - (leftSize / 4 + 1)));
+                    swap(*(pivot - 3), *(pivot - (leftSize / 4 + 2)));
+                }
+            }
+            if (rightSize >= SORT_INSERTION_THRESHOLD) {
+                swap(*(pivot + 1), *(pivot + (1 + rightSize / 4)));
+                swap(*(end - 1), *(end - rightSize / 4));
+                if (rightSize > SORT_NINTHER_THRESHOLD) {
+                    swap(*(pivot + 2), *(pivot + (2 + rightSize / 4)));
+                    swap(*(pivot + 3), *(pivot + (3 + rightSize / 4)));
+                    swap(*(end - 2), *(end - (1 + rightSize / 4)));
+                    swap(*(end - 3), *(end - (2 + rightSize / 4)));
+                }
+            }
+        } else if (partition.second
+                   && PartialInsertionSort(begin, pivot, compare)
+                   && PartialInsertionSort(pivot + 1, end, compare)) {
+            // A well-balanced partition that moved nothing: the input was
+            // probably (nearly) sorted already.
+            return;
+        }
+
+        PdqSortLoop(begin, pivot, compare, badAllowed, leftmost);
+        begin = pivot + 1;
+        leftmost = false;
+    }
+}
+
+template <class T, class Compare>
+void PdqSort(T* begin, T* end, Compare compare) {
+    int size = (int) (end - begin);
+    if (size < 2) {
+        return;
+    }
+    PdqSortLoop(begin, end, compare, bit_width((unsigned) size), true);
+}
+
+// Unsigned key whose natural order matches the order of the values: the
+// sign bit is flipped for signed integers; negative floats are inverted
+// entirely. -0.0 is folded into +0.0 so equal values keep their order.
+template <class T>
+auto RadixKey(T value) {
+    using Key = conditional_t<sizeof(T) == 1, uint8_t,
+                conditional_t<sizeof(T) == 2, uint16_t,
+                conditional_t<sizeof(T) == 4, uint32_t, uint64_t>>>;
+    const Key signBit = (Key) ((Key) 1 << (sizeof(T) * 8 - 1));
+    if constexpr (is_floating_point_v<T>) {
+        value = value + T(0);
+        Key bits;
+        memcpy(&bits, &value, sizeof(bits));
+        return (Key) ((bits & signBit) ? ~bits : bits | signBit);
+    } else if constexpr (is_signed_v<T>) {
+        return (Key) ((Key) value ^ signBit);
+    } else {
+        return (Key) value;
+    }
+}
+
+// LSD radix sort on 8-bit digits. Stable, O(n * sizeof(T)); `scratch` holds
+// size elements. All digit histograms are built in one pass and digits on
+// which every key agrees are skipped.
+template <class T>
+void RadixSort(T* data, int size, T* scratch) {
+    static_assert(sizeof(T) <= 8, "RadixSort handles keys of up to 64 bits");
+    const int digits = (int) sizeof(T);
+    vector<int> counts(digits * 256, 0);
+    for (int i = 0; i < size; i++) {
+        auto key = RadixKey(data[i]);
+        for (int d = 0; d < digits; d++) {
+            counts[d * 256 + (int) ((key >> (8 * d)) & 0xFF)]++;
+        }
+    }
+    T* from = data;
+    T* to = scratch;
+    for (int d = 0; d < digits; d++) {
+        int* count = &counts[d * 256];
+        if (count[(int) ((RadixKey(from[0]) >> (8 * d)) & 0xFF)] == size) {
+            continue;
+        }
+        int offset = 0;
+        for (int bucket = 0; bucket < 256; bucket++) {
+            int bucketSize = count[bucket];
+            count[bucket] = offset;
+            offset += bucketSize;
+        }
+        for (int i = 0; i < size; i++) {
+            to[count[(int) ((RadixKey(from[i]) >> (8 * d)) & 0xFF)]++] = from[i];
+        }
+        swap(from, to);
+    }
+    if (from != data) {
+        copy(from, from + size, data);
+    }
+}
+
+template <class T, class Compare>
+void MergeAdjacent(T* left, T* middle, T* right, T* output, Compare& compare) {
+    T* a = left;
+    T* b = middle;
+    while (a != middle && b != right) {
+        // Take from the right run only when strictly smaller: stable.
+        if (compare(*b, *a)) {
+            *output++ = move(*b++);
+        } else {
+            *output++ = move(*a++);
+        }
+    }
+    output = move(a, middle, output);
+    move(b, right, output);
+}
+
+// Bottom-up merge sort: insertion-sorted runs of SORT_MERGE_RUN, then
+// passes that merge neighbouring runs back and forth between the range and
+// `scratch` (size elements).
+template <class T, class Compare>
+void MergeSort(T* data, int size, T* scratch, Compare compare) {
+    for (int start = 0; start < size; start += SORT_MERGE_RUN) {
+        InsertionSort(data + start, data + min(start + SORT_MERGE_RUN, size), compare);
+    }
+    T* from = data;
+    T* to = scratch;
+    for (int width = SORT_MERGE_RUN; width < size; width *= 2) {
+        for (int start = 0; start < size; start += 2 * width) {
+            int middle = min(start + width, size);
+            int end = min(start + 2 * width, size);
+            MergeAdjacent(from + start, from + middle, from + end, to + start, compare);
+        }
+        swap(from, to);
+    }
+    if (from != data) {
+        move(from, from + size, data);
+    }
+}
+
+template <class T, class Compare>
+void SerialSort(T* data, int size, T* scratch, Compare& compare, bool stable) {
+    if constexpr (IsRadixSortable<T, Compare>()) {
+        if (size >= SORT_RADIX_THRESHOLD) {
+            RadixSort(data, size, scratch);
+            return;
+        }
+    }
+    if (stable) {
+        MergeSort(data, size, scratch, compare);
+    } else {
+        PdqSort(data, data + size, compare);
+    }
+}
+
+// Parallel sample sort. A sorted random sample picks threads * 4 - 1
+// splitters; each thread classifies a contiguous slice and the slices are
+// scattered bucket by bucket into `scratch`, slice order preserved; the
+// buckets are then sorted in parallel and copied back. Stable when
+// `stable` is, because the scatter keeps input order within a bucket.
+template <class T, class Compare>
+void SampleSort(T* data, int size, T* scratch, Compare compare, int threads, bool stable) {
+    if (size < 2) {
+        return;
+    }
+    const int oversampling = 32;
+    int bucketCount = threads * 4;
+    vector<T> sample;
+    sample.reserve(bucketCount * oversampling);
+    minstd_rand random(size);
+    for (int i = 0; i < bucketCount * oversampling; i++) {
+        sample.push_back(data[random() % size]);
+    }
+    PdqSort(sample.data(), sample.data() + sample.size(), compare);
+    vector<T> splitters;
+    for (int b = 1; b < bucketCount; b++) {
+        splitters.push_back(sample[b * oversampling]);
+    }
+
+    auto run = [&](auto work) {
+        vector<thread> workers;
+        for (int t = 1; t < threads; t++) {
+            workers.emplace_back(work, t);
+        }
+        work(0);
+        for (thread& worker : workers) {
+            worker.join();
+        }
+    };
+    auto sliceStart = [&](int t) {
+        return (int) ((long long) size * t / threads);
+    };
+
+    vector<uint16_t> buckets(size);
+    vector<int> offsets(threads * bucketCount, 0);
+    run([&](int t) {
+        int* count = &offsets[t * bucketCount];
+        for (int i = sliceStart(t); i < sliceStart(t + 1); i++) {
+            int bucket = (int) (upper_bound(splitters.begin(), splitters.end(), data[i], compare) - splitters.begin());
+            buckets[i] = (uint16_t) bucket;
+            count[bucket]++;
+        }
+    });
+
+    // offsets[t][b]: where slice t starts writing bucket b.
+    vector<int> bucketStart(bucketCount + 1, 0);
+    int offset = 0;
+    for (int b = 0; b < bucketCount; b++) {
+        bucketStart[b] = offset;
+        for (int t = 0; t < threads; t++) {
+            int count = offsets[t * bucketCount + b];
+            offsets[t * bucketCount + b] = offset;
+            offset += count;
+        }
+    }
+    bucketStart[bucketCount] = size;
+
+    run([&](int t) {
+        int* next = &offsets[t * bucketCount];
+        for (int i = sliceStart(t); i < sliceStart(t + 1); i++) {
+            scratch[next[buckets[i]]++] = data[i];
+        }
+    });
+
+    // Buckets are sorted inside `scratch`, using the same region of `data`
+    // as their scratch space, then copied back.
+    run([&](int t) {
+        Compare local = compare;
+        for (int b = t; b < bucketCount; b += threads) {
+            int begin = bucketStart[b];
+            int count = bucketStart[b + 1] - begin;
+            if (count > 1) {
+                SerialSort(scratch + begin, count, data + begin, local, stable);
+            }
+            copy(scratch + begin, scratch + begin + count, data + begin);
+        }
+    });
+}
+
+template <class T, class Compare>
+void DispatchSort(T* data, int size, Compare& compare, bool stable) {
+    if (size < 2) {
+        return;
+    }
+    int threads = size >= SORT_PARALLEL_THRESHOLD ? min(SortThreads(), 64) : 1;
+    bool radix = IsRadixSortable<T, Compare>() && size >= SORT_RADIX_THRESHOLD;
+    if (threads == 1 && !radix && !stable) {
+        // pdqsort is in place: no scratch buffer.
+        PdqSort(data, data + size, compare);
+        return;
+    }
+    DynamicArray<T> scratch(size);
+    if (threads > 1) {
+        SampleSort(data, size, &scratch[0], compare, threads, stable);
+    } else {
+        SerialSort(data, size, &scratch[0], compare, stable);
+    }
+}
+
+template <class T, class Compare = less<T>>
+void SortRange(T* data, int size, Compare compare = Compare()) {
+    DispatchSort(data, size, compare, false);
+}
+
+template <class T, class Compare = less<T>>
+void StableSortRange(T* data, int size, Compare compare = Compare()) {
+    DispatchSort(data, size, compare, true);
+}
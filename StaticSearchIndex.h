@@ -0,0 +1,129 @@
+#pragma once
+
+#include <bit>
+#include <cstdint>
+#include <functional>
+
+#include "Sequence.h"
+#include "DynamicArray.h"
+#include "Prefetch.h"
+#include "Sorting.h"
+
+// A read-only search index over a snapshot of a sequence, for lookup
+// tables that are built once and queried many times. Keys are stored in
+// Eytzinger (BFS) order: the children of slot k are 2k and 2k + 1, so the
+// first levels of every search share a few cache lines and the slots a few
+// levels down from k are contiguous and can be prefetched one line at a
+// time. Each slot stores the key next to its index in the source sequence,
+// so mapping a result back costs no extra cache miss.
+//
+// Building is O(n) when the source is already sorted (checked in one
+// pass), otherwise a stable O(n log n) sort comes first. Among equivalent
+// keys, lookups report the one with the smallest source index. The index
+// does not follow later changes to the source.
+template <class T, class Compare = less<T>>
+class StaticSearchIndex {
+private:
+    struct Entry {
+        T key;
+        int index;
+    };
+
+    // Slot 0 is unused so that the children of k are 2k and 2k + 1.
+    DynamicArray<Entry> slots;
+    int size;
+    Compare compare;
+
+    // Slots per cache line: the line at slot k * SLOTS_PER_LINE holds the
+    // descendants of k that many levels down (8 slots, 3 levels, for int).
+    static const int SLOTS_PER_LINE = sizeof(Entry) >= 64 ? 1 : (int) (64 / sizeof(Entry));
+
+    // In-order walk of the implicit tree fills slots with ascending keys.
+    int Fill(Entry* sorted, int next, int slot) {
+        if (slot > size) {
+            return next;
+        }
+        next = Fill(sorted, next, 2 * slot);
+        slots[slot] = sorted[next];
+        return Fill(sorted, next + 1, 2 * slot + 1);
+    }
+
+    void Build(Entry* entries) {
+        bool sorted = true;
+        for (int i = 1; i < size && sorted; i++) {
+            sorted = !compare(entries[i].key, entries[i - 1].key);
+        }
+        if (!sorted) {
+            Compare& order = compare;
+            StableSortRange(entries, size, [&order](const Entry& a, const Entry& b) {
+                return order(a.key, b.key);
+            });
+        }
+        Fill(entries, 0, 1);
+    }
+
+    // Slot of the first key not less than `key`, 0 if there is none. The
+    // descent is branch-free; the final shift undoes the right turns taken
+    // after the last left turn, which is where the answer was passed.
+    int LowerBoundSlot(const T& key) const {
+        int slot = 1;
+        const Entry* data = &slots[0];
+        while (slot <= size) {
+            // Near the leaves this points past the array; a prefetch of an
+            // unmapped address is dropped, never faulted.
+            Prefetch((const void*) ((uintptr_t) data + sizeof(Entry) * SLOTS_PER_LINE * (uintptr_t) slot));
+            slot = 2 * slot + (compare(data[slot].key, key) ? 1 : 0);
+        }
+        return slot >> (countr_one((unsigned) slot) + 1);
+    }
+
+public:
+    StaticSearchIndex(T* items, int count, Compare compare = Compare())
+        : slots(count + 1), size(count), compare(compare) {
+        DynamicArray<Entry> entries(count > 0 ? count : 1);
+        for (int i = 0; i < count; i++) {
+            entries[i] = Entry{items[i], i};
+        }
+        Build(&entries[0]);
+    }
+
+    explicit StaticSearchIndex(Sequence<T>* sequence, Compare compare = Compare())
+        : slots(sequence->GetSize() + 1), size(sequence->GetSize()), compare(compare) {
+        DynamicArray<Entry> entries(size > 0 ? size : 1);
+        for (int i = 0; i < size; i++) {
+            entries[i] = Entry{sequence->Get(i), i};
+        }
+        Build(&entries[0]);
+    }
+
+    int GetSize() const {
+        return size;
+    }
+
+    // Source index of the first key not less than `key`, -1 if none.
+    int LowerBound(const T& key) const {
+        int slot = LowerBoundSlot(key);
+        return slot == 0 ? -1 : slots[slot].index;
+    }
+
+    // Source index of a key equivalent to `key`, -1 if none.
+    int Find(const T& key) const {
+        int slot = LowerBoundSlot(key);
+        if (slot == 0 || compare(key, slots[slot].key)) {
+            return -1;
+        }
+        return slots[slot].index;
+    }
+
+    bool Contains(const T& key) const {
+        return Find(key) != -1;
+    }
+
+    CollectionFootprint MemoryFootprint() {
+        CollectionFootprint footprint;
+        footprint.payloadBytes = sizeof(T) * (size_t) size;
+        footprint.overheadBytes = sizeof(*this) + sizeof(Entry) * (size_t) (size + 1) - footprint.payloadBytes;
+        footprint.allocationCount = 1;
+        return footprint;
+    }
+};
@@ -0,0 +1,1557 @@
+#include <cstdio>
+#include <filesystem>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+
+#include "Benchmark.h"
+#include "DynamicArray.h"
+#include "LinkedList.h"
+#include "SegmentedList.h"
+#include "MutableArraySequence.h"
+#include "ImmutableArraySequence.h"
+#include "MutableListSequence.h"
+#include "ImmutableListSequence.h"
+#include "AdaptiveSequence.h"
+#include "SortedSequence.h"
+#include "StaticSearchIndex.h"
+#include "IndexedSequence.h"
+#include "StreamingSequence.h"
+#include "ExternalSort.h"
+#include "ColumnarSequence.h"
+#include "PackedIntSequence.h"
+#include "BitSequence.h"
+#include "RleSequence.h"
+#include "SkipList.h"
+#include "IntrusiveList.h"
+#include "ConcurrentQueue.h"
+#include "ConcurrentSegmentedList.h"
+#include "ShardedArraySequence.h"
+
+using namespace std;
+
+// Element values and the callbacks passed to Map/Reduce/Where for each
+// element type under test.
+template <class T>
+struct ElementTraits;
+
+template <>
+struct ElementTraits<int> {
+    static const char* Name() { return "int"; }
+    static int Make(long long i) { return (int) (i * 2654435761u); }
+    static int Transform(int x) { return x * 3 + 1; }
+    static int Combine(int a, int b) { return a + b; }
+    static bool Keep(int x) { return (x & 1) == 0; }
+};
+
+template <>
+struct ElementTraits<double> {
+    static const char* Name() { return "double"; }
+    static double Make(long long i) { return (double) i * 0.5 + 0.25; }
+    static double Transform(double x) { return x * 1.5 + 1.0; }
+    static double Combine(double a, double b) { return a + b; }
+    static bool Keep(double x) { return ((long long) x & 1) == 0; }
+};
+
+template <>
+struct ElementTraits<string> {
+    static const char* Name() { return "string"; }
+    static string Make(long long i) { return "key-" + to_string(i * 7919 % 1000003); }
+    static string Transform(string x) { return x; }
+    static string Combine(string a, string b) { return a < b ? b : a; }
+    static bool Keep(string x) { return (x.back() & 1) == 0; }
+};
+
+template <class C>
+struct ContainerTraits;
+
+template <class T>
+struct ContainerTraits<DynamicArray<T>> {
+    static const char* Name() { return "DynamicArray"; }
+    static DynamicArray<T>* Build(T* items, int count) { return new DynamicArray<T>(items, count); }
+};
+
+template <class T>
+struct ContainerTraits<LinkedList<T>> {
+    static const char* Name() { return "LinkedList"; }
+    static LinkedList<T>* Build(T* items, int count) { return new LinkedList<T>(items, count); }
+};
+
+template <class T>
+struct ContainerTraits<LinkedList<T, true>> {
+    static const char* Name() { return "LinkedList+Doubly"; }
+    static LinkedList<T, true>* Build(T* items, int count) { return new LinkedList<T, true>(items, count); }
+};
+
+template <class T>
+struct ContainerTraits<SegmentedList<T>> {
+    static const char* Name() { return "SegmentedList"; }
+    static SegmentedList<T>* Build(T* items, int count) {
+        SegmentedList<T>* list = new SegmentedList<T>();
+        for (int i = 0; i < count; i++) {
+            list->Append(items[i]);
+        }
+        return list;
+    }
+};
+
+template <class T>
+struct ContainerTraits<MutableArraySequence<T>> {
+    static const char* Name() { return "MutableArraySequence"; }
+    static MutableArraySequence<T>* Build(T* items, int count) { return new MutableArraySequence<T>(items, count); }
+};
+
+template <class T>
+struct ContainerTraits<ImmutableArraySequence<T>> {
+    static const char* Name() { return "ImmutableArraySequence"; }
+    static ImmutableArraySequence<T>* Build(T* items, int count) { return new ImmutableArraySequence<T>(items, count); }
+};
+
+template <class T>
+struct ContainerTraits<MutableListSequence<T>> {
+    static const char* Name() { return "MutableListSequence"; }
+    static MutableListSequence<T>* Build(T* items, int count) { return new MutableListSequence<T>(items, count); }
+};
+
+template <class T>
+struct ContainerTraits<SkipList<T>> {
+    static const char* Name() { return "SkipList"; }
+    static SkipList<T>* Build(T* items, int count) { return new SkipList<T>(items, count); }
+};
+
+template <class T>
+struct ContainerTraits<MutableListSequence<T, SkipList<T>>> {
+    static const char* Name() { return "MutableListSequence+SkipList"; }
+    static MutableListSequence<T, SkipList<T>>* Build(T* items, int count) {
+        return new MutableListSequence<T, SkipList<T>>(items, count);
+    }
+};
+
+template <class T>
+struct ContainerTraits<ImmutableListSequence<T>> {
+    static const char* Name() { return "ImmutableListSequence"; }
+    static ImmutableListSequence<T>* Build(T* items, int count) { return new ImmutableListSequence<T>(items, count); }
+};
+
+template <class T>
+struct ContainerTraits<AdaptiveSequence<T>> {
+    static const char* Name() { return "AdaptiveSequence"; }
+    static AdaptiveSequence<T>* Build(T* items, int count) { return new AdaptiveSequence<T>(items, count); }
+};
+
+template <class T>
+struct ContainerTraits<SortedSequence<T>> {
+    static const char* Name() { return "SortedSequence"; }
+    static SortedSequence<T>* Build(T* items, int count) { return new SortedSequence<T>(items, count); }
+};
+
+template <class T>
+struct ContainerTraits<IndexedSequence<T>> {
+    static const char* Name() { return "IndexedSequence"; }
+    static IndexedSequence<T>* Build(T* items, int count) { return new IndexedSequence<T>(items, count); }
+};
+
+template <class C, class T>
+void RunContainerBenchmarks(BenchmarkRunner& runner, long long n) {
+    using Traits = ContainerTraits<C>;
+    using Element = ElementTraits<T>;
+    const string container = Traits::Name();
+    const string type = Element::Name();
+    const int size = (int) n;
+    if (!BenchmarkOptions::Selected(runner.Options().containers, container)) {
+        return;
+    }
+
+    vector<T> values(size);
+    for (int i = 0; i < size; i++) {
+        values[i] = Element::Make(i);
+    }
+    auto build = [&]() { return Traits::Build(values.data(), size); };
+    auto empty = [&]() { return new C(); };
+    auto release = [](C* c) { delete c; };
+
+    BenchmarkCase growth{container, "", type, "sequential", n, n, 1};
+
+    growth.operation = "Append";
+    runner.Run(growth, empty, [&](C* c, long long begin, long long count) {
+        for (long long i = begin; i < begin + count; i++) {
+            c->Append(values[i]);
+        }
+    }, release);
+
+    growth.operation = "Prepend";
+    runner.Run(growth, empty, [&](C* c, long long begin, long long count) {
+        for (long long i = begin; i < begin + count; i++) {
+            c->Prepend(values[i]);
+        }
+    }, release);
+
+    for (AccessPattern pattern : {AccessPattern::Sequential, AccessPattern::Random, AccessPattern::Zipf}) {
+        const string patternName = PatternName(pattern);
+        if (!runner.Wants(container, "Insert", type, patternName)
+            && !runner.Wants(container, "Get", type, patternName)
+            && !runner.Wants(container, "RemoveAt", type, patternName)) {
+            continue;
+        }
+        vector<int> indices = MakeIndexStream(pattern, n);
+        const size_t mask = indices.size() - 1;
+
+        // Indices are drawn from [0, n) and the fixture starts with n elements,
+        // so every index stays valid as the container grows.
+        BenchmarkCase insert{container, "Insert", type, patternName, n, n, 1};
+        runner.Run(insert, build, [&](C* c, long long begin, long long count) {
+            for (long long i = begin; i < begin + count; i++) {
+                c->Insert(values[i], indices[i & mask]);
+            }
+        }, release);
+
+        if constexpr (requires(C* c) { c->RemoveAt(0); }) {
+            // The fixture shrinks by one per call, so indices wrap to its size.
+            BenchmarkCase remove{container, "RemoveAt", type, patternName, n, n, 1};
+            runner.Run(remove, build, [&](C* c, long long begin, long long count) {
+                for (long long i = begin; i < begin + count; i++) {
+                    c->RemoveAt(indices[i & mask] % (int) (n - i));
+                }
+            }, release);
+        }
+
+        C* fixture = nullptr;
+        BenchmarkCase get{container, "Get", type, patternName, n};
+        runner.Run(get, [&]() { return fixture ? fixture : (fixture = build()); },
+                   [&](C* c, long long begin, long long count) {
+            for (long long i = begin; i < begin + count; i++) {
+                T value = c->Get(indices[i & mask]);
+                DoNotOptimize(value);
+            }
+        }, [](C*) {});
+        delete fixture;
+    }
+
+    C* fixture = nullptr;
+    auto shared = [&]() { return fixture ? fixture : (fixture = build()); };
+    auto keep = [](C*) {};
+    BenchmarkCase pass{container, "iterate", type, "sequential", n, BenchmarkCase::Unbounded, n};
+
+    runner.Run(pass, shared, [&](C* c, long long, long long count) {
+        for (long long k = 0; k < count; k++) {
+            for (int i = 0; i < size; i++) {
+                T value = c->Get(i);
+                DoNotOptimize(value);
+            }
+        }
+    }, keep);
+
+    // Full scans in the other directions: lists that start each Get from a
+    // cached position are only linear when they can walk that way.
+    pass.pattern = "descending";
+    runner.Run(pass, shared, [&](C* c, long long, long long count) {
+        for (long long k = 0; k < count; k++) {
+            for (int i = size - 1; i >= 0; i--) {
+                T value = c->Get(i);
+                DoNotOptimize(value);
+            }
+        }
+    }, keep);
+
+    pass.pattern = "random";
+    if (runner.Wants(container, pass.operation, type, pass.pattern)) {
+        vector<int> order = MakeIndexStream(AccessPattern::Random, n);
+        const size_t mask = order.size() - 1;
+        runner.Run(pass, shared, [&](C* c, long long, long long count) {
+            for (long long k = 0; k < count; k++) {
+                for (int i = 0; i < size; i++) {
+                    T value = c->Get(order[i & mask]);
+                    DoNotOptimize(value);
+                }
+            }
+        }, keep);
+    }
+    pass.pattern = "sequential";
+
+    if constexpr (is_same_v<C, LinkedList<T>>) {
+        pass.operation = "Concat";
+        runner.Run(pass, shared, [&](C* c, long long, long long count) {
+            for (long long k = 0; k < count; k++) {
+                delete c->Concat(c);
+            }
+        }, keep);
+
+        // The relinking variants split the fixture and splice it back
+        // together, so it is unchanged after each call. ConcatMove moves
+        // every node out and back in O(1); SplitAt cuts in the middle and
+        // pays the walk to it.
+        BenchmarkCase relink{container, "ConcatMove", type, "sequential", n};
+        runner.Run(relink, shared, [&](C* c, long long, long long count) {
+            for (long long k = 0; k < count; k++) {
+                C* all = c->SplitAt(0);
+                c->Concat(std::move(*all));
+                delete all;
+            }
+        }, keep);
+        relink.operation = "SplitAt";
+        runner.Run(relink, shared, [&](C* c, long long, long long count) {
+            for (long long k = 0; k < count; k++) {
+                C* rest = c->SplitAt(size / 2);
+                c->Splice(*rest);
+                delete rest;
+            }
+        }, keep);
+    }
+
+    if constexpr (is_base_of_v<Sequence<T>, C>) {
+        pass.operation = "Map";
+        runner.Run(pass, shared, [&](C* c, long long, long long count) {
+            for (long long k = 0; k < count; k++) {
+                delete c->Map(Element::Transform);
+            }
+        }, keep);
+
+        pass.operation = "Reduce";
+        runner.Run(pass, shared, [&](C* c, long long, long long count) {
+            for (long long k = 0; k < count; k++) {
+                T value = c->Reduce(Element::Combine, T());
+                DoNotOptimize(value);
+            }
+        }, keep);
+
+        pass.operation = "Where";
+        runner.Run(pass, shared, [&](C* c, long long, long long count) {
+            for (long long k = 0; k < count; k++) {
+                delete c->Where(Element::Keep);
+            }
+        }, keep);
+
+        pass.operation = "Concat";
+        runner.Run(pass, shared, [&](C* c, long long, long long count) {
+            for (long long k = 0; k < count; k++) {
+                delete c->Concat(c);
+            }
+        }, keep);
+
+        pass.operation = "Slice";
+        runner.Run(pass, shared, [&](C* c, long long, long long count) {
+            for (long long k = 0; k < count; k++) {
+                delete c->Slice(size / 4, size / 2, nullptr);
+            }
+        }, keep);
+    }
+
+    if constexpr (is_same_v<C, MutableArraySequence<T>> || is_same_v<C, MutableListSequence<T>>
+                  || is_same_v<C, LinkedList<T>>) {
+        // One sort per fixture: a second call would see sorted input.
+        BenchmarkCase sorting{container, "Sort", type, "random", n, 1, n};
+        runner.Run(sorting, build, [](C* c, long long, long long) { c->Sort(); }, release);
+        if constexpr (!is_same_v<C, LinkedList<T>>) {
+            sorting.operation = "StableSort";
+            runner.Run(sorting, build, [](C* c, long long, long long) { c->StableSort(); }, release);
+        }
+        if constexpr (is_same_v<C, MutableArraySequence<T>>) {
+            // The workaround Sort replaces: copy out, std::sort, rebuild.
+            sorting.operation = "SortViaVector";
+            runner.Run(sorting, build, [](C* c, long long, long long) {
+                vector<T> items(c->GetSize());
+                for (int i = 0; i < c->GetSize(); i++) {
+                    items[i] = c->Get(i);
+                }
+                std::sort(items.begin(), items.end());
+                MutableArraySequence<T>* sorted = new MutableArraySequence<T>();
+                for (const T& item : items) {
+                    sorted->Append(item);
+                }
+                delete sorted;
+            }, release);
+        }
+    }
+    delete fixture;
+}
+
+// Point lookups: SortedSequence and StaticSearchIndex against
+// std::lower_bound over a sorted vector, IndexedSequence against the linear
+// TryFind it replaces. Keys are Element::Make of random indices in [0, 2n), so about
+// half of them are present.
+template <class T>
+void RunSearchBenchmarks(BenchmarkRunner& runner, long long n) {
+    using Element = ElementTraits<T>;
+    const string type = Element::Name();
+    const int size = (int) n;
+    vector<T> values(size);
+    for (int i = 0; i < size; i++) {
+        values[i] = Element::Make(i);
+    }
+    vector<int> keyIndices = MakeIndexStream(AccessPattern::Random, 2 * n);
+    vector<T> keys(keyIndices.size());
+    for (size_t i = 0; i < keys.size(); i++) {
+        keys[i] = Element::Make(keyIndices[i]);
+    }
+    const size_t mask = keys.size() - 1;
+    BenchmarkCase lookup{"", "LowerBound", type, "random", n};
+
+    if (BenchmarkOptions::Selected(runner.Options().containers, "BinarySearch")) {
+        vector<T> sorted = values;
+        std::sort(sorted.begin(), sorted.end());
+        lookup.container = "BinarySearch";
+        runner.Run(lookup, [&]() { return &sorted; }, [&](vector<T>* s, long long begin, long long count) {
+            for (long long i = begin; i < begin + count; i++) {
+                int index = (int) (lower_bound(s->begin(), s->end(), keys[i & mask]) - s->begin());
+                DoNotOptimize(index);
+            }
+        }, [](vector<T>*) {});
+    }
+
+    if (BenchmarkOptions::Selected(runner.Options().containers, "SortedSequence")) {
+        SortedSequence<T> sorted(values.data(), size);
+        auto shared = [&]() { return &sorted; };
+        auto keep = [](SortedSequence<T>*) {};
+        lookup.container = "SortedSequence";
+        lookup.operation = "LowerBound";
+        runner.Run(lookup, shared, [&](SortedSequence<T>* s, long long begin, long long count) {
+            for (long long i = begin; i < begin + count; i++) {
+                int index = s->LowerBound(keys[i & mask]);
+                DoNotOptimize(index);
+            }
+        }, keep);
+
+        lookup.operation = "Contains";
+        runner.Run(lookup, shared, [&](SortedSequence<T>* s, long long begin, long long count) {
+            for (long long i = begin; i < begin + count; i++) {
+                bool found = s->Contains(keys[i & mask]);
+                DoNotOptimize(found);
+            }
+        }, keep);
+
+        // The linear scan Contains replaces.
+        lookup.operation = "TryFind";
+        runner.Run(lookup, shared, [&](SortedSequence<T>* s, long long begin, long long count) {
+            for (long long i = begin; i < begin + count; i++) {
+                const T& key = keys[i & mask];
+                T value;
+                bool found = s->TryFind([&key](T item) { return item == key; }, value);
+                DoNotOptimize(found);
+            }
+        }, keep);
+    }
+
+    if (BenchmarkOptions::Selected(runner.Options().containers, "StaticSearchIndex")) {
+        StaticSearchIndex<T> index(values.data(), size);
+        auto shared = [&]() { return &index; };
+        auto keep = [](StaticSearchIndex<T>*) {};
+        lookup.container = "StaticSearchIndex";
+        lookup.operation = "LowerBound";
+        runner.Run(lookup, shared, [&](StaticSearchIndex<T>* s, long long begin, long long count) {
+            for (long long i = begin; i < begin + count; i++) {
+                int found = s->LowerBound(keys[i & mask]);
+                DoNotOptimize(found);
+            }
+        }, keep);
+
+        lookup.operation = "Find";
+        runner.Run(lookup, shared, [&](StaticSearchIndex<T>* s, long long begin, long long count) {
+            for (long long i = begin; i < begin + count; i++) {
+                int found = s->Find(keys[i & mask]);
+                DoNotOptimize(found);
+            }
+        }, keep);
+
+        BenchmarkCase build{"StaticSearchIndex", "Build", type, "random", n, BenchmarkCase::Unbounded, n};
+        runner.Run(build, [&]() { return &values; }, [&](vector<T>* items, long long, long long count) {
+            for (long long k = 0; k < count; k++) {
+                StaticSearchIndex<T> built(items->data(), size);
+                DoNotOptimize(built);
+            }
+        }, [](vector<T>*) {});
+    }
+
+    if (BenchmarkOptions::Selected(runner.Options().containers, "IndexedSequence")) {
+        IndexedSequence<T> indexed(values.data(), size);
+        auto shared = [&]() { return &indexed; };
+        auto keep = [](IndexedSequence<T>*) {};
+        lookup.container = "IndexedSequence";
+        lookup.operation = "TryFind";
+        runner.Run(lookup, shared, [&](IndexedSequence<T>* s, long long begin, long long count) {
+            for (long long i = begin; i < begin + count; i++) {
+                T value;
+                bool found = s->TryFind(s->KeyEquals(keys[i & mask]), value);
+                DoNotOptimize(found);
+            }
+        }, keep);
+
+        lookup.operation = "Count";
+        runner.Run(lookup, shared, [&](IndexedSequence<T>* s, long long begin, long long count) {
+            for (long long i = begin; i < begin + count; i++) {
+                int found = s->Count(keys[i & mask]);
+                DoNotOptimize(found);
+            }
+        }, keep);
+    }
+
+    if (BenchmarkOptions::Selected(runner.Options().containers, "MutableArraySequence")) {
+        MutableArraySequence<T> plain(values.data(), size);
+        lookup.container = "MutableArraySequence";
+        lookup.operation = "TryFind";
+        runner.Run(lookup, [&]() { return &plain; }, [&](MutableArraySequence<T>* s, long long begin, long long count) {
+            for (long long i = begin; i < begin + count; i++) {
+                const T& key = keys[i & mask];
+                T value;
+                bool found = s->TryFind([&key](T item) { return item == key; }, value);
+                DoNotOptimize(found);
+            }
+        }, [](MutableArraySequence<T>*) {});
+    }
+}
+
+// Out-of-core passes over a sequence file in the system temp directory,
+// against a plain chunked read of the same file. Runs on a warm page cache,
+// so the gap between raw_read and Reduce is the cost of the pipeline itself.
+template <class T>
+void RunStreamingBenchmarks(BenchmarkRunner& runner, long long n) {
+    using Element = ElementTraits<T>;
+    const string container = "StreamingSequence";
+    const string type = Element::Name();
+    if (!BenchmarkOptions::Selected(runner.Options().containers, container)) {
+        return;
+    }
+    string path = (filesystem::temp_directory_path() / ("lab2_stream_" + type + ".seq")).string();
+    string output = path + ".out";
+    {
+        SequenceFileWriter<T> writer(path);
+        for (long long i = 0; i < n; i++) {
+            writer.Write(Element::Make(i));
+        }
+    }
+    StreamingSequence<T> sequence(path, 1 << 16);
+    auto shared = [&]() { return &sequence; };
+    auto keep = [](StreamingSequence<T>*) {};
+    BenchmarkCase pass{container, "raw_read", type, "sequential", n, BenchmarkCase::Unbounded, n, sizeof(T)};
+
+    runner.Run(pass, shared, [&](StreamingSequence<T>* s, long long, long long count) {
+        for (long long k = 0; k < count; k++) {
+            double rate = s->RawReadGBps();
+            DoNotOptimize(rate);
+        }
+    }, keep);
+
+    pass.operation = "Reduce";
+    runner.Run(pass, shared, [&](StreamingSequence<T>* s, long long, long long count) {
+        for (long long k = 0; k < count; k++) {
+            T value = s->Reduce(Element::Combine, T());
+            DoNotOptimize(value);
+        }
+    }, keep);
+
+    pass.operation = "Where";
+    runner.Run(pass, shared, [&](StreamingSequence<T>* s, long long, long long count) {
+        for (long long k = 0; k < count; k++) {
+            delete s->Where(Element::Keep, output);
+        }
+    }, keep);
+
+    remove(output.c_str());
+    remove(path.c_str());
+}
+
+// Range scans over time-ordered data (values appended in ascending order,
+// like timestamps), with and without zone maps; the pattern names the
+// fraction of elements the range selects.
+template <class T>
+void RunZoneMapBenchmarks(BenchmarkRunner& runner, long long n) {
+    using Element = ElementTraits<T>;
+    const string type = Element::Name();
+    vector<T> sorted(n);
+    for (long long i = 0; i < n; i++) {
+        sorted[i] = Element::Make(i);
+    }
+    std::sort(sorted.begin(), sorted.end());
+    for (bool zoneMaps : {false, true}) {
+        const string container = zoneMaps ? "SegmentedList+ZoneMap" : "SegmentedList";
+        if (!BenchmarkOptions::Selected(runner.Options().containers, container)) {
+            continue;
+        }
+        SegmentedList<T> list;
+        for (long long i = 0; i < n; i++) {
+            list.Append(sorted[i]);
+        }
+        if (zoneMaps) {
+            list.EnableZoneMaps();
+        }
+        auto shared = [&]() { return &list; };
+        auto keep = [](SegmentedList<T>*) {};
+        for (double selectivity : {0.001, 0.01, 0.1, 1.0}) {
+            long long selected = max(1LL, (long long) (selectivity * n));
+            long long first = (n - selected) / 2;
+            const T& lo = sorted[first];
+            const T& hi = sorted[first + selected - 1];
+            char pattern[16];
+            snprintf(pattern, sizeof(pattern), "%g%%", selectivity * 100);
+            BenchmarkCase range{container, "WhereInRange", type, pattern, n, BenchmarkCase::Unbounded, n};
+            runner.Run(range, shared, [&](SegmentedList<T>* l, long long, long long count) {
+                for (long long k = 0; k < count; k++) {
+                    delete l->WhereInRange(lo, hi);
+                }
+            }, keep);
+        }
+        const T& middle = sorted[n / 2];
+        BenchmarkCase find{container, "FindFirstGreaterThan", type, "50%", n, BenchmarkCase::Unbounded, n};
+        runner.Run(find, shared, [&](SegmentedList<T>* l, long long, long long count) {
+            for (long long k = 0; k < count; k++) {
+                int index = l->FindFirstGreaterThan(middle);
+                DoNotOptimize(index);
+            }
+        }, keep);
+    }
+}
+
+// LinkedList traversal with the nodes scattered over the heap and after
+// Compact(). The fragmented list appends values in random order and sorts
+// them, so its traversal order is a random walk through the allocations.
+template <class T>
+void RunCompactionBenchmarks(BenchmarkRunner& runner, long long n) {
+    using Element = ElementTraits<T>;
+    const string container = "LinkedList";
+    const string type = Element::Name();
+    const int size = (int) n;
+    if (!runner.Wants(container, "iterate", type, "fragmented")
+        && !runner.Wants(container, "iterate", type, "compacted")
+        && !runner.Wants(container, "Compact", type, "fragmented")) {
+        return;
+    }
+    vector<long long> order(n);
+    for (long long i = 0; i < n; i++) {
+        order[i] = i;
+    }
+    shuffle(order.begin(), order.end(), mt19937_64(42));
+    auto fragmented = [&]() {
+        LinkedList<T>* list = new LinkedList<T>();
+        for (long long i = 0; i < n; i++) {
+            list->Append(Element::Make(order[i]));
+        }
+        list->Sort();
+        return list;
+    };
+    auto release = [](LinkedList<T>* list) { delete list; };
+    auto scan = [&](LinkedList<T>* list, long long, long long count) {
+        for (long long k = 0; k < count; k++) {
+            for (int i = 0; i < size; i++) {
+                T value = list->Get(i);
+                DoNotOptimize(value);
+            }
+        }
+    };
+
+    LinkedList<T>* list = nullptr;
+    auto shared = [&]() { return list ? list : (list = fragmented()); };
+    auto keep = [](LinkedList<T>*) {};
+    BenchmarkCase pass{container, "iterate", type, "fragmented", n, BenchmarkCase::Unbounded, n};
+    runner.Run(pass, shared, scan, keep);
+
+    BenchmarkCase compact{container, "Compact", type, "fragmented", n, 1, n};
+    runner.Run(compact, fragmented, [](LinkedList<T>* l, long long, long long) { l->Compact(); }, release);
+
+    pass.pattern = "compacted";
+    runner.Run(pass, [&]() {
+        LinkedList<T>* l = shared();
+        l->Compact();
+        return l;
+    }, scan, keep);
+    delete list;
+}
+
+// Map -> Where -> Reduce and Map -> TryFind over a MutableArraySequence,
+// once through the Sequence operations, which build a sequence per step
+// ("materialized"), and once streamed through AsGenerator() ("generator").
+// The first element is a match for TryFind, so the generator stops after
+// one element while the materialized pipeline still maps all n.
+template <class T>
+void RunGeneratorBenchmarks(BenchmarkRunner& runner, long long n) {
+    using Element = ElementTraits<T>;
+    const string container = "MutableArraySequence";
+    const string type = Element::Name();
+    const int size = (int) n;
+    if (!BenchmarkOptions::Selected(runner.Options().containers, container)) {
+        return;
+    }
+    vector<T> values(size);
+    for (int i = 0; i < size; i++) {
+        values[i] = Element::Make(i);
+    }
+    auto build = [&]() { return new MutableArraySequence<T>(values.data(), size); };
+    auto release = [](MutableArraySequence<T>* s) { delete s; };
+    function<bool(T)> first = [](T) { return true; };
+
+    BenchmarkCase pipeline{container, "MapWhereReduce", type, "materialized", n, BenchmarkCase::Unbounded, n};
+    runner.Run(pipeline, build, [&](MutableArraySequence<T>* s, long long, long long count) {
+        for (long long k = 0; k < count; k++) {
+            Sequence<T>* mapped = s->Map(Element::Transform);
+            Sequence<T>* kept = mapped->Where(Element::Keep);
+            DoNotOptimize(kept->Reduce(Element::Combine, T()));
+            delete kept;
+            delete mapped;
+        }
+    }, release);
+    pipeline.pattern = "generator";
+    runner.Run(pipeline, build, [&](MutableArraySequence<T>* s, long long, long long count) {
+        for (long long k = 0; k < count; k++) {
+            DoNotOptimize(s->AsGenerator().Map(Element::Transform).Where(Element::Keep).Reduce(Element::Combine, T()));
+        }
+    }, release);
+
+    BenchmarkCase find{container, "MapTryFind", type, "materialized", n, BenchmarkCase::Unbounded, n};
+    runner.Run(find, build, [&](MutableArraySequence<T>* s, long long, long long count) {
+        for (long long k = 0; k < count; k++) {
+            Sequence<T>* mapped = s->Map(Element::Transform);
+            T value;
+            DoNotOptimize(mapped->TryFind(first, value));
+            delete mapped;
+        }
+    }, release);
+    find.pattern = "generator";
+    runner.Run(find, build, [&](MutableArraySequence<T>* s, long long, long long count) {
+        for (long long k = 0; k < count; k++) {
+            T value;
+            DoNotOptimize(s->AsGenerator().Map(Element::Transform).TryFind(first, value));
+        }
+    }, release);
+}
+
+// File-to-file external sort with the input at 1x, 4x and 16x the memory
+// budget; the pattern names the ratio. 1x sorts in memory with no spill.
+template <class T>
+void RunExternalSortBenchmarks(BenchmarkRunner& runner, long long n) {
+    using Element = ElementTraits<T>;
+    const string container = "ExternalSorter";
+    const string type = Element::Name();
+    if (!BenchmarkOptions::Selected(runner.Options().containers, container)) {
+        return;
+    }
+    string input = (filesystem::temp_directory_path() / ("lab2_sort_input_" + type + ".seq")).string();
+    string output = input + ".sorted";
+    {
+        SequenceFileWriter<T> writer(input);
+        for (long long i = 0; i < n; i++) {
+            writer.Write(Element::Make(i));
+        }
+    }
+    for (long long ratio : {1, 4, 16}) {
+        ExternalSortOptions options;
+        options.memoryBytes = max<size_t>(sizeof(T) * (size_t) n / ratio, 4096);
+        options.minMergeBufferBytes = 64u << 10;
+        ExternalSorter<T> sorter(options);
+        BenchmarkCase sort{container, "Sort", type, to_string(ratio) + "x", n, BenchmarkCase::Unbounded, n,
+                           2.0 * sizeof(T)};
+        runner.Run(sort, [&]() { return &sorter; }, [&](ExternalSorter<T>* s, long long, long long count) {
+            for (long long k = 0; k < count; k++) {
+                s->SortFile(input, output);
+            }
+        }, [](ExternalSorter<T>*) {});
+    }
+    remove(output.c_str());
+    remove(input.c_str());
+}
+
+// Scans over compressed integers: ascending ids with small gaps (packed
+// as deltas) and the element generator's hashed values (barely packable).
+// bytes_per_element gives the compression, gb_per_sec counts the bytes
+// the values would take uncompressed.
+template <class T>
+void RunPackedBenchmarks(BenchmarkRunner& runner, long long n) {
+    using Element = ElementTraits<T>;
+    const string container = "PackedIntSequence";
+    const string type = Element::Name();
+    if (!BenchmarkOptions::Selected(runner.Options().containers, container)) {
+        return;
+    }
+    vector<int> indices = MakeIndexStream(AccessPattern::Random, n);
+    const size_t mask = indices.size() - 1;
+    for (const char* pattern : {"sorted", "random"}) {
+        bool sorted = string(pattern) == "sorted";
+        PackedIntSequence<T> packed;
+        T id = 0;
+        for (long long i = 0; i < n; i++) {
+            id += (T) (1 + (Element::Make(i) & 15));
+            packed.Append(sorted ? id : Element::Make(i));
+        }
+        auto shared = [&]() { return &packed; };
+        auto keep = [](PackedIntSequence<T>*) {};
+        BenchmarkCase scan{container, "Reduce", type, pattern, n, BenchmarkCase::Unbounded, n, sizeof(T)};
+        runner.Run(scan, shared, [](PackedIntSequence<T>* s, long long, long long count) {
+            for (long long k = 0; k < count; k++) {
+                T sum = s->Reduce([](T a, T b) { return (T) (a + b); }, T());
+                DoNotOptimize(sum);
+            }
+        }, keep);
+
+        scan.operation = "Where";
+        runner.Run(scan, shared, [](PackedIntSequence<T>* s, long long, long long count) {
+            for (long long k = 0; k < count; k++) {
+                delete s->Where(Element::Keep);
+            }
+        }, keep);
+
+        BenchmarkCase get{container, "Get", type, string(pattern) + "-random", n};
+        runner.Run(get, shared, [&](PackedIntSequence<T>* s, long long begin, long long count) {
+            for (long long i = begin; i < begin + count; i++) {
+                T value = s->Get(indices[i & mask]);
+                DoNotOptimize(value);
+            }
+        }, keep);
+    }
+}
+
+// Synthetic runs of equal values, run length 1 to 10000 (the pattern),
+// run-length encoded and as a plain array.
+template <class T>
+void RunRleBenchmarks(BenchmarkRunner& runner, long long n) {
+    using Element = ElementTraits<T>;
+    const string type = Element::Name();
+    vector<int> indices = MakeIndexStream(AccessPattern::Random, n);
+    const size_t mask = indices.size() - 1;
+    for (long long runLength : {1, 10, 100, 1000, 10000}) {
+        if (runLength > n) {
+            break;
+        }
+        vector<T> values(n);
+        for (long long i = 0; i < n; i++) {
+            values[i] = Element::Make(i / runLength);
+        }
+        const string pattern = "run-" + to_string(runLength);
+        BenchmarkCase scan{"", "Reduce", type, pattern, n, BenchmarkCase::Unbounded, n};
+        BenchmarkCase get{"", "Get", type, pattern, n};
+
+        if (BenchmarkOptions::Selected(runner.Options().containers, "MutableArraySequence")) {
+            MutableArraySequence<T> array(values.data(), (int) n);
+            auto shared = [&]() { return &array; };
+            auto keep = [](MutableArraySequence<T>*) {};
+            scan.container = get.container = "MutableArraySequence";
+            runner.Run(scan, shared, [](MutableArraySequence<T>* s, long long, long long count) {
+                for (long long k = 0; k < count; k++) {
+                    T value = s->Reduce(Element::Combine, T());
+                    DoNotOptimize(value);
+                }
+            }, keep);
+            runner.Run(get, shared, [&](MutableArraySequence<T>* s, long long begin, long long count) {
+                for (long long i = begin; i < begin + count; i++) {
+                    T value = s->Get(indices[i & mask]);
+                    DoNotOptimize(value);
+                }
+            }, keep);
+        }
+
+        if (BenchmarkOptions::Selected(runner.Options().containers, "RleSequence")) {
+            RleSequence<T> rle(values.data(), (int) n);
+            auto shared = [&]() { return &rle; };
+            auto keep = [](RleSequence<T>*) {};
+            scan.container = get.container = "RleSequence";
+            scan.operation = "Reduce";
+            runner.Run(scan, shared, [](RleSequence<T>* s, long long, long long count) {
+                for (long long k = 0; k < count; k++) {
+                    T value = s->Reduce(Element::Combine, T());
+                    DoNotOptimize(value);
+                }
+            }, keep);
+            scan.operation = "Where";
+            runner.Run(scan, shared, [](RleSequence<T>* s, long long, long long count) {
+                for (long long k = 0; k < count; k++) {
+                    delete s->Where(Element::Keep);
+                }
+            }, keep);
+            scan.operation = "Map";
+            runner.Run(scan, shared, [](RleSequence<T>* s, long long, long long count) {
+                for (long long k = 0; k < count; k++) {
+                    delete s->Map(Element::Transform);
+                }
+            }, keep);
+            runner.Run(get, shared, [&](RleSequence<T>* s, long long begin, long long count) {
+                for (long long i = begin; i < begin + count; i++) {
+                    T value = s->Get(indices[i & mask]);
+                    DoNotOptimize(value);
+                }
+            }, keep);
+            scan.operation = "Append";
+            runner.Run(scan, []() { return new RleSequence<T>(); }, [&](RleSequence<T>* s, long long, long long count) {
+                for (long long k = 0; k < count; k++) {
+                    for (long long i = 0; i < n; i++) {
+                        s->Append(values[i]);
+                    }
+                }
+            }, [](RleSequence<T>* s) { delete s; });
+        }
+    }
+}
+
+// Flag arrays and masks: one byte per flag behind virtual calls against
+// BitSequence's word-at-a-time operations. Select gathers the elements of
+// an int sequence at the set positions.
+void RunMaskBenchmarks(BenchmarkRunner& runner) {
+    if (!BenchmarkOptions::Selected(runner.Options().types, "bool")) {
+        return;
+    }
+    const string type = "bool";
+    for (long long n : runner.Options().sizes) {
+        vector<int> values(n);
+        DynamicArray<bool> first((int) n);
+        DynamicArray<bool> second((int) n);
+        for (long long i = 0; i < n; i++) {
+            values[i] = ElementTraits<int>::Make(i);
+            first[(int) i] = (values[i] & 3) == 0;
+            second[(int) i] = (values[i] & 4) == 0;
+        }
+        BenchmarkCase scan{"", "Count", type, "random", n, BenchmarkCase::Unbounded, n};
+
+        if (BenchmarkOptions::Selected(runner.Options().containers, "MutableArraySequence") && n > 0) {
+            MutableArraySequence<bool> flags(&first[0], (int) n);
+            MutableArraySequence<bool> other(&second[0], (int) n);
+            auto shared = [&]() { return &flags; };
+            auto keep = [](MutableArraySequence<bool>*) {};
+            scan.container = "MutableArraySequence";
+            scan.operation = "Count";
+            runner.Run(scan, shared, [](MutableArraySequence<bool>* s, long long, long long count) {
+                for (long long k = 0; k < count; k++) {
+                    int total = 0;
+                    for (int i = 0; i < s->GetSize(); i++) {
+                        total += s->Get(i) ? 1 : 0;
+                    }
+                    DoNotOptimize(total);
+                }
+            }, keep);
+            scan.operation = "And";
+            runner.Run(scan, shared, [&other](MutableArraySequence<bool>* s, long long, long long count) {
+                for (long long k = 0; k < count; k++) {
+                    for (int i = 0; i < s->GetSize(); i++) {
+                        (*s)[i] = (*s)[i] && other[i];
+                    }
+                }
+            }, keep);
+        }
+
+        if (BenchmarkOptions::Selected(runner.Options().containers, "BitSequence")) {
+            BitSequence flags;
+            BitSequence other;
+            for (long long i = 0; i < n; i++) {
+                flags.Append(first[(int) i]);
+                other.Append(second[(int) i]);
+            }
+            MutableArraySequence<int> source(values.data(), (int) n);
+            auto shared = [&]() { return &flags; };
+            auto keep = [](BitSequence*) {};
+            scan.container = "BitSequence";
+            scan.operation = "Count";
+            runner.Run(scan, shared, [](BitSequence* s, long long, long long count) {
+                for (long long k = 0; k < count; k++) {
+                    int total = s->Count();
+                    DoNotOptimize(total);
+                }
+            }, keep);
+            scan.operation = "And";
+            runner.Run(scan, shared, [&other](BitSequence* s, long long, long long count) {
+                for (long long k = 0; k < count; k++) {
+                    s->And(&other);
+                }
+            }, keep);
+            scan.operation = "Select";
+            runner.Run(scan, shared, [&source](BitSequence* s, long long, long long count) {
+                for (long long k = 0; k < count; k++) {
+                    delete s->Select(&source);
+                }
+            }, keep);
+            BenchmarkCase rank{"BitSequence", "Rank", type, "random", n};
+            vector<int> indices = MakeIndexStream(AccessPattern::Random, n);
+            const size_t mask = indices.size() - 1;
+            runner.Run(rank, shared, [&](BitSequence* s, long long begin, long long count) {
+                for (long long i = begin; i < begin + count; i++) {
+                    int r = s->Rank(indices[i & mask]);
+                    DoNotOptimize(r);
+                }
+            }, keep);
+        }
+    }
+}
+
+// Trade records for the layout comparison: as a struct (32 bytes with
+// padding) and as one column per field.
+struct TradeRecord {
+    long long timestamp;
+    int id;
+    double price;
+    int quantity;
+};
+
+using TradeColumns = ColumnarSequence<long long, int, double, int>;
+
+// Array of structs against struct of arrays on scans that read one field
+// (quantity) or two (price and quantity). MutableArraySequence goes through
+// the Sequence API; ArrayOfStructs is a plain loop over the same layout, so
+// the gap between it and ColumnarSequence is the layout alone.
+void RunRecordBenchmarks(BenchmarkRunner& runner) {
+    if (!BenchmarkOptions::Selected(runner.Options().types, "record")) {
+        return;
+    }
+    const string type = "record";
+    for (long long n : runner.Options().sizes) {
+        vector<TradeRecord> source(n);
+        TradeColumns columns;
+        for (long long i = 0; i < n; i++) {
+            source[i] = TradeRecord{1700000000000LL + i, (int) i, 100.0 + (double) (i % 997) * 0.01, (int) (i % 100)};
+            columns.Append(source[i].timestamp, source[i].id, source[i].price, source[i].quantity);
+        }
+        MutableArraySequence<TradeRecord> records(source.data(), (int) n);
+        auto keepRecords = [](MutableArraySequence<TradeRecord>*) {};
+        auto keepColumns = [](TradeColumns*) {};
+        BenchmarkCase scan{"", "", type, "sequential", n, BenchmarkCase::Unbounded, n};
+
+        if (BenchmarkOptions::Selected(runner.Options().containers, "MutableArraySequence")) {
+            scan.container = "MutableArraySequence";
+            auto shared = [&]() { return &records; };
+            scan.operation = "ReduceOne";
+            runner.Run(scan, shared, [](MutableArraySequence<TradeRecord>* s, long long, long long count) {
+                for (long long k = 0; k < count; k++) {
+                    TradeRecord sum = s->Reduce([](TradeRecord a, TradeRecord b) {
+                        a.quantity += b.quantity;
+                        return a;
+                    }, TradeRecord{});
+                    DoNotOptimize(sum.quantity);
+                }
+            }, keepRecords);
+            scan.operation = "ReduceTwo";
+            runner.Run(scan, shared, [](MutableArraySequence<TradeRecord>* s, long long, long long count) {
+                for (long long k = 0; k < count; k++) {
+                    TradeRecord sum = s->Reduce([](TradeRecord a, TradeRecord b) {
+                        a.price += b.price * b.quantity;
+                        return a;
+                    }, TradeRecord{});
+                    DoNotOptimize(sum.price);
+                }
+            }, keepRecords);
+        }
+
+        if (BenchmarkOptions::Selected(runner.Options().containers, "ArrayOfStructs") && n > 0) {
+            scan.container = "ArrayOfStructs";
+            auto shared = [&]() { return &records; };
+            scan.operation = "ReduceOne";
+            runner.Run(scan, shared, [n](MutableArraySequence<TradeRecord>* s, long long, long long count) {
+                const TradeRecord* data = &(*s)[0];
+                for (long long k = 0; k < count; k++) {
+                    long long sum = 0;
+                    for (long long i = 0; i < n; i++) {
+                        sum += data[i].quantity;
+                    }
+                    DoNotOptimize(sum);
+                }
+            }, keepRecords);
+            scan.operation = "ReduceTwo";
+            runner.Run(scan, shared, [n](MutableArraySequence<TradeRecord>* s, long long, long long count) {
+                const TradeRecord* data = &(*s)[0];
+                for (long long k = 0; k < count; k++) {
+                    double sum = 0;
+                    for (long long i = 0; i < n; i++) {
+                        sum += data[i].price * data[i].quantity;
+                    }
+                    DoNotOptimize(sum);
+                }
+            }, keepRecords);
+        }
+
+        if (BenchmarkOptions::Selected(runner.Options().containers, "ColumnarSequence")) {
+            scan.container = "ColumnarSequence";
+            auto shared = [&]() { return &columns; };
+            scan.operation = "ReduceOne";
+            runner.Run(scan, shared, [](TradeColumns* s, long long, long long count) {
+                for (long long k = 0; k < count; k++) {
+                    long long sum = s->Reduce<3>([](long long total, int quantity) { return total + quantity; }, 0LL);
+                    DoNotOptimize(sum);
+                }
+            }, keepColumns);
+            scan.operation = "ReduceTwo";
+            runner.Run(scan, shared, [](TradeColumns* s, long long, long long count) {
+                for (long long k = 0; k < count; k++) {
+                    double sum = s->Reduce<2, 3>([](double total, double price, int quantity) {
+                        return total + price * quantity;
+                    }, 0.0);
+                    DoNotOptimize(sum);
+                }
+            }, keepColumns);
+            scan.operation = "WhereOne";
+            runner.Run(scan, shared, [](TradeColumns* s, long long, long long count) {
+                for (long long k = 0; k < count; k++) {
+                    delete s->Where<3>([](int quantity) { return quantity < 10; });
+                }
+            }, keepColumns);
+        }
+    }
+}
+
+struct HookedTradeRecord {
+    TradeRecord record;
+    IntrusiveHook hook;
+};
+
+using TradeList = IntrusiveList<HookedTradeRecord, &HookedTradeRecord::hook>;
+
+// Threading records that already exist: LinkedList allocates a node and
+// copies each record, IntrusiveList links the record's own hook.
+void RunIntrusiveBenchmarks(BenchmarkRunner& runner) {
+    if (!BenchmarkOptions::Selected(runner.Options().types, "record")) {
+        return;
+    }
+    const string type = "record";
+    for (long long n : runner.Options().sizes) {
+        vector<HookedTradeRecord> arena(n);
+        for (long long i = 0; i < n; i++) {
+            arena[i].record = TradeRecord{1700000000000LL + i, (int) i, 100.0 + (double) (i % 997) * 0.01, (int) (i % 100)};
+        }
+        BenchmarkCase append{"", "Append", type, "sequential", n, n, 1};
+
+        if (BenchmarkOptions::Selected(runner.Options().containers, "LinkedList")) {
+            append.container = "LinkedList";
+            runner.Run(append, []() { return new LinkedList<TradeRecord>(); },
+                       [&](LinkedList<TradeRecord>* l, long long begin, long long count) {
+                for (long long i = begin; i < begin + count; i++) {
+                    l->Append(arena[i].record);
+                }
+            }, [](LinkedList<TradeRecord>* l) { delete l; });
+        }
+
+        if (BenchmarkOptions::Selected(runner.Options().containers, "IntrusiveList")) {
+            append.container = "IntrusiveList";
+            auto release = [](TradeList* l) { delete l; };
+            runner.Run(append, []() { return new TradeList(); }, [&](TradeList* l, long long begin, long long count) {
+                for (long long i = begin; i < begin + count; i++) {
+                    l->Append(arena[i]);
+                }
+            }, release);
+
+            auto full = [&]() {
+                TradeList* l = new TradeList();
+                for (HookedTradeRecord& item : arena) {
+                    l->Append(item);
+                }
+                return l;
+            };
+            vector<int> order(n);
+            for (long long i = 0; i < n; i++) {
+                order[i] = (int) i;
+            }
+            shuffle(order.begin(), order.end(), mt19937_64(42));
+            BenchmarkCase remove{"IntrusiveList", "Remove", type, "random", n, n, 1};
+            runner.Run(remove, full, [&](TradeList* l, long long begin, long long count) {
+                for (long long i = begin; i < begin + count; i++) {
+                    l->Remove(arena[order[i]]);
+                }
+            }, release);
+
+            BenchmarkCase scan{"IntrusiveList", "ReduceOne", type, "sequential", n, BenchmarkCase::Unbounded, n};
+            runner.Run(scan, full, [](TradeList* l, long long, long long count) {
+                for (long long k = 0; k < count; k++) {
+                    long long sum = 0;
+                    l->ForEach([&sum](HookedTradeRecord& item) { sum += item.record.quantity; });
+                    DoNotOptimize(sum);
+                }
+            }, release);
+        }
+    }
+}
+
+// The work queue ConcurrentQueue replaces: a LinkedList behind a mutex.
+struct LockedLinkedList {
+    mutex lock;
+    LinkedList<int> list;
+
+    bool TryPush(int item) {
+        lock_guard<mutex> guard(lock);
+        list.Append(item);
+        return true;
+    }
+
+    bool TryPop(int& item) {
+        lock_guard<mutex> guard(lock);
+        if (list.GetSize() == 0) {
+            return false;
+        }
+        item = list.GetFirst();
+        list.RemoveAt(0);
+        return true;
+    }
+};
+
+// `threads` producers push `items` ints in total and as many consumers pop
+// them, `batch` at a time when the queue has TryPopBatch. Threads that
+// find the queue full or empty yield, so oversubscribed runs still move.
+template <class Queue>
+void TransferItems(Queue* queue, int threads, long long items, int batch) {
+    const long long share = items / threads;
+    atomic<long long> checksum{0};
+    vector<thread> workers;
+    for (int t = 0; t < threads; t++) {
+        workers.emplace_back([queue, share]() {
+            for (long long i = 0; i < share; i++) {
+                while (!queue->TryPush((int) i)) {
+                    this_thread::yield();
+                }
+            }
+        });
+        workers.emplace_back([queue, share, batch, &checksum]() {
+            int buffer[64];
+            long long received = 0;
+            long long sum = 0;
+            while (received < share) {
+                int got = 0;
+                if constexpr (requires { queue->TryPopBatch(buffer, 1); }) {
+                    got = batch > 1 ? queue->TryPopBatch(buffer, (int) min<long long>(batch, share - received))
+                                    : (queue->TryPop(buffer[0]) ? 1 : 0);
+                } else {
+                    got = queue->TryPop(buffer[0]) ? 1 : 0;
+                }
+                if (got == 0) {
+                    this_thread::yield();
+                    continue;
+                }
+                for (int i = 0; i < got; i++) {
+                    sum += buffer[i];
+                }
+                received += got;
+            }
+            checksum += sum;
+        });
+    }
+    for (thread& worker : workers) {
+        worker.join();
+    }
+    DoNotOptimize(checksum.load());
+}
+
+// Hand-off throughput with 1 to 32 producers and as many consumers; the
+// pattern is "producers x consumers" and each call moves QUEUE_ITEMS ints.
+void RunQueueBenchmarks(BenchmarkRunner& runner) {
+    if (!BenchmarkOptions::Selected(runner.Options().types, "int")) {
+        return;
+    }
+    const long long QUEUE_ITEMS = 1 << 18;
+    const int QUEUE_CAPACITY = 1024;
+    for (int threads : {1, 2, 4, 8, 16, 32}) {
+        const string pattern = to_string(threads) + "x" + to_string(threads);
+        BenchmarkCase transfer{"ConcurrentQueue", "PushPop", "int", pattern, QUEUE_ITEMS, BenchmarkCase::Unbounded, QUEUE_ITEMS};
+        auto queue = []() { return new ConcurrentQueue<int>(QUEUE_CAPACITY); };
+        auto release = [](ConcurrentQueue<int>* q) { delete q; };
+        runner.Run(transfer, queue, [&](ConcurrentQueue<int>* q, long long, long long count) {
+            for (long long k = 0; k < count; k++) {
+                TransferItems(q, threads, QUEUE_ITEMS, 1);
+            }
+        }, release);
+        transfer.operation = "PushPopBatch";
+        runner.Run(transfer, queue, [&](ConcurrentQueue<int>* q, long long, long long count) {
+            for (long long k = 0; k < count; k++) {
+                TransferItems(q, threads, QUEUE_ITEMS, 32);
+            }
+        }, release);
+
+        transfer.container = "LockedLinkedList";
+        transfer.operation = "PushPop";
+        runner.Run(transfer, []() { return new LockedLinkedList(); }, [&](LockedLinkedList* q, long long, long long count) {
+            for (long long k = 0; k < count; k++) {
+                TransferItems(q, threads, QUEUE_ITEMS, 1);
+            }
+        }, [](LockedLinkedList* q) { delete q; });
+    }
+}
+
+// The logging setup ConcurrentSegmentedList replaces: SegmentedList behind
+// a mutex.
+struct LockedSegmentedList {
+    mutex lock;
+    SegmentedList<int> list;
+
+    void Append(int item) {
+        lock_guard<mutex> guard(lock);
+        list.Append(item);
+    }
+};
+
+// Append throughput against writer threads (the pattern, "8w"); each call
+// appends LOG_ITEMS ints spread over the writers. AppendWithReader adds a
+// reader tailing the log, and reports how far it trails the writers: the
+// mean and worst count of reserved slots it had not read yet, sampled
+// after each pass.
+void RunLogBenchmarks(BenchmarkRunner& runner) {
+    if (!BenchmarkOptions::Selected(runner.Options().types, "int")) {
+        return;
+    }
+    const long long LOG_ITEMS = 1 << 20;
+    const long long CALLS_PER_LOG = 8;
+    for (int threads : {1, 2, 4, 8, 16, 32}) {
+        const string pattern = to_string(threads) + "w";
+        const long long share = LOG_ITEMS / threads;
+        auto write = [threads, share](auto* log) {
+            vector<thread> writers;
+            for (int t = 0; t < threads; t++) {
+                writers.emplace_back([log, share]() {
+                    for (long long i = 0; i < share; i++) {
+                        log->Append((int) i);
+                    }
+                });
+            }
+            for (thread& writer : writers) {
+                writer.join();
+            }
+        };
+
+        BenchmarkCase append{"ConcurrentSegmentedList", "Append", "int", pattern, LOG_ITEMS, CALLS_PER_LOG, LOG_ITEMS};
+        auto log = []() { return new ConcurrentSegmentedList<int>(); };
+        auto release = [](ConcurrentSegmentedList<int>* l) { delete l; };
+        runner.Run(append, log, [&](ConcurrentSegmentedList<int>* l, long long, long long count) {
+            for (long long k = 0; k < count; k++) {
+                write(l);
+            }
+        }, release);
+
+        append.operation = "AppendWithReader";
+        runner.Run(append, log, [&](ConcurrentSegmentedList<int>* l, long long, long long count) {
+            double lagTotal = 0;
+            double lagMax = 0;
+            long long samples = 0;
+            for (long long k = 0; k < count; k++) {
+                int position = l->GetCommittedSize();
+                int target = position + (int) (share * threads);
+                thread reader([&]() {
+                    long long sum = 0;
+                    while (position < target) {
+                        position = l->ForEach(position, [&sum](int value) { sum += value; });
+                        double lag = (double) (l->GetReservedSize() - position);
+                        lagTotal += lag;
+                        lagMax = lag > lagMax ? lag : lagMax;
+                        samples++;
+                        if (position < target) {
+                            this_thread::yield();
+                        }
+                    }
+                    DoNotOptimize(sum);
+                });
+                write(l);
+                reader.join();
+            }
+            runner.Metric("reader_lag_mean", samples > 0 ? lagTotal / samples : 0);
+            runner.Metric("reader_lag_max", lagMax);
+        }, release);
+
+        append.container = "LockedSegmentedList";
+        append.operation = "Append";
+        runner.Run(append, []() { return new LockedSegmentedList(); }, [&](LockedSegmentedList* l, long long, long long count) {
+            for (long long k = 0; k < count; k++) {
+                write(l);
+            }
+        }, [](LockedSegmentedList* l) { delete l; });
+    }
+}
+
+// The setup ShardedArraySequence replaces: one MutableArraySequence behind
+// one reader/writer lock.
+struct LockedArraySequence {
+    shared_mutex lock;
+    MutableArraySequence<int>* sequence;
+
+    explicit LockedArraySequence(MutableArraySequence<int>* sequence) : sequence(sequence) {}
+
+    ~LockedArraySequence() {
+        delete sequence;
+    }
+
+    int Get(int index) {
+        shared_lock<shared_mutex> guard(lock);
+        return sequence->Get(index);
+    }
+
+    void Set(int index, int item) {
+        unique_lock<shared_mutex> guard(lock);
+        (*sequence)[index] = item;
+    }
+};
+
+// Splits `operations` random Gets and Sets on `table` over `threads` threads;
+// `writePercent` of the operations are Sets.
+template <class Table>
+void MixedAccess(Table* table, int threads, int writePercent, long long size, long long operations) {
+    vector<thread> workers;
+    atomic<long long> checksum{0};
+    for (int t = 0; t < threads; t++) {
+        workers.emplace_back([&, t]() {
+            // An inline LCG: a precomputed index stream per thread would
+            // cost more to build than the accesses it drives.
+            uint64_t state = 42 + t;
+            long long sum = 0;
+            for (long long i = 0; i < operations / threads; i++) {
+                state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+                int index = (int) ((state >> 33) % (uint64_t) size);
+                if ((i * 7 + t) % 100 < writePercent) {
+                    table->Set(index, (int) i);
+                } else {
+                    sum += table->Get(index);
+                }
+            }
+            checksum += sum;
+        });
+    }
+    for (thread& worker : workers) {
+        worker.join();
+    }
+    DoNotOptimize(checksum.load());
+}
+
+// Random reads and writes from 1 to 32 threads over SHARDED_SIZE ints (the
+// pattern, "8t10w", is threads and percent of writes), appends one at a
+// time against chunked reservations, and the parallel Map and Reduce
+// against MutableArraySequence's sequential ones.
+void RunShardedBenchmarks(BenchmarkRunner& runner) {
+    if (!BenchmarkOptions::Selected(runner.Options().types, "int")) {
+        return;
+    }
+    const int SHARDED_SIZE = 1 << 20;
+    const long long MIXED_OPS = 1 << 18;
+    const int APPEND_CHUNK = 256;
+    vector<int> items(SHARDED_SIZE);
+    for (int i = 0; i < SHARDED_SIZE; i++) {
+        items[i] = i;
+    }
+    auto sharded = [&items]() { return new ShardedArraySequence<int>(items.data(), (int) items.size()); };
+    auto releaseSharded = [](ShardedArraySequence<int>* s) { delete s; };
+    for (int threads : {1, 2, 4, 8, 16, 32}) {
+        for (int writePercent : {10, 50}) {
+            const string pattern = to_string(threads) + "t" + to_string(writePercent) + "w";
+            BenchmarkCase mixed{"ShardedArraySequence", "GetSet", "int", pattern, SHARDED_SIZE, BenchmarkCase::Unbounded, MIXED_OPS};
+            runner.Run(mixed, sharded, [&](ShardedArraySequence<int>* s, long long, long long count) {
+                for (long long k = 0; k < count; k++) {
+                    MixedAccess(s, threads, writePercent, SHARDED_SIZE, MIXED_OPS);
+                }
+            }, releaseSharded);
+
+            mixed.container = "LockedArraySequence";
+            runner.Run(mixed, [&items]() {
+                return new LockedArraySequence(new MutableArraySequence<int>(items.data(), (int) items.size()));
+            }, [&](LockedArraySequence* s, long long, long long count) {
+                for (long long k = 0; k < count; k++) {
+                    MixedAccess(s, threads, writePercent, SHARDED_SIZE, MIXED_OPS);
+                }
+            }, [](LockedArraySequence* s) { delete s; });
+        }
+
+        const string pattern = to_string(threads) + "w";
+        const long long share = MIXED_OPS / threads;
+        BenchmarkCase append{"ShardedArraySequence", "Append", "int", pattern, MIXED_OPS, 8, MIXED_OPS};
+        auto empty = []() { return new ShardedArraySequence<int>(); };
+        runner.Run(append, empty, [&](ShardedArraySequence<int>* s, long long, long long count) {
+            for (long long k = 0; k < count; k++) {
+                vector<thread> writers;
+                for (int t = 0; t < threads; t++) {
+                    writers.emplace_back([s, share]() {
+                        for (long long i = 0; i < share; i++) {
+                            s->Append((int) i);
+                        }
+                    });
+                }
+                for (thread& writer : writers) {
+                    writer.join();
+                }
+            }
+        }, releaseSharded);
+
+        append.operation = "AppendChunked";
+        runner.Run(append, empty, [&](ShardedArraySequence<int>* s, long long, long long count) {
+            for (long long k = 0; k < count; k++) {
+                vector<thread> writers;
+                for (int t = 0; t < threads; t++) {
+                    writers.emplace_back([s, share, &items]() {
+                        for (long long i = 0; i < share; i += APPEND_CHUNK) {
+                            s->AppendRange(items.data(), (int) min<long long>(APPEND_CHUNK, share - i));
+                        }
+                    });
+                }
+                for (thread& writer : writers) {
+                    writer.join();
+                }
+            }
+        }, releaseSharded);
+    }
+
+    BenchmarkCase bulk{"ShardedArraySequence", "Reduce", "int", "parallel", SHARDED_SIZE, BenchmarkCase::Unbounded, SHARDED_SIZE};
+    runner.Run(bulk, sharded, [](ShardedArraySequence<int>* s, long long, long long count) {
+        for (long long k = 0; k < count; k++) {
+            DoNotOptimize(s->Reduce([](int a, int b) { return a ^ b; }, 0));
+        }
+    }, releaseSharded);
+    bulk.operation = "Map";
+    runner.Run(bulk, sharded, [](ShardedArraySequence<int>* s, long long, long long count) {
+        for (long long k = 0; k < count; k++) {
+            MutableArraySequence<int>* mapped = s->Map([](int a) { return a * 3 + 1; });
+            DoNotOptimize(mapped->GetSize());
+            delete mapped;
+        }
+    }, releaseSharded);
+
+    bulk.container = "MutableArraySequence";
+    // Not "sequential": RunContainerBenchmarks records that key, and its size
+    // history would make the runner predict these cases over budget.
+    bulk.pattern = "sequential-single-thread";
+    bulk.operation = "Reduce";
+    auto array = [&items]() { return new MutableArraySequence<int>(items.data(), (int) items.size()); };
+    auto releaseArray = [](MutableArraySequence<int>* s) { delete s; };
+    runner.Run(bulk, array, [](MutableArraySequence<int>* s, long long, long long count) {
+        for (long long k = 0; k < count; k++) {
+            DoNotOptimize(s->Reduce([](int a, int b) { return a ^ b; }, 0));
+        }
+    }, releaseArray);
+    bulk.operation = "Map";
+    runner.Run(bulk, array, [](MutableArraySequence<int>* s, long long, long long count) {
+        for (long long k = 0; k < count; k++) {
+            Sequence<int>* mapped = s->Map([](int a) { return a * 3 + 1; });
+            DoNotOptimize(mapped->GetSize());
+            delete mapped;
+        }
+    }, releaseArray);
+}
+
+template <class T>
+void RunTypeBenchmarks(BenchmarkRunner& runner) {
+    if (!BenchmarkOptions::Selected(runner.Options().types, ElementTraits<T>::Name())) {
+        return;
+    }
+    for (long long n : runner.Options().sizes) {
+        RunContainerBenchmarks<DynamicArray<T>, T>(runner, n);
+        RunContainerBenchmarks<LinkedList<T>, T>(runner, n);
+        RunContainerBenchmarks<LinkedList<T, true>, T>(runner, n);
+        RunContainerBenchmarks<SegmentedList<T>, T>(runner, n);
+        RunContainerBenchmarks<MutableArraySequence<T>, T>(runner, n);
+        RunContainerBenchmarks<ImmutableArraySequence<T>, T>(runner, n);
+        RunContainerBenchmarks<MutableListSequence<T>, T>(runner, n);
+        RunContainerBenchmarks<SkipList<T>, T>(runner, n);
+        RunContainerBenchmarks<MutableListSequence<T, SkipList<T>>, T>(runner, n);
+        RunContainerBenchmarks<ImmutableListSequence<T>, T>(runner, n);
+        RunContainerBenchmarks<AdaptiveSequence<T>, T>(runner, n);
+        RunContainerBenchmarks<SortedSequence<T>, T>(runner, n);
+        RunContainerBenchmarks<IndexedSequence<T>, T>(runner, n);
+        RunSearchBenchmarks<T>(runner, n);
+        RunCompactionBenchmarks<T>(runner, n);
+        RunGeneratorBenchmarks<T>(runner, n);
+        RunZoneMapBenchmarks<T>(runner, n);
+        RunRleBenchmarks<T>(runner, n);
+        if constexpr (is_integral_v<T>) {
+            RunPackedBenchmarks<T>(runner, n);
+        }
+        if constexpr (is_trivially_copyable_v<T>) {
+            RunStreamingBenchmarks<T>(runner, n);
+            RunExternalSortBenchmarks<T>(runner, n);
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    BenchmarkRunner runner(BenchmarkOptions::Parse(argc, argv));
+    RunTypeBenchmarks<int>(runner);
+    RunTypeBenchmarks<double>(runner);
+    RunTypeBenchmarks<string>(runner);
+    RunMaskBenchmarks(runner);
+    RunRecordBenchmarks(runner);
+    RunIntrusiveBenchmarks(runner);
+    RunQueueBenchmarks(runner);
+    RunLogBenchmarks(runner);
+    RunShardedBenchmarks(runner);
+    runner.Report();
+    return 0;
+}
@@ -0,0 +1,158 @@
+#include <vector>
+
+#include "BitSequence.h"
+#include "Check.h"
+#include "IndexOutOfRange.h"
+#include "MutableArraySequence.h"
+
+vector<bool> RandomBits(int count) {
+    vector<bool> bits;
+    for (int i = 0; i < count; i++) {
+        bits.push_back(RandomInt(0, 2) == 0);
+    }
+    return bits;
+}
+
+BitSequence* MakeBits(const vector<bool>& bits) {
+    BitSequence* sequence = new BitSequence();
+    for (bool bit : bits) {
+        sequence->Append(bit);
+    }
+    return sequence;
+}
+
+void TestEdits() {
+    BitSequence sequence;
+    vector<bool> expected;
+    for (int step = 0; step < 3000; step++) {
+        bool bit = RandomInt(0, 1) == 1;
+        int choice = RandomInt(0, 3);
+        if (choice < 2) {
+            sequence.Append(bit);
+            expected.push_back(bit);
+        } else if (choice < 3) {
+            int index = RandomInt(0, (int) expected.size());
+            sequence.Insert(bit, index);
+            expected.insert(expected.begin() + index, bit);
+        } else if (!expected.empty()) {
+            int index = RandomInt(0, (int) expected.size() - 1);
+            sequence.Set(index, bit);
+            expected[index] = bit;
+        }
+    }
+    CHECK(SameElements(&sequence, expected));
+}
+
+void TestWordOperations() {
+    int count = 1000;
+    vector<bool> a = RandomBits(count);
+    vector<bool> b = RandomBits(count);
+    BitSequence* and_ = MakeBits(a);
+    BitSequence* or_ = MakeBits(a);
+    BitSequence* xor_ = MakeBits(a);
+    BitSequence* not_ = MakeBits(a);
+    BitSequence* other = MakeBits(b);
+    and_->And(other);
+    or_->Or(other);
+    xor_->Xor(other);
+    not_->Not();
+    vector<bool> expectedAnd, expectedOr, expectedXor, expectedNot;
+    int ones = 0;
+    for (int i = 0; i < count; i++) {
+        expectedAnd.push_back(a[i] && b[i]);
+        expectedOr.push_back(a[i] || b[i]);
+        expectedXor.push_back(a[i] != b[i]);
+        expectedNot.push_back(!a[i]);
+        ones += a[i] ? 1 : 0;
+    }
+    CHECK(SameElements(and_, expectedAnd));
+    CHECK(SameElements(or_, expectedOr));
+    CHECK(SameElements(xor_, expectedXor));
+    CHECK(SameElements(not_, expectedNot));
+    // Not must leave the bits past the end clear.
+    CHECK(not_->Count() == count - ones);
+
+    BitSequence* left = MakeBits(a);
+    Sequence<bool>* zipped = left->Zip(other, [](bool x, bool y) { return x && !y; });
+    for (int i = 0; i < count; i++) {
+        CHECK(zipped->Get(i) == (a[i] && !b[i]));
+    }
+    delete zipped;
+    delete left;
+    delete other;
+    delete not_;
+    delete xor_;
+    delete or_;
+    delete and_;
+}
+
+void TestRankSelect() {
+    vector<bool> bits = RandomBits(5000);
+    BitSequence* sequence = MakeBits(bits);
+    int rank = 0;
+    vector<int> setPositions;
+    for (int i = 0; i <= (int) bits.size(); i++) {
+        CHECK(sequence->Rank(i) == rank);
+        if (i < (int) bits.size() && bits[i]) {
+            setPositions.push_back(i);
+            rank++;
+        }
+    }
+    for (int k = 0; k < (int) setPositions.size(); k++) {
+        CHECK(sequence->Select(k) == setPositions[k]);
+    }
+    CHECK(sequence->Select((int) setPositions.size()) == -1);
+    CHECK(sequence->FindFirstSet() == (setPositions.empty() ? -1 : setPositions[0]));
+
+    // Ranks are rebuilt after a change.
+    sequence->Set(0, !bits[0]);
+    CHECK(sequence->Rank((int) bits.size()) == rank + (bits[0] ? -1 : 1));
+    CHECK_THROWS(sequence->Rank((int) bits.size() + 1), IndexOutOfRange);
+    delete sequence;
+}
+
+void TestMaskSelect() {
+    vector<int> values;
+    for (int i = 0; i < 700; i++) {
+        values.push_back(RandomInt(0, 100));
+    }
+    MutableArraySequence<int> prices(values.data(), (int) values.size());
+    int limit = 90;
+    BitSequence* mask = BitSequence::FromPredicate(&prices, [limit](int x) { return x > limit; });
+    MutableArraySequence<int>* selected = mask->Select<int>(&prices);
+    vector<int> expected;
+    for (int v : values) {
+        if (v > 90) {
+            expected.push_back(v);
+        }
+    }
+    CHECK(mask->Count() == (int) expected.size());
+    CHECK(SameElements(selected, expected));
+
+    // A mask can be combined with another and selected through repeatedly.
+    BitSequence* even = BitSequence::FromPredicate(&prices, function<bool(int)>([](int x) { return x % 2 == 0; }));
+    even->And(mask);
+    MutableArraySequence<int>* both = even->Select<int>(&prices);
+    MutableArraySequence<int>* again = even->Select<int>(&prices);
+    vector<int> expectedBoth;
+    for (int v : expected) {
+        if (v % 2 == 0) {
+            expectedBoth.push_back(v);
+        }
+    }
+    CHECK(SameElements(both, expectedBoth));
+    CHECK(SameElements(again, expectedBoth));
+    delete again;
+    delete both;
+    delete even;
+    delete selected;
+    delete mask;
+}
+
+int main() {
+    TestEdits();
+    TestWordOperations();
+    TestRankSelect();
+    TestMaskSelect();
+    return TestStatus();
+}
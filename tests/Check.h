@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstdio>
+#include <filesystem>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+using namespace std;
+
+// The assertions the test programs in this directory share. Each test is
+// its own executable: main() runs its cases and returns TestStatus(), which
+// is non-zero when any check failed, and ctest reports that.
+//
+// Checks keep going after a failure so one run shows every broken case;
+// only the first MAX_REPORTED failures are printed.
+
+const int MAX_REPORTED = 20;
+
+inline int& FailedChecks() {
+    static int failed = 0;
+    return failed;
+}
+
+inline void Check(bool condition, const char* expression, const char* file, int line) {
+    if (condition) {
+        return;
+    }
+    if (++FailedChecks() <= MAX_REPORTED) {
+        fprintf(stderr, "%s:%d: check failed: %s\n", file, line, expression);
+    }
+}
+
+#define CHECK(condition) Check((condition), #condition, __FILE__, __LINE__)
+
+#define CHECK_THROWS(expression, Exception)                                         \
+    do {                                                                            \
+        bool thrown = false;                                                        \
+        try {                                                                       \
+            (void) (expression);                                                    \
+        } catch (const Exception&) {                                                \
+            thrown = true;                                                          \
+        }                                                                           \
+        Check(thrown, #expression " throws " #Exception, __FILE__, __LINE__);       \
+    } while (0)
+
+inline int TestStatus() {
+    if (FailedChecks() > 0) {
+        fprintf(stderr, "%d check(s) failed\n", FailedChecks());
+        return 1;
+    }
+    return 0;
+}
+
+// A fixed seed per test, so a failure reproduces.
+inline mt19937& TestRandom() {
+    static mt19937 random(20240601);
+    return random;
+}
+
+inline int RandomInt(int low, int high) {
+    return uniform_int_distribution<int>(low, high)(TestRandom());
+}
+
+// True when `sequence` holds exactly `expected`, read through Get.
+template <class S, class T>
+bool SameElements(S* sequence, const vector<T>& expected) {
+    if (sequence->GetSize() != (int) expected.size()) {
+        return false;
+    }
+    for (int i = 0; i < (int) expected.size(); i++) {
+        if (!(sequence->Get(i) == expected[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// A file name in the temp directory unique to this process, so tests run
+// in parallel by ctest do not share files. Callers remove it.
+inline string TempPath(const string& name) {
+    return (filesystem::temp_directory_path() / ("lab2_" + to_string(getpid()) + "_" + name)).string();
+}
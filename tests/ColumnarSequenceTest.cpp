@@ -0,0 +1,131 @@
+#include <tuple>
+#include <vector>
+
+#include "Check.h"
+#include "ColumnarSequence.h"
+#include "IndexOutOfRange.h"
+
+using Trades = ColumnarSequence<long long, int, double, int>;
+using Trade = Trades::Row;
+
+const int COUNT = 1000;
+
+Trades* RandomTrades(vector<Trade>& expected) {
+    Trades* trades = new Trades();
+    for (int i = 0; i < COUNT; i++) {
+        Trade trade((long long) i * 1000, RandomInt(0, 99), RandomInt(0, 400) / 4.0, RandomInt(1, 10));
+        trades->Append(trade);
+        expected.push_back(trade);
+    }
+    return trades;
+}
+
+bool SameRows(const Trades& trades, const vector<Trade>& expected) {
+    if (trades.GetSize() != (int) expected.size()) {
+        return false;
+    }
+    for (int i = 0; i < (int) expected.size(); i++) {
+        if (trades.Get(i) != expected[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void TestMapReduce() {
+    vector<Trade> expected;
+    Trades* trades = RandomTrades(expected);
+    CHECK(SameRows(*trades, expected));
+
+    // Two columns at once, in the order they are named.
+    MutableArraySequence<double>* notional = trades->Map<2, 3>([](double price, int qty) { return price * qty; });
+    double volume = 0;
+    bool same = notional->GetSize() == COUNT;
+    for (int i = 0; i < COUNT && same; i++) {
+        double value = get<2>(expected[i]) * get<3>(expected[i]);
+        same = notional->Get(i) == value;
+        volume += value;
+    }
+    CHECK(same);
+    delete notional;
+    double reduced = trades->Reduce<2, 3>([](double sum, double price, int qty) { return sum + price * qty; }, 0.0);
+    CHECK(reduced == volume);
+
+    long long weighted = 0;
+    for (const Trade& trade : expected) {
+        weighted += (long long) get<1>(trade) * get<3>(trade) - get<0>(trade);
+    }
+    long long mixed = trades->Reduce<3, 0, 1>([](long long sum, int qty, long long time, int id) {
+        return sum + (long long) id * qty - time;
+    }, 0LL);
+    CHECK(mixed == weighted);
+    delete trades;
+}
+
+void TestWhere() {
+    vector<Trade> expected;
+    Trades* trades = RandomTrades(expected);
+    vector<Trade> matching;
+    for (const Trade& trade : expected) {
+        if (get<1>(trade) % 2 == 0 && get<3>(trade) > 5) {
+            matching.push_back(trade);
+        }
+    }
+    Trades* selected = trades->Where<1, 3>([](int id, int qty) { return id % 2 == 0 && qty > 5; });
+    CHECK(SameRows(*selected, matching));
+    delete selected;
+
+    Trades* none = trades->Where<2>([](double price) { return price < 0; });
+    CHECK(none->GetSize() == 0);
+    delete none;
+
+    Trades empty;
+    Trades* fromEmpty = empty.Where<0>([](long long) { return true; });
+    CHECK(fromEmpty->GetSize() == 0);
+    fromEmpty->Append(1, 2, 3.0, 4);
+    CHECK(fromEmpty->Get(0) == Trade(1, 2, 3.0, 4));
+    delete fromEmpty;
+    MutableArraySequence<int>* mapped = empty.Map<1>([](int id) { return id; });
+    CHECK(mapped->GetSize() == 0);
+    delete mapped;
+    int total = empty.Reduce<3>([](int sum, int qty) { return sum + qty; }, 7);
+    CHECK(total == 7);
+    delete trades;
+}
+
+void TestRowRefAndCopy() {
+    vector<Trade> expected;
+    Trades* trades = RandomTrades(expected);
+
+    (*trades)[5].Field<2>() = 1.25;
+    get<2>(expected[5]) = 1.25;
+    (*trades)[7] = Trade(-1, -2, -3.5, -4);
+    expected[7] = Trade(-1, -2, -3.5, -4);
+    Trade read = (*trades)[7];
+    CHECK(read == expected[7]);
+    CHECK(trades->GetField<2>(5) == 1.25);
+    CHECK(SameRows(*trades, expected));
+
+    // The copy owns its columns.
+    Trades copy(*trades);
+    (*trades)[0].Field<1>() = 12345;
+    trades->Append(9, 9, 9.0, 9);
+    CHECK(SameRows(copy, expected));
+    CHECK(copy.Column<1>()[0] == get<1>(expected[0]));
+
+    Trades empty;
+    Trades emptyCopy(empty);
+    CHECK(emptyCopy.GetSize() == 0);
+
+    CHECK_THROWS(trades->Get(COUNT + 1), IndexOutOfRange);
+    CHECK_THROWS((*trades)[-1], IndexOutOfRange);
+    CHECK_THROWS(copy.GetField<0>(COUNT), IndexOutOfRange);
+    delete trades;
+}
+
+int main() {
+    TestMapReduce();
+    TestWhere();
+    TestRowRefAndCopy();
+    return TestStatus();
+}
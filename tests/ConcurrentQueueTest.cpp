@@ -0,0 +1,93 @@
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "Check.h"
+#include "ConcurrentQueue.h"
+
+void TestSingleThread() {
+    ConcurrentQueue<int> queue(5);
+    CHECK(queue.GetCapacity() == 8);
+    int item = 0;
+    CHECK(!queue.TryPop(item));
+    for (int i = 0; i < 8; i++) {
+        CHECK(queue.TryPush(i));
+    }
+    CHECK(!queue.TryPush(8));
+    CHECK(queue.ApproximateSize() == 8);
+    CHECK(queue.TryPop(item) && item == 0);
+    int batch[16];
+    CHECK(queue.TryPopBatch(batch, 3) == 3 && batch[0] == 1 && batch[2] == 3);
+    CHECK(queue.TryPopBatch(batch, 16) == 4 && batch[3] == 7);
+    CHECK(queue.TryPopBatch(batch, 16) == 0);
+    CHECK_THROWS(ConcurrentQueue<int>(0), std::invalid_argument);
+}
+
+// Producers push (producer, sequence number) pairs through a small queue
+// so it wraps many times; consumers, half of them popping in batches,
+// check that each producer's items arrive in order and none is lost or
+// duplicated.
+void TestProducersConsumers() {
+    const int PRODUCERS = 3;
+    const int CONSUMERS = 3;
+    const int PER_PRODUCER = 20000;
+    ConcurrentQueue<long long> queue(64);
+    atomic<int> consumed{0};
+    vector<vector<int>> seen(CONSUMERS, vector<int>(PRODUCERS, -1));
+    atomic<bool> ordered{true};
+    vector<atomic<int>> counts(PRODUCERS);
+
+    vector<thread> threads;
+    for (int p = 0; p < PRODUCERS; p++) {
+        threads.emplace_back([&, p]() {
+            for (int i = 0; i < PER_PRODUCER; i++) {
+                while (!queue.TryPush((long long) p << 32 | i)) {
+                    this_thread::yield();
+                }
+            }
+        });
+    }
+    for (int c = 0; c < CONSUMERS; c++) {
+        threads.emplace_back([&, c]() {
+            long long items[8];
+            while (consumed.load() < PRODUCERS * PER_PRODUCER) {
+                int count = 0;
+                if (c % 2 == 0) {
+                    count = queue.TryPop(items[0]) ? 1 : 0;
+                } else {
+                    count = queue.TryPopBatch(items, 8);
+                }
+                if (count == 0) {
+                    this_thread::yield();
+                    continue;
+                }
+                for (int k = 0; k < count; k++) {
+                    int producer = (int) (items[k] >> 32);
+                    int sequence = (int) (items[k] & 0xFFFFFFFF);
+                    if (sequence <= seen[c][producer]) {
+                        ordered = false;
+                    }
+                    seen[c][producer] = sequence;
+                    counts[producer]++;
+                }
+                consumed += count;
+            }
+        });
+    }
+    for (thread& t : threads) {
+        t.join();
+    }
+    CHECK(ordered.load());
+    CHECK(consumed.load() == PRODUCERS * PER_PRODUCER);
+    for (int p = 0; p < PRODUCERS; p++) {
+        CHECK(counts[p].load() == PER_PRODUCER);
+    }
+    long long item = 0;
+    CHECK(!queue.TryPop(item));
+}
+
+int main() {
+    TestSingleThread();
+    TestProducersConsumers();
+    return TestStatus();
+}
@@ -0,0 +1,108 @@
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Check.h"
+#include "ConcurrentSegmentedList.h"
+#include "IndexOutOfRange.h"
+
+void TestSingleThread() {
+    ConcurrentSegmentedList<int> list;
+    CHECK(list.GetSize() == 0);
+    CHECK_THROWS(list.Get(0), IndexOutOfRange);
+    int count = ConcurrentSegmentedList<int>::SEGMENT_SIZE * 2 + 10;
+    for (int i = 0; i < count; i++) {
+        CHECK(list.Append(i * 3) == i);
+    }
+    CHECK(list.GetSize() == count);
+    CHECK(list.GetReservedSize() == count);
+    bool same = true;
+    int next = 0;
+    int stopped = list.ForEach(5, [&](const int& value) {
+        same = same && value == (5 + next++) * 3;
+    });
+    CHECK(same && stopped == count && next == count - 5);
+    CHECK(list.Get(count - 1) == (count - 1) * 3);
+    CHECK_THROWS(list.Get(count), IndexOutOfRange);
+    CHECK_THROWS(list.Get(-1), IndexOutOfRange);
+}
+
+// No default constructor, and a destructor that has to run.
+struct Event {
+    string name;
+    int id;
+
+    Event(string name, int id) : name(std::move(name)), id(id) {}
+};
+
+void TestElementTypes() {
+    ConcurrentSegmentedList<Event> list;
+    int count = ConcurrentSegmentedList<Event>::SEGMENT_SIZE + 100;
+    for (int i = 0; i < count; i++) {
+        list.Append(Event("event number " + to_string(i), i));
+    }
+    CHECK(list.Get(count - 1).id == count - 1);
+    CHECK(list.Get(7).name == "event number 7");
+
+    // Only the segments in use and one directory page are allocated.
+    CollectionFootprint footprint = list.MemoryFootprint();
+    CHECK(footprint.allocationCount <= 4);
+    CHECK(footprint.TotalBytes() < sizeof(Event) * 4 * ConcurrentSegmentedList<Event>::SEGMENT_SIZE);
+}
+
+// Four appenders write values >= 1 while a reader tails the log: nothing
+// below the committed size may still be unwritten (0), and in the end
+// every appended value is there exactly once.
+void TestAppendersAndReader() {
+    const int WRITERS = 4;
+    const int PER_WRITER = 30000;
+    ConcurrentSegmentedList<int> list;
+    atomic<int> finished{0};
+    atomic<bool> sawUnwritten{false};
+
+    vector<thread> writers;
+    for (int w = 0; w < WRITERS; w++) {
+        writers.emplace_back([&, w]() {
+            for (int i = 0; i < PER_WRITER; i++) {
+                list.Append(w * PER_WRITER + i + 1);
+            }
+            finished++;
+        });
+    }
+    thread reader([&]() {
+        int from = 0;
+        while (finished.load() < WRITERS || from < WRITERS * PER_WRITER) {
+            from = list.ForEach(from, [&](const int& value) {
+                if (value < 1) {
+                    sawUnwritten = true;
+                }
+            });
+            int size = list.GetSize();
+            if (size > 0 && list.Get(size - 1) < 1) {
+                sawUnwritten = true;
+            }
+        }
+    });
+    for (thread& t : writers) {
+        t.join();
+    }
+    reader.join();
+
+    CHECK(!sawUnwritten.load());
+    CHECK(list.GetSize() == WRITERS * PER_WRITER);
+    vector<bool> present(WRITERS * PER_WRITER + 1, false);
+    bool unique = true;
+    list.ForEach(0, [&](const int& value) {
+        unique = unique && value >= 1 && value <= WRITERS * PER_WRITER && !present[value];
+        present[value] = true;
+    });
+    CHECK(unique);
+}
+
+int main() {
+    TestSingleThread();
+    TestElementTypes();
+    TestAppendersAndReader();
+    return TestStatus();
+}
@@ -0,0 +1,134 @@
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <functional>
+#include <vector>
+
+#include "Check.h"
+#include "ExternalSort.h"
+#include "MutableArraySequence.h"
+#include "Serialization.h"
+
+// 200k ints under a 64 KiB budget make 13 runs of 16384. With 8 KiB merge
+// buffers the fan-in is 7, so the runs need two merge passes.
+const int COUNT = 200000;
+
+ExternalSortOptions SmallBudget(const string& spillDirectory) {
+    ExternalSortOptions options;
+    options.memoryBytes = 64u << 10;
+    options.minMergeBufferBytes = 8u << 10;
+    options.tempDirectory = spillDirectory;
+    return options;
+}
+
+vector<int> RandomValues(int count) {
+    vector<int> values;
+    for (int i = 0; i < count; i++) {
+        values.push_back(RandomInt(-1000000, 1000000));
+    }
+    return values;
+}
+
+bool DirectoryEmpty(const string& path) {
+    return filesystem::is_empty(path);
+}
+
+void TestMultiPassSort() {
+    string spills = TempPath("sort_spills");
+    filesystem::create_directory(spills);
+    vector<int> values = RandomValues(COUNT);
+    MutableArraySequence<int> sequence(values.data(), COUNT);
+    vector<int> expected = values;
+    sort(expected.begin(), expected.end());
+    {
+        ExternalSorter<int> sorter(SmallBudget(spills));
+        MutableArraySequence<int>* sorted = sorter.Sort(&sequence);
+        CHECK(SameElements(sorted, expected));
+        delete sorted;
+        CHECK(sorter.Stats().elements == COUNT);
+        CHECK(sorter.Stats().runs == 13);
+        CHECK(sorter.Stats().mergePasses == 2);
+        // Merged runs are removed as soon as they are used.
+        CHECK(DirectoryEmpty(spills));
+    }
+
+    // A comparator other than less, on the same plan.
+    ExternalSorter<int, greater<int>> descending(SmallBudget(spills));
+    MutableArraySequence<int>* sorted = descending.Sort(&sequence);
+    reverse(expected.begin(), expected.end());
+    CHECK(SameElements(sorted, expected));
+    delete sorted;
+    filesystem::remove_all(spills);
+}
+
+void TestSortFile() {
+    string spills = TempPath("sort_file_spills");
+    string input = TempPath("sort_in.seq");
+    string output = TempPath("sort_out.seq");
+    filesystem::create_directory(spills);
+    vector<int> values = RandomValues(COUNT);
+    MutableArraySequence<int> sequence(values.data(), COUNT);
+    SerializeToFile<int>(&sequence, input);
+
+    ExternalSorter<int> sorter(SmallBudget(spills));
+    sorter.SortFile(input, output);
+    sort(values.begin(), values.end());
+    MutableArraySequence<int>* read = DeserializeFromFile<MutableArraySequence, int>(output);
+    CHECK(SameElements(read, values));
+    delete read;
+    CHECK(sorter.Stats().mergePasses == 2);
+    CHECK(DirectoryEmpty(spills));
+
+    remove(output.c_str());
+    remove(input.c_str());
+    filesystem::remove_all(spills);
+}
+
+void TestEmpty() {
+    string input = TempPath("sort_empty.seq");
+    string output = TempPath("sort_empty_out.seq");
+    MutableArraySequence<int> empty;
+    ExternalSorter<int> sorter;
+    MutableArraySequence<int>* sorted = sorter.Sort(&empty);
+    CHECK(sorted->GetSize() == 0);
+    delete sorted;
+
+    SerializeToFile<int>(&empty, input);
+    sorter.SortFile(input, output);
+    MutableArraySequence<int>* read = DeserializeFromFile<MutableArraySequence, int>(output);
+    CHECK(read->GetSize() == 0);
+    delete read;
+    CHECK(sorter.Stats().elements == 0 && sorter.Stats().runs == 0);
+    remove(output.c_str());
+    remove(input.c_str());
+}
+
+// The input header promises more elements than the file holds, so the
+// sort throws after several runs have been spilled; the sorter must not
+// leave them behind.
+void TestSpillsRemovedOnError() {
+    string spills = TempPath("sort_error_spills");
+    string input = TempPath("sort_truncated.seq");
+    string output = TempPath("sort_truncated_out.seq");
+    filesystem::create_directory(spills);
+    vector<int> values = RandomValues(COUNT);
+    MutableArraySequence<int> sequence(values.data(), COUNT);
+    SerializeToFile<int>(&sequence, input);
+    filesystem::resize_file(input, filesystem::file_size(input) / 2);
+    {
+        ExternalSorter<int> sorter(SmallBudget(spills));
+        CHECK_THROWS(sorter.SortFile(input, output), SerializationError);
+    }
+    CHECK(DirectoryEmpty(spills));
+    remove(output.c_str());
+    remove(input.c_str());
+    filesystem::remove_all(spills);
+}
+
+int main() {
+    TestMultiPassSort();
+    TestSortFile();
+    TestEmpty();
+    TestSpillsRemovedOnError();
+    return TestStatus();
+}
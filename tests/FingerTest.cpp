@@ -0,0 +1,152 @@
+#include <algorithm>
+#include <functional>
+#include <vector>
+
+#include "Check.h"
+#include "IndexOutOfRange.h"
+#include "LinkedList.h"
+#include "SegmentedList.h"
+
+// Reads around `index` and a random position, the lookups that start from
+// the finger left by the previous access; any stale finger shows up as a
+// wrong value.
+template <class L>
+bool ReadsMatch(L& list, const vector<int>& expected, int index) {
+    int size = (int) expected.size();
+    if (list.GetSize() != size) {
+        return false;
+    }
+    if (size == 0) {
+        return true;
+    }
+    int probes[] = {index - 1, index, index + 1, RandomInt(0, size - 1), index + 2, index - 2};
+    for (int probe : probes) {
+        int at = min(max(probe, 0), size - 1);
+        if (list.Get(at) != expected[at]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Random edits interleaved with reads, so every edit runs with the finger
+// somewhere before, at or after the edited position.
+template <bool DOUBLY_LINKED>
+void TestLinkedList() {
+    LinkedList<int, DOUBLY_LINKED> list;
+    vector<int> expected;
+    bool same = true;
+    for (int step = 0; step < 6000 && same; step++) {
+        int value = RandomInt(-100000, 100000);
+        int size = (int) expected.size();
+        int choice = RandomInt(0, 9);
+        int index = size > 0 ? RandomInt(0, size - 1) : 0;
+        if (size > 0) {
+            list.Get(index);
+        }
+        if (choice < 3 || size == 0) {
+            list.Append(value);
+            expected.push_back(value);
+        } else if (choice < 5) {
+            list.Prepend(value);
+            expected.insert(expected.begin(), value);
+        } else if (choice < 7) {
+            int at = RandomInt(0, size);
+            list.Insert(value, at);
+            expected.insert(expected.begin() + at, value);
+            index = at;
+        } else if (choice < 9) {
+            list.RemoveAt(index);
+            expected.erase(expected.begin() + index);
+        } else if (step % 50 == 0) {
+            list.Sort();
+            sort(expected.begin(), expected.end());
+        } else {
+            list[index] = value;
+            expected[index] = value;
+        }
+        same = ReadsMatch(list, expected, index);
+    }
+    CHECK(same);
+    CHECK(SameElements(&list, expected));
+
+    // A stable sort by a coarse key, with the finger in the middle.
+    list.Get((int) expected.size() / 2);
+    auto coarse = [](int a, int b) { return a / 1000 < b / 1000; };
+    list.Sort(coarse);
+    stable_sort(expected.begin(), expected.end(), coarse);
+    CHECK(SameElements(&list, expected));
+    CHECK_THROWS(list.Get((int) expected.size()), IndexOutOfRange);
+}
+
+// Every index from the last down to 0. Each Get walks back one node from
+// the finger, so this is linear on the doubly linked list.
+void TestDescendingScan() {
+    const int COUNT = 100000;
+    LinkedList<int, true> list;
+    for (int i = 0; i < COUNT; i++) {
+        list.Append(i * 3);
+    }
+    bool same = true;
+    for (int i = COUNT - 1; i >= 0; i--) {
+        same = same && list.Get(i) == i * 3;
+    }
+    CHECK(same);
+
+    // Back links stay right after edits in the middle.
+    list.Insert(-1, COUNT / 2);
+    list.RemoveAt(10);
+    list.Prepend(-2);
+    vector<int> expected;
+    for (int i = 0; i < COUNT; i++) {
+        expected.push_back(i * 3);
+    }
+    expected.insert(expected.begin() + COUNT / 2, -1);
+    expected.erase(expected.begin() + 10);
+    expected.insert(expected.begin(), -2);
+    same = list.GetSize() == (int) expected.size();
+    for (int i = (int) expected.size() - 1; i >= 0 && same; i--) {
+        same = list.Get(i) == expected[i];
+    }
+    CHECK(same);
+}
+
+// Segments hold 32 elements: inserts into full segments split them and
+// prepends onto a full head add a segment in front of the finger.
+void TestSegmentedList() {
+    SegmentedList<int> list;
+    vector<int> expected;
+    bool same = true;
+    for (int step = 0; step < 6000 && same; step++) {
+        int value = RandomInt(-100000, 100000);
+        int size = (int) expected.size();
+        int index = size > 0 ? RandomInt(0, size - 1) : 0;
+        if (size > 0) {
+            list.Get(index);
+        }
+        int choice = RandomInt(0, 2);
+        if (choice == 0) {
+            list.Append(value);
+            expected.push_back(value);
+        } else if (choice == 1) {
+            list.Prepend(value);
+            expected.insert(expected.begin(), value);
+        } else {
+            int at = RandomInt(0, size);
+            list.Insert(value, at);
+            expected.insert(expected.begin() + at, value);
+            index = at;
+        }
+        same = ReadsMatch(list, expected, index);
+    }
+    CHECK(same);
+    CHECK(SameElements(&list, expected));
+}
+
+int main() {
+    TestLinkedList<false>();
+    TestLinkedList<true>();
+    TestDescendingScan();
+    TestSegmentedList();
+    return TestStatus();
+}
@@ -0,0 +1,161 @@
+#include <climits>
+#include <cstdio>
+#include <stdexcept>
+#include <vector>
+
+#include "Check.h"
+#include "Generator.h"
+#include "MutableArraySequence.h"
+#include "MutableListSequence.h"
+#include "Serialization.h"
+#include "StreamingSequence.h"
+
+vector<int> Drain(Generator<int> source) {
+    vector<int> items;
+    for (int item : source) {
+        items.push_back(item);
+    }
+    return items;
+}
+
+// Counts how many elements the consumer actually asked for.
+Generator<int> Counted(int& produced, int count) {
+    for (int i = 0; i < count; i++) {
+        produced++;
+        co_yield i;
+    }
+}
+
+Generator<int> FailingAfter(int count) {
+    for (int i = 0; i < count; i++) {
+        co_yield i;
+    }
+    throw std::runtime_error("source failed");
+}
+
+void TestRange() {
+    CHECK(Drain(Range(0, 5)) == vector<int>({0, 1, 2, 3, 4}));
+    CHECK(Drain(Range(-3, 4, 2)) == vector<int>({-3, -1, 1, 3}));
+    CHECK(Drain(Range(5, 5)).empty());
+    CHECK(Drain(Range(5, 0)).empty());
+
+    // The last step would overflow int; it must stop instead.
+    CHECK(Drain(Range(INT_MAX - 3, INT_MAX)) == vector<int>({INT_MAX - 3, INT_MAX - 2, INT_MAX - 1}));
+    CHECK(Drain(Range(INT_MAX - 10, INT_MAX, 4)) == vector<int>({INT_MAX - 10, INT_MAX - 6, INT_MAX - 2}));
+    CHECK(Drain(Range(0, INT_MAX, INT_MAX / 2 + 1)) == vector<int>({0, INT_MAX / 2 + 1}));
+    CHECK(Drain(Range(INT_MAX - 1, INT_MAX, INT_MAX)) == vector<int>({INT_MAX - 1}));
+}
+
+void TestPipelines() {
+    CHECK(Range(0, 100).Map([](int x) { return x * 3; }).Where([](int x) { return x % 2 == 0; })
+              .Reduce([](int a, int b) { return a + b; }, 1) == 7351);
+
+    // Zip stops at the shorter side, whichever it is.
+    CHECK(Drain(Range(0, 10).Zip(Range(100, 103), [](int a, int b) { return a + b; }))
+          == vector<int>({100, 102, 104}));
+    CHECK(Drain(Range(0, 2).Zip(Range(10, 1000), [](int a, int b) { return a * b; })) == vector<int>({0, 11}));
+    CHECK(Drain(Range(0, 0).Zip(Range(0, 5), [](int a, int b) { return a + b; })).empty());
+
+    // Take does not resume the source past the elements it hands out.
+    int produced = 0;
+    CHECK(Drain(Counted(produced, 1000).Take(3)) == vector<int>({0, 1, 2}));
+    CHECK(produced == 3);
+    produced = 0;
+    CHECK(Drain(Counted(produced, 2).Take(10)) == vector<int>({0, 1}));
+}
+
+// TryFind stops at the match and the generator goes on after it.
+void TestTryFindThenNext() {
+    int produced = 0;
+    Generator<int> source = Counted(produced, 100);
+    int found = -1;
+    CHECK(source.TryFind([](int x) { return x % 7 == 6; }, found) && found == 6);
+    CHECK(produced == 7);
+    int next = -1;
+    CHECK(source.Next(next) && next == 7);
+    CHECK(source.TryFind([](int x) { return x > 90; }, found) && found == 91);
+    CHECK(!source.TryFind([](int x) { return x < 0; }, found) && found == 91);
+    CHECK(!source.Next(next));
+    CHECK(produced == 100);
+}
+
+// The exception reaches the consumer from the Next() that resumed the
+// throwing coroutine, through any number of wrappers; after it the
+// generator is finished.
+void TestExceptions() {
+    Generator<int> source = FailingAfter(2);
+    int item = -1;
+    CHECK(source.Next(item) && item == 0);
+    CHECK(source.Next(item) && item == 1);
+    CHECK_THROWS(source.Next(item), std::runtime_error);
+    CHECK(!source.Next(item));
+
+    Generator<int> wrapped = FailingAfter(3).Map([](int x) { return x + 1; }).Where([](int) { return true; });
+    CHECK(wrapped.Next(item) && item == 1);
+    CHECK_THROWS(wrapped.Reduce([](int a, int b) { return a + b; }, 0), std::runtime_error);
+    CHECK(!wrapped.Next(item));
+}
+
+void TestSequences() {
+    vector<int> values;
+    for (int i = 0; i < 2000; i++) {
+        values.push_back(RandomInt(-1000, 1000));
+    }
+    MutableArraySequence<int> array(values.data(), (int) values.size());
+    MutableListSequence<int> list(values.data(), (int) values.size());
+    CHECK(Drain(array.AsGenerator()) == values);
+    CHECK(Drain(list.AsGenerator()) == values);
+
+    vector<int> expected;
+    for (int v : values) {
+        if (v * 2 > 100) {
+            expected.push_back(v * 2);
+        }
+    }
+    MutableArraySequence<int> collected(list.AsGenerator().Map([](int x) { return x * 2; }).Where([](int x) {
+        return x > 100;
+    }));
+    CHECK(SameElements(&collected, expected));
+
+    MutableArraySequence<int> empty(Range(0, 0));
+    CHECK(empty.GetSize() == 0);
+}
+
+// Destroying a StreamingSequence generator in the middle of a chunk must
+// stop and join the reader thread; the sequence stays usable afterwards.
+void TestStreamingStopsEarly() {
+    string path = TempPath("generator_stream.seq");
+    vector<int> values;
+    for (int i = 0; i < 20000; i++) {
+        values.push_back(RandomInt(-1000, 1000));
+    }
+    MutableArraySequence<int> source(values.data(), (int) values.size());
+    SerializeToFile<int>(&source, path);
+    StreamingSequence<int> sequence(path, 64);
+
+    for (int stop : {0, 1, 63, 64, 100, 5000}) {
+        Generator<int> generator = sequence.AsGenerator();
+        bool same = true;
+        int item = 0;
+        for (int i = 0; i < stop; i++) {
+            same = generator.Next(item) && same && item == values[i];
+        }
+        CHECK(same);
+    }
+
+    int found = 0;
+    CHECK(sequence.AsGenerator().TryFind([](int x) { return x == 1000 || x == -1000; }, found));
+    CHECK(Drain(sequence.AsGenerator().Take(70)) == vector<int>(values.begin(), values.begin() + 70));
+    CHECK(Drain(sequence.AsGenerator()) == values);
+    remove(path.c_str());
+}
+
+int main() {
+    TestRange();
+    TestPipelines();
+    TestTryFindThenNext();
+    TestExceptions();
+    TestSequences();
+    TestStreamingStopsEarly();
+    return TestStatus();
+}
@@ -0,0 +1,103 @@
+#include <algorithm>
+#include <vector>
+
+#include "Check.h"
+#include "HashIndex.h"
+#include "IndexedSequence.h"
+#include "MutableArraySequence.h"
+
+int KeyOfValue(const int& value) {
+    return value % 97;
+}
+
+// Every key's Find / Count / Contains against a scan of the vector.
+template <class S>
+bool SameLookups(S& sequence, const vector<int>& expected) {
+    for (int key = -1; key <= 97; key++) {
+        int first = -1;
+        int count = 0;
+        for (int i = 0; i < (int) expected.size(); i++) {
+            if (KeyOfValue(expected[i]) == key) {
+                first = first == -1 ? i : first;
+                count++;
+            }
+        }
+        if (sequence.Find(key) != first || sequence.Count(key) != count || sequence.Contains(key) != (count > 0)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Set removes the old key from the table (backward-shift deletion), so
+// mixing it with appends and inserts exercises every path of the table.
+void TestIndexedSequenceEdits() {
+    IndexedSequence<int, int> sequence(&KeyOfValue);
+    vector<int> expected;
+    for (int step = 0; step < 2000; step++) {
+        int value = RandomInt(0, 5000);
+        int choice = RandomInt(0, 5);
+        if (choice < 2 || expected.empty()) {
+            sequence.Append(value);
+            expected.push_back(value);
+        } else if (choice < 3) {
+            int index = RandomInt(0, (int) expected.size());
+            sequence.Insert(value, index);
+            expected.insert(expected.begin() + index, value);
+        } else if (choice < 4) {
+            sequence.Prepend(value);
+            expected.insert(expected.begin(), value);
+        } else {
+            int index = RandomInt(0, (int) expected.size() - 1);
+            sequence.Set(index, value);
+            expected[index] = value;
+        }
+        if (step % 200 == 0) {
+            CHECK(SameLookups(sequence, expected));
+        }
+    }
+    CHECK(SameElements(&sequence, expected));
+    CHECK(SameLookups(sequence, expected));
+
+    // Writes through operator[] are caught up by a rebuild.
+    sequence[0] = 96;
+    expected[0] = 96;
+    CHECK(SameLookups(sequence, expected));
+
+    int found = -1;
+    CHECK(sequence.TryFind(sequence.KeyEquals(96), found) && KeyOfValue(found) == 96);
+    CHECK(!sequence.TryFind(sequence.KeyEquals(97), found));
+}
+
+void TestHashIndexOverSequence() {
+    vector<int> values;
+    for (int i = 0; i < 3000; i++) {
+        values.push_back(RandomInt(0, 100000));
+    }
+    MutableArraySequence<int> items(values.data(), (int) values.size());
+    HashIndex<int, int> index(&items, &KeyOfValue);
+    CHECK(SameLookups(index, values));
+
+    items.Append(5);
+    values.push_back(5);
+    index.OnAppend();
+    int old = items.Get(10);
+    items[10] = 42;
+    values[10] = 42;
+    index.OnSet(10, old);
+    CHECK(SameLookups(index, values));
+
+    items.Insert(7, 3);
+    values.insert(values.begin() + 3, 7);
+    index.OnInsert(3);
+    CHECK(SameLookups(index, values));
+
+    index.Rebuild();
+    CHECK(SameLookups(index, values));
+}
+
+int main() {
+    TestIndexedSequenceEdits();
+    TestHashIndexOverSequence();
+    return TestStatus();
+}
@@ -0,0 +1,208 @@
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+#include "Check.h"
+#include "IndexOutOfRange.h"
+#include "IntrusiveList.h"
+#include "IntrusiveSequence.h"
+
+// Two hooks, so an order can be in one list by time and one by price.
+struct Order {
+    int id = 0;
+    IntrusiveHook byTime;
+    IntrusiveHook byPrice;
+};
+
+using TimeList = IntrusiveList<Order, &Order::byTime>;
+using PriceList = IntrusiveList<Order, &Order::byPrice>;
+
+template <class L>
+bool SameOrder(L& list, const vector<Order*>& expected) {
+    vector<Order*> seen;
+    list.ForEach([&](Order& order) { seen.push_back(&order); });
+    if (seen != expected || list.GetSize() != (int) expected.size()) {
+        return false;
+    }
+    for (int i = 0; i < (int) expected.size(); i++) {
+        Order* previous = i > 0 ? expected[i - 1] : nullptr;
+        Order* next = i + 1 < (int) expected.size() ? expected[i + 1] : nullptr;
+        if (list.Previous(*expected[i]) != previous || list.Next(*expected[i]) != next) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Random edits against a vector of pointers, each followed by reads next
+// to the edited position, which start from the finger.
+void TestEditsKeepFinger() {
+    vector<Order> pool(3000);
+    for (int i = 0; i < (int) pool.size(); i++) {
+        pool[i].id = i;
+    }
+    vector<Order*> unlinked;
+    for (Order& order : pool) {
+        unlinked.push_back(&order);
+    }
+    TimeList list;
+    vector<Order*> expected;
+    bool same = true;
+    for (int step = 0; step < 8000 && same; step++) {
+        int size = (int) expected.size();
+        int index = size > 0 ? RandomInt(0, size - 1) : 0;
+        if (size > 0) {
+            list.Get(index);
+        }
+        int choice = RandomInt(0, 5);
+        if ((choice < 4 || size == 0) && !unlinked.empty()) {
+            Order* order = unlinked.back();
+            unlinked.pop_back();
+            if (choice == 0) {
+                list.Append(*order);
+                expected.push_back(order);
+            } else if (choice == 1) {
+                list.Prepend(*order);
+                expected.insert(expected.begin(), order);
+            } else if (choice == 2 || size == 0) {
+                index = RandomInt(0, size);
+                list.Insert(*order, index);
+                expected.insert(expected.begin() + index, order);
+            } else {
+                list.InsertAfter(*expected[index], *order);
+                expected.insert(expected.begin() + index + 1, order);
+            }
+        } else if (size > 0) {
+            if (choice == 4) {
+                list.RemoveAt(index);
+            } else {
+                list.Remove(*expected[index]);
+            }
+            unlinked.push_back(expected[index]);
+            expected.erase(expected.begin() + index);
+            index = min(index, (int) expected.size() - 1);
+        }
+        int count = (int) expected.size();
+        for (int probe = index - 2; probe <= index + 2 && count > 0; probe++) {
+            int at = min(max(probe, 0), count - 1);
+            same = same && &list.Get(at) == expected[at];
+        }
+    }
+    CHECK(same);
+    CHECK(SameOrder(list, expected));
+    if (!expected.empty()) {
+        CHECK(&list.GetFirst() == expected.front());
+        CHECK(&list.GetLast() == expected.back());
+    }
+}
+
+void TestTwoHooks() {
+    vector<Order> orders(10);
+    TimeList byTime;
+    PriceList byPrice;
+    vector<Order*> timeOrder;
+    vector<Order*> priceOrder;
+    for (int i = 0; i < 10; i++) {
+        orders[i].id = i;
+        byTime.Append(orders[i]);
+        byPrice.Prepend(orders[i]);
+        timeOrder.push_back(&orders[i]);
+        priceOrder.insert(priceOrder.begin(), &orders[i]);
+    }
+    CHECK(SameOrder(byTime, timeOrder));
+    CHECK(SameOrder(byPrice, priceOrder));
+
+    // Unlinking through one hook leaves the other list alone.
+    byTime.Remove(orders[4]);
+    timeOrder.erase(timeOrder.begin() + 4);
+    CHECK(!orders[4].byTime.IsLinked() && orders[4].byPrice.IsLinked());
+    CHECK(SameOrder(byTime, timeOrder));
+    CHECK(SameOrder(byPrice, priceOrder));
+}
+
+// An element is in at most one list per hook.
+void TestDoubleLink() {
+    Order order;
+    TimeList list;
+    TimeList other;
+    list.Append(order);
+    CHECK_THROWS(list.Append(order), runtime_error);
+    CHECK_THROWS(other.Prepend(order), runtime_error);
+    CHECK_THROWS(other.Insert(order, 0), runtime_error);
+    CHECK(list.GetSize() == 1 && other.GetSize() == 0);
+    list.Remove(order);
+    CHECK_THROWS(list.Remove(order), runtime_error);
+    other.Append(order);
+    CHECK(&other.Get(0) == &order);
+    CHECK_THROWS(other.Get(1), IndexOutOfRange);
+    CHECK_THROWS(other.Insert(order, 5), IndexOutOfRange);
+}
+
+// Clear and the destructor unlink the elements, which can then join
+// another list.
+void TestClearAndDestroy() {
+    vector<Order> orders(100);
+    TimeList kept;
+    {
+        TimeList scoped;
+        for (Order& order : orders) {
+            scoped.Append(order);
+        }
+        scoped.Get(50);
+        scoped.Clear();
+        CHECK(scoped.IsEmpty());
+        bool unlinked = true;
+        for (Order& order : orders) {
+            unlinked = unlinked && !order.byTime.IsLinked();
+        }
+        CHECK(unlinked);
+
+        for (Order& order : orders) {
+            scoped.Prepend(order);
+        }
+    }
+    bool unlinked = true;
+    for (Order& order : orders) {
+        unlinked = unlinked && !order.byTime.IsLinked();
+        kept.Append(order);
+    }
+    CHECK(unlinked);
+    CHECK(kept.GetSize() == 100 && &kept.Get(99) == &orders[99]);
+}
+
+void TestSequence() {
+    vector<Order> orders(6);
+    vector<Order*> pointers;
+    for (int i = 0; i < 6; i++) {
+        orders[i].id = i;
+        pointers.push_back(&orders[i]);
+    }
+    {
+        IntrusiveSequence<Order, &Order::byPrice> sequence(pointers.data(), 6);
+        CHECK(SameElements(&sequence, pointers));
+        Sequence<Order*>* even = sequence.Where([](Order* order) { return order->id % 2 == 0; });
+        CHECK(SameElements(even, vector<Order*>{&orders[0], &orders[2], &orders[4]}));
+        delete even;
+        // The objects are shared: the list still holds all of them.
+        CHECK(sequence.GetSize() == 6);
+        CHECK_THROWS(sequence[0], runtime_error);
+        const IntrusiveSequence<Order, &Order::byPrice>& constant = sequence;
+        CHECK(constant[3] == &orders[3]);
+        sequence.Remove(&orders[3]);
+        CHECK(sequence.Get(3) == &orders[4]);
+    }
+    bool unlinked = true;
+    for (Order& order : orders) {
+        unlinked = unlinked && !order.byPrice.IsLinked();
+    }
+    CHECK(unlinked);
+}
+
+int main() {
+    TestEditsKeepFinger();
+    TestTwoHooks();
+    TestDoubleLink();
+    TestClearAndDestroy();
+    TestSequence();
+    return TestStatus();
+}
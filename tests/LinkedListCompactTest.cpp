@@ -0,0 +1,179 @@
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "AllocationTracker.h"
+#include "Check.h"
+#include "IndexOutOfRange.h"
+#include "LinkedList.h"
+
+// Long enough to live on the heap, so a node destroyed twice or read after
+// its slab is freed is caught by the address sanitizer.
+string Value(int key) {
+    return "compaction test value " + to_string(key);
+}
+
+size_t LiveNodeBytes() {
+    return AllocationTracker::Register("LinkedList").liveBytes;
+}
+
+// Random edits against a vector with auto compaction on. The list grows
+// past AUTO_COMPACT_MIN_SIZE and the inserts scatter its nodes, so slabs
+// are made and freed again and again while some nodes live in a slab and
+// others on the heap.
+template <bool DOUBLY_LINKED>
+void TestEditsWithCompaction() {
+    const double THRESHOLD = 0.5;
+    LinkedList<string, DOUBLY_LINKED> list;
+    list.SetAutoCompact(THRESHOLD);
+    vector<string> expected;
+    bool same = true;
+    bool local = true;
+    for (int step = 0; step < 20000 && same; step++) {
+        int size = (int) expected.size();
+        string value = Value(RandomInt(0, 1000000));
+        int choice = RandomInt(0, 19);
+        if (choice < 6 || size == 0) {
+            int at = RandomInt(0, size);
+            list.Insert(value, at);
+            expected.insert(expected.begin() + at, value);
+        } else if (choice < 10) {
+            list.Prepend(value);
+            expected.insert(expected.begin(), value);
+        } else if (choice < 13) {
+            list.Append(value);
+            expected.push_back(value);
+        } else if (choice < 18) {
+            int at = RandomInt(0, size - 1);
+            list.RemoveAt(at);
+            expected.erase(expected.begin() + at);
+        } else if (choice == 18) {
+            int at = RandomInt(0, size - 1);
+            list[at] = value;
+            expected[at] = value;
+        } else if (step % 10 == 0) {
+            list.Compact();
+            local = local && list.Locality() == 1.0;
+        } else if (step % 100 == 1) {
+            list.Sort();
+            sort(expected.begin(), expected.end());
+        }
+        if (list.GetSize() >= 4096) {
+            local = local && list.Locality() >= THRESHOLD;
+        }
+        if (step % 1000 == 0) {
+            same = SameElements(&list, expected);
+            // A copy is built from scratch and freed on its own.
+            LinkedList<string, DOUBLY_LINKED> copy(list);
+            same = same && SameElements(&copy, expected);
+        }
+    }
+    CHECK(same);
+    CHECK(local);
+    CHECK(SameElements(&list, expected));
+}
+
+// Removing every node frees the slab with the last one of its nodes.
+void TestDrain() {
+    LinkedList<string> list;
+    for (int i = 0; i < 1000; i++) {
+        list.Prepend(Value(i));
+    }
+    list.Compact();
+    // The slab's nodes and its Slab record.
+    CHECK(list.MemoryFootprint().allocationCount == 2);
+    list.Append(Value(-1));
+    CHECK(list.MemoryFootprint().allocationCount == 3);
+    while (list.GetSize() > 0) {
+        list.RemoveAt(RandomInt(0, list.GetSize() - 1));
+    }
+    CHECK(list.MemoryFootprint().allocationCount == 0);
+    CHECK(LiveNodeBytes() == 0);
+    CHECK_THROWS(list.RemoveAt(0), IndexOutOfRange);
+    list.Compact();
+    list.Append(Value(1));
+    CHECK(list.Get(0) == Value(1));
+}
+
+// Splice and SplitAt leave the nodes of one slab in several lists. Four
+// lists trade nodes at random while they are compacted, edited and
+// destroyed; a slab freed while a list still holds one of its nodes, or
+// never freed at all, shows up under the address sanitizer and in the
+// tracked node bytes.
+template <bool DOUBLY_LINKED>
+void TestSharedSlabs() {
+    using List = LinkedList<string, DOUBLY_LINKED>;
+    const int LISTS = 4;
+    List* lists[LISTS];
+    vector<string> expected[LISTS];
+    for (int i = 0; i < LISTS; i++) {
+        lists[i] = new List();
+        lists[i]->SetAutoCompact(i < 2 ? 0.5 : 0);
+    }
+    bool same = true;
+    for (int step = 0; step < 20000 && same; step++) {
+        int i = RandomInt(0, LISTS - 1);
+        int j = (i + RandomInt(1, LISTS - 1)) % LISTS;
+        List& list = *lists[i];
+        vector<string>& values = expected[i];
+        int size = (int) values.size();
+        string value = Value(step);
+        int choice = RandomInt(0, 19);
+        if (choice < 8 || size == 0) {
+            int at = RandomInt(0, size);
+            list.Insert(value, at);
+            values.insert(values.begin() + at, value);
+        } else if (choice < 10) {
+            list.Prepend(value);
+            values.insert(values.begin(), value);
+        } else if (choice < 13) {
+            int at = RandomInt(0, size - 1);
+            list.RemoveAt(at);
+            values.erase(values.begin() + at);
+        } else if (choice < 15) {
+            list.Compact();
+        } else if (choice < 17) {
+            int at = RandomInt(0, size);
+            list.Splice(*lists[j], at);
+            values.insert(values.begin() + at, expected[j].begin(), expected[j].end());
+            expected[j].clear();
+        } else if (choice < 19) {
+            // The split-off nodes replace list j, which is destroyed.
+            int at = RandomInt(0, size);
+            delete lists[j];
+            lists[j] = list.SplitAt(at);
+            expected[j].assign(values.begin() + at, values.end());
+            values.resize(at);
+        } else {
+            delete lists[i];
+            lists[i] = new List();
+            values.clear();
+        }
+        if (step % 500 == 0) {
+            for (int k = 0; k < LISTS; k++) {
+                same = same && SameElements(lists[k], expected[k]);
+                same = same && lists[k]->Locality() >= 0.0 && lists[k]->Locality() <= 1.0;
+            }
+        }
+    }
+    CHECK(same);
+    for (int k = 0; k < LISTS; k++) {
+        lists[k]->Append(Value(-1));
+        expected[k].push_back(Value(-1));
+        CHECK(SameElements(lists[k], expected[k]));
+        delete lists[k];
+    }
+}
+
+int main() {
+    AllocationTracker::Enable();
+    TestEditsWithCompaction<false>();
+    TestEditsWithCompaction<true>();
+    CHECK(LiveNodeBytes() == 0);
+    TestDrain();
+    CHECK(LiveNodeBytes() == 0);
+    TestSharedSlabs<false>();
+    TestSharedSlabs<true>();
+    CHECK(LiveNodeBytes() == 0);
+    return TestStatus();
+}
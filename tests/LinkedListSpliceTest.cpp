@@ -0,0 +1,95 @@
+#include <stdexcept>
+#include <vector>
+
+#include "Check.h"
+#include "IndexOutOfRange.h"
+#include "LinkedList.h"
+
+template <bool DOUBLY_LINKED>
+LinkedList<int, DOUBLY_LINKED>* MakeList(const vector<int>& values, bool compact) {
+    LinkedList<int, DOUBLY_LINKED>* list = new LinkedList<int, DOUBLY_LINKED>();
+    for (int v : values) {
+        list->Append(v);
+    }
+    if (compact) {
+        list->Compact();
+    }
+    return list;
+}
+
+vector<int> RandomValues(int count) {
+    vector<int> values;
+    for (int i = 0; i < count; i++) {
+        values.push_back(RandomInt(0, 1000));
+    }
+    return values;
+}
+
+// Random Splice / SplitAt / Concat between lists, some compacted into
+// slabs, against vectors; every list is also appended to afterwards so a
+// stale tail would show.
+template <bool DOUBLY_LINKED>
+void TestRandomSplices() {
+    using List = LinkedList<int, DOUBLY_LINKED>;
+    for (int round = 0; round < 200; round++) {
+        vector<int> a = RandomValues(RandomInt(0, 40));
+        vector<int> b = RandomValues(RandomInt(0, 40));
+        List* left = MakeList<DOUBLY_LINKED>(a, RandomInt(0, 1) == 1);
+        List* right = MakeList<DOUBLY_LINKED>(b, RandomInt(0, 1) == 1);
+
+        int choice = RandomInt(0, 2);
+        if (choice == 0) {
+            int index = RandomInt(0, (int) a.size());
+            left->Splice(*right, index);
+            a.insert(a.begin() + index, b.begin(), b.end());
+            b.clear();
+        } else if (choice == 1) {
+            left->Concat(std::move(*right));
+            a.insert(a.end(), b.begin(), b.end());
+            b.clear();
+        } else {
+            int index = RandomInt(0, (int) a.size());
+            delete right;
+            right = left->SplitAt(index);
+            b.assign(a.begin() + index, a.end());
+            a.resize(index);
+        }
+        CHECK(SameElements(left, a));
+        CHECK(SameElements(right, b));
+        CHECK(left->Locality() >= 0.0 && left->Locality() <= 1.0);
+        CHECK(right->Locality() >= 0.0 && right->Locality() <= 1.0);
+
+        left->Append(-1);
+        right->Append(-2);
+        right->Prepend(-3);
+        a.push_back(-1);
+        b.push_back(-2);
+        b.insert(b.begin(), -3);
+        CHECK(SameElements(left, a));
+        CHECK(SameElements(right, b));
+        if (!a.empty()) {
+            left->RemoveAt((int) a.size() - 1);
+            a.pop_back();
+            CHECK(SameElements(left, a));
+        }
+        delete right;
+        delete left;
+    }
+}
+
+void TestErrors() {
+    LinkedList<int> list;
+    list.Append(1);
+    LinkedList<int> other;
+    CHECK_THROWS(list.Splice(list), std::runtime_error);
+    CHECK_THROWS(list.Splice(other, 2), IndexOutOfRange);
+    CHECK_THROWS(list.SplitAt(2), IndexOutOfRange);
+    CHECK_THROWS(list.SplitAt(-1), IndexOutOfRange);
+}
+
+int main() {
+    TestRandomSplices<false>();
+    TestRandomSplices<true>();
+    TestErrors();
+    return TestStatus();
+}
@@ -0,0 +1,87 @@
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+#include "Check.h"
+#include "DynamicArray.h"
+#include "MappedFile.h"
+#include "MutableArraySequence.h"
+
+// Appends past several doublings of the file, closes it and maps it again:
+// the file must hold exactly the elements, trimmed to their count.
+void TestCreateAppendReopen() {
+    string path = TempPath("mapped.bin");
+    vector<int> expected;
+    {
+        MutableArraySequence<int>* sequence = MutableArraySequence<int>::CreateMapped(path);
+        CHECK(sequence->IsMapped());
+        for (int i = 0; i < 5000; i++) {
+            int value = RandomInt(-1000000, 1000000);
+            sequence->Append(value);
+            expected.push_back(value);
+        }
+        (*sequence)[17] = 17;
+        expected[17] = 17;
+        CHECK(SameElements(sequence, expected));
+        delete sequence;
+    }
+    ifstream file(path, ios::binary | ios::ate);
+    CHECK((size_t) file.tellg() == sizeof(int) * expected.size());
+    file.close();
+
+    MutableArraySequence<int>* reopened = MutableArraySequence<int>::OpenMapped(path);
+    CHECK(SameElements(reopened, expected));
+    // Writes through an OpenMapped array reach the file.
+    (*reopened)[0] = 123456;
+    expected[0] = 123456;
+    delete reopened;
+
+    DynamicArray<int>* array = DynamicArray<int>::OpenMapped(path);
+    CHECK(SameElements(array, expected));
+    delete array;
+    remove(path.c_str());
+}
+
+// A private view sees the file at an offset and never writes it back.
+void TestView() {
+    string path = TempPath("view.bin");
+    vector<long long> values;
+    for (int i = 0; i < 1024; i++) {
+        values.push_back((long long) i * i);
+    }
+    {
+        ofstream out(path, ios::binary | ios::trunc);
+        out.write((const char*) values.data(), (streamsize) (sizeof(long long) * values.size()));
+    }
+    DynamicArray<long long>* view = DynamicArray<long long>::MapView(path, sizeof(long long) * 100, 500);
+    CHECK(SameElements(view, vector<long long>(values.begin() + 100, values.begin() + 600)));
+    view->Set(0, -1);
+    CHECK(view->Get(0) == -1);
+    delete view;
+
+    DynamicArray<long long>* again = DynamicArray<long long>::MapView(path, 0, 1024);
+    CHECK(SameElements(again, values));
+    delete again;
+
+    CHECK_THROWS(DynamicArray<long long>::MapView(path, 0, 1025), runtime_error);
+    remove(path.c_str());
+}
+
+void TestErrors() {
+    string path = TempPath("odd.bin");
+    {
+        ofstream out(path, ios::binary | ios::trunc);
+        out.write("abcde", 5);
+    }
+    CHECK_THROWS(DynamicArray<int>::OpenMapped(path), runtime_error);
+    remove(path.c_str());
+    CHECK_THROWS(MappedFile(path, false), runtime_error);
+}
+
+int main() {
+    TestCreateAppendReopen();
+    TestView();
+    TestErrors();
+    return TestStatus();
+}
@@ -0,0 +1,104 @@
+#include <climits>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+#include "Check.h"
+#include "IndexOutOfRange.h"
+#include "PackedIntSequence.h"
+
+template <class T>
+bool SamePacked(const PackedIntSequence<T>& sequence, const vector<T>& expected) {
+    if (sequence.GetSize() != (int) expected.size()) {
+        return false;
+    }
+    // Backwards too, so Get does not always hit the decoded block cache.
+    for (int i = (int) expected.size() - 1; i >= 0; i--) {
+        if (sequence.Get(i) != expected[i]) {
+            return false;
+        }
+    }
+    for (int i = 0; i < (int) expected.size(); i++) {
+        if (sequence.Get(i) != expected[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Blocks of every shape: constant, sorted (delta coded), small and full
+// width random, and the extremes of the type.
+template <class T>
+vector<T> MixedValues(int blocks) {
+    vector<T> values;
+    for (int b = 0; b < blocks; b++) {
+        int shape = b % 5;
+        T base = (T) RandomInt(-1000, 1000);
+        for (int i = 0; i < 128; i++) {
+            if (shape == 0) {
+                values.push_back(base);
+            } else if (shape == 1) {
+                values.push_back((T) (base + i * 3 + RandomInt(0, 2)));
+            } else if (shape == 2) {
+                values.push_back((T) (base + RandomInt(0, 15)));
+            } else if (shape == 3) {
+                values.push_back((T) ((uint64_t) TestRandom()() << 32 | TestRandom()()));
+            } else {
+                values.push_back(i % 2 == 0 ? numeric_limits<T>::min() : numeric_limits<T>::max());
+            }
+        }
+    }
+    // A partial block that is not packed yet.
+    for (int i = 0; i < 77; i++) {
+        values.push_back((T) RandomInt(-5, 5));
+    }
+    return values;
+}
+
+template <class T>
+void TestRoundTrip() {
+    vector<T> values = MixedValues<T>(40);
+    PackedIntSequence<T> sequence(values.data(), (int) values.size());
+    CHECK(sequence.BlockCount() == 40);
+    CHECK(SamePacked(sequence, values));
+
+    // Wrapping sums, so the fold cannot overflow a signed T.
+    using U = make_unsigned_t<T>;
+    U sum = 0;
+    for (T v : values) {
+        sum = (U) (sum + (U) v);
+    }
+    CHECK((U) sequence.Reduce([](T a, T b) { return (T) ((U) a + (U) b); }, (T) 0) == sum);
+
+    PackedIntSequence<T>* filtered = sequence.Where([](T x) { return x > 0; });
+    vector<T> expected;
+    for (T v : values) {
+        if (v > 0) {
+            expected.push_back(v);
+        }
+    }
+    CHECK(SamePacked(*filtered, expected));
+    delete filtered;
+
+    CHECK_THROWS(sequence.Get((int) values.size()), IndexOutOfRange);
+    CHECK_THROWS(sequence.Get(-1), IndexOutOfRange);
+}
+
+void TestCompression() {
+    vector<int> values;
+    for (int i = 0; i < 128 * 64; i++) {
+        values.push_back(1000 + i);
+    }
+    PackedIntSequence<int> sequence(values.data(), (int) values.size());
+    CHECK(SamePacked(sequence, values));
+    CHECK(sequence.CompressionRatio() > 4.0);
+}
+
+int main() {
+    TestRoundTrip<int>();
+    TestRoundTrip<long long>();
+    TestRoundTrip<uint32_t>();
+    TestRoundTrip<int16_t>();
+    TestCompression();
+    return TestStatus();
+}
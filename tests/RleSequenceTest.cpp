@@ -0,0 +1,137 @@
+#include <vector>
+
+#include "Check.h"
+#include "IndexOutOfRange.h"
+#include "RleSequence.h"
+
+// Values drawn from a small range so runs form.
+vector<int> RunnyValues(int count) {
+    vector<int> values;
+    int value = 0;
+    for (int i = 0; i < count; i++) {
+        if (RandomInt(0, 5) == 0) {
+            value = RandomInt(0, 3);
+        }
+        values.push_back(value);
+    }
+    return values;
+}
+
+int CountRuns(const vector<int>& values) {
+    int runs = 0;
+    for (int i = 0; i < (int) values.size(); i++) {
+        runs += i == 0 || values[i] != values[i - 1] ? 1 : 0;
+    }
+    return runs;
+}
+
+void TestAppendAndInsert() {
+    RleSequence<int> sequence;
+    vector<int> expected;
+    for (int step = 0; step < 3000; step++) {
+        int value = RandomInt(0, 3);
+        int choice = RandomInt(0, 3);
+        if (choice < 2) {
+            sequence.Append(value);
+            expected.push_back(value);
+        } else if (choice < 3) {
+            int index = RandomInt(0, (int) expected.size());
+            sequence.Insert(value, index);
+            expected.insert(expected.begin() + index, value);
+        } else {
+            sequence.Prepend(value);
+            expected.insert(expected.begin(), value);
+        }
+    }
+    CHECK(SameElements(&sequence, expected));
+    // Adjacent runs always differ, so the encoding is minimal.
+    CHECK(sequence.RunCount() == CountRuns(expected));
+}
+
+void TestQueries() {
+    vector<int> values = RunnyValues(2000);
+    RleSequence<int> sequence(values.data(), (int) values.size());
+    CHECK(sequence.RunCount() == CountRuns(values));
+
+    Sequence<int>* sub = sequence.GetSubSequence(123, 1500);
+    CHECK(SameElements(sub, vector<int>(values.begin() + 123, values.begin() + 1500)));
+
+    Sequence<int>* mapped = sequence.Map([](int x) { return x * 10; });
+    vector<int> expectedMapped;
+    for (int v : values) {
+        expectedMapped.push_back(v * 10);
+    }
+    CHECK(SameElements(mapped, expectedMapped));
+
+    Sequence<int>* filtered = sequence.Where([](int x) { return x % 2 == 0; });
+    vector<int> expectedFiltered;
+    for (int v : values) {
+        if (v % 2 == 0) {
+            expectedFiltered.push_back(v);
+        }
+    }
+    CHECK(SameElements(filtered, expectedFiltered));
+
+    long long sum = 0;
+    for (int v : values) {
+        sum += v;
+    }
+    CHECK(sequence.Reduce([](int a, int b) { return a + b; }, 0) == sum);
+    CHECK(sequence.ReduceRuns([](int a, int value, int length) { return a + value * length; }, 0) == sum);
+
+    vector<int> otherValues = RunnyValues(1800);
+    RleSequence<int> other(otherValues.data(), (int) otherValues.size());
+    Sequence<int>* zipped = sequence.Zip(&other, [](int a, int b) { return a - b; });
+    vector<int> expectedZipped;
+    for (int i = 0; i < (int) otherValues.size(); i++) {
+        expectedZipped.push_back(values[i] - otherValues[i]);
+    }
+    CHECK(SameElements(zipped, expectedZipped));
+
+    Sequence<int>* joined = sequence.Concat(&other);
+    vector<int> expectedJoined = values;
+    expectedJoined.insert(expectedJoined.end(), otherValues.begin(), otherValues.end());
+    CHECK(SameElements(joined, expectedJoined));
+
+    int first = values[0];
+    int found = -1;
+    CHECK(sequence.TryFind([first](int x) { return x == first; }, found) && found == first);
+
+    delete joined;
+    delete zipped;
+    delete filtered;
+    delete mapped;
+    delete sub;
+}
+
+void TestSlice() {
+    vector<int> values = RunnyValues(500);
+    RleSequence<int> sequence(values.data(), (int) values.size());
+    int replacementItems[] = {9, 9, 8};
+    RleSequence<int> replacement(replacementItems, 3);
+    Sequence<int>* sliced = sequence.Slice(100, 50, &replacement);
+    vector<int> expected(values.begin(), values.begin() + 100);
+    expected.insert(expected.end(), replacementItems, replacementItems + 3);
+    expected.insert(expected.end(), values.begin() + 150, values.end());
+    CHECK(SameElements(sliced, expected));
+    delete sliced;
+}
+
+void TestBounds() {
+    RleSequence<int> sequence;
+    CHECK_THROWS(sequence.Get(0), IndexOutOfRange);
+    CHECK_THROWS(sequence.GetFirst(), IndexOutOfRange);
+    CHECK_THROWS(sequence.AppendRun(1, -1), IndexOutOfRange);
+    sequence.AppendRun(4, 3);
+    CHECK_THROWS(sequence.Get(3), IndexOutOfRange);
+    CHECK_THROWS(sequence.Insert(1, 4), IndexOutOfRange);
+    CHECK(sequence.GetSize() == 3 && sequence.RunCount() == 1);
+}
+
+int main() {
+    TestAppendAndInsert();
+    TestQueries();
+    TestSlice();
+    TestBounds();
+    return TestStatus();
+}
@@ -0,0 +1,91 @@
+#include <vector>
+
+#include "Check.h"
+#include "IndexOutOfRange.h"
+#include "SegmentedList.h"
+
+void Edit(SegmentedList<int>& list, vector<int>& expected, int steps) {
+    for (int step = 0; step < steps; step++) {
+        int value = RandomInt(0, 10000);
+        int choice = RandomInt(0, 3);
+        if (choice < 2) {
+            list.Append(value);
+            expected.push_back(value);
+        } else if (choice < 3) {
+            int index = RandomInt(0, (int) expected.size());
+            list.Insert(value, index);
+            expected.insert(expected.begin() + index, value);
+        } else {
+            list.Prepend(value);
+            expected.insert(expected.begin(), value);
+        }
+    }
+}
+
+// The value queries against scans of the vector; with zone maps on they
+// skip segments, so a stale map shows up as a wrong answer.
+bool SameQueries(SegmentedList<int>& list, const vector<int>& expected) {
+    for (int q = 0; q < 50; q++) {
+        int lo = RandomInt(0, 10000);
+        int hi = lo + RandomInt(0, 500);
+        vector<int> inRange;
+        for (int v : expected) {
+            if (lo <= v && v <= hi) {
+                inRange.push_back(v);
+            }
+        }
+        SegmentedList<int>* range = list.WhereInRange(lo, hi);
+        bool same = SameElements(range, inRange);
+        delete range;
+
+        int greater = -1;
+        int equal = -1;
+        for (int i = (int) expected.size() - 1; i >= 0; i--) {
+            greater = expected[i] > lo ? i : greater;
+            equal = expected[i] == lo ? i : equal;
+        }
+        if (!same || list.FindFirstGreaterThan(lo) != greater || list.IndexOf(lo) != equal) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void TestZoneMaps() {
+    SegmentedList<int> list;
+    vector<int> expected;
+    Edit(list, expected, 1500);
+    CHECK(SameElements(&list, expected));
+    CHECK(SameQueries(list, expected));
+
+    // No zone maps allocated until they are enabled.
+    CollectionFootprint before = list.MemoryFootprint();
+    list.EnableZoneMaps();
+    CHECK(list.ZoneMapsEnabled());
+    CollectionFootprint after = list.MemoryFootprint();
+    CHECK(after.allocationCount == 2 * before.allocationCount);
+    CHECK(after.overheadBytes > before.overheadBytes);
+    CHECK(SameQueries(list, expected));
+
+    // Maps are kept up to date by later edits, splits included.
+    Edit(list, expected, 1500);
+    CHECK(SameElements(&list, expected));
+    CHECK(SameQueries(list, expected));
+}
+
+void TestBounds() {
+    SegmentedList<int> list;
+    CHECK_THROWS(list.Get(0), IndexOutOfRange);
+    list.EnableZoneMaps();
+    CHECK(list.IndexOf(1) == -1);
+    CHECK(list.FindFirstGreaterThan(1) == -1);
+    list.Append(5);
+    CHECK(list.IndexOf(5) == 0);
+    CHECK_THROWS(list.Get(1), IndexOutOfRange);
+}
+
+int main() {
+    TestZoneMaps();
+    TestBounds();
+    return TestStatus();
+}
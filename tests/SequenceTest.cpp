@@ -0,0 +1,76 @@
+#include <functional>
+#include <vector>
+
+#include "Check.h"
+#include "DynamicArray.h"
+#include "IndexOutOfRange.h"
+#include "LinkedList.h"
+#include "MutableArraySequence.h"
+#include "MutableListSequence.h"
+#include "SegmentedList.h"
+
+// Random Append/Prepend/Insert against a vector. SegmentedList segments
+// hold 32 elements, so a few thousand operations split many of them.
+template <class C>
+void TestAgainstVector(C* collection) {
+    vector<int> expected;
+    for (int step = 0; step < 3000; step++) {
+        int value = RandomInt(-1000, 1000);
+        int kind = RandomInt(0, 2);
+        if (kind == 0) {
+            collection->Append(value);
+            expected.push_back(value);
+        } else if (kind == 1) {
+            collection->Prepend(value);
+            expected.insert(expected.begin(), value);
+        } else {
+            int index = RandomInt(0, (int) expected.size());
+            collection->Insert(value, index);
+            expected.insert(expected.begin() + index, value);
+        }
+    }
+    CHECK(SameElements(collection, expected));
+    CHECK_THROWS(collection->Get((int) expected.size()), IndexOutOfRange);
+    CHECK_THROWS(collection->Get(-1), IndexOutOfRange);
+    CHECK_THROWS(collection->Insert(0, (int) expected.size() + 1), IndexOutOfRange);
+    delete collection;
+}
+
+template <class S>
+void TestSequenceOperations() {
+    int items[] = {5, -3, 8, 0, -1, 12, 7};
+    S* sequence = new S(items, 7);
+
+    Sequence<int>* positive = sequence->Where([](int value) { return value > 0; });
+    CHECK(SameElements(positive, vector<int>{5, 8, 12, 7}));
+    Sequence<int>* squared = sequence->Map([](int value) { return value * value; });
+    CHECK(SameElements(squared, vector<int>{25, 9, 64, 0, 1, 144, 49}));
+    CHECK(sequence->Reduce([](int a, int b) { return a + b; }, 100) == 128);
+
+    Sequence<int>* joined = sequence->Concat(positive);
+    CHECK(SameElements(joined, vector<int>{5, -3, 8, 0, -1, 12, 7, 5, 8, 12, 7}));
+    Sequence<int>* middle = sequence->GetSubSequence(2, 5);
+    CHECK(SameElements(middle, vector<int>{8, 0, -1}));
+
+    int found = 0;
+    CHECK(sequence->TryFind([](int value) { return value > 10; }, found) && found == 12);
+    CHECK(!sequence->TryFind([](int value) { return value > 100; }, found));
+    CHECK(sequence->GetFirst() == 5 && sequence->GetLast() == 7);
+
+    delete middle;
+    delete joined;
+    delete squared;
+    delete positive;
+    delete sequence;
+}
+
+int main() {
+    TestAgainstVector(new DynamicArray<int>());
+    TestAgainstVector(new LinkedList<int>());
+    TestAgainstVector(new SegmentedList<int>());
+    TestAgainstVector(new MutableArraySequence<int>());
+    TestAgainstVector(new MutableListSequence<int>());
+    TestSequenceOperations<MutableArraySequence<int>>();
+    TestSequenceOperations<MutableListSequence<int>>();
+    return TestStatus();
+}
@@ -0,0 +1,176 @@
+#include <climits>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <sstream>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+#include "Check.h"
+#include "ImmutableArraySequence.h"
+#include "MutableArraySequence.h"
+#include "MutableListSequence.h"
+#include "Serialization.h"
+
+struct Point {
+    int x;
+    double y;
+
+    bool operator==(const Point& other) const {
+        return x == other.x && y == other.y;
+    }
+};
+
+// A stream that cannot seek, like a pipe.
+struct PipeBuffer : streambuf {
+    string bytes;
+
+    explicit PipeBuffer(string data) : bytes(std::move(data)) {
+        setg(&bytes[0], &bytes[0], &bytes[0] + bytes.size());
+    }
+};
+
+template <template <class> class S, class T>
+void CheckRoundTrip(Sequence<T>* source, const vector<T>& expected) {
+    stringstream buffer;
+    Serialize(source, buffer);
+    S<T>* restored = Deserialize<S, T>(buffer);
+    CHECK(SameElements(restored, expected));
+    delete restored;
+}
+
+void TestStreams() {
+    vector<int> ints;
+    for (int i = 0; i < 5000; i++) {
+        ints.push_back(RandomInt(-100000, 100000));
+    }
+    MutableArraySequence<int> array(ints.data(), (int) ints.size());
+    MutableListSequence<int> list(ints.data(), (int) ints.size());
+    CheckRoundTrip<MutableArraySequence, int>(&array, ints);
+    CheckRoundTrip<ImmutableArraySequence, int>(&list, ints);
+    CheckRoundTrip<MutableListSequence, int>(&array, ints);
+
+    vector<int> empty;
+    MutableArraySequence<int> emptyArray;
+    CheckRoundTrip<MutableArraySequence, int>(&emptyArray, empty);
+
+    vector<string> strings = {"", "a", string(1000, 'x'), string("with\0nul", 8), "last"};
+    MutableArraySequence<string> stringArray(strings.data(), (int) strings.size());
+    CheckRoundTrip<MutableArraySequence, string>(&stringArray, strings);
+
+    vector<Point> points;
+    for (int i = 0; i < 100; i++) {
+        points.push_back(Point{i, i * 0.5});
+    }
+    MutableArraySequence<Point> pointArray(points.data(), (int) points.size());
+    CheckRoundTrip<MutableArraySequence, Point>(&pointArray, points);
+}
+
+void TestRejectedInput() {
+    int items[] = {1, 2, 3};
+    MutableArraySequence<int> array(items, 3);
+    stringstream buffer;
+    Serialize(&array, buffer);
+    string bytes = buffer.str();
+
+    stringstream wrongType(bytes);
+    CHECK_THROWS((Deserialize<MutableArraySequence, long long>(wrongType)), SerializationError);
+
+    stringstream truncated(bytes.substr(0, bytes.size() - 1));
+    CHECK_THROWS((Deserialize<MutableArraySequence, int>(truncated)), SerializationError);
+
+    stringstream header(bytes.substr(0, 10));
+    CHECK_THROWS((Deserialize<MutableArraySequence, int>(header)), SerializationError);
+
+    string corrupt = bytes;
+    corrupt[0] ^= 0x55;
+    stringstream badMagic(corrupt);
+    CHECK_THROWS((Deserialize<MutableArraySequence, int>(badMagic)), SerializationError);
+
+    // A count far beyond the payload is rejected before it is allocated.
+    string huge = bytes;
+    uint64_t count = (uint64_t) INT_MAX;
+    memcpy(&huge[offsetof(SequenceFileHeader, count)], &count, sizeof(count));
+    stringstream hugeCount(huge);
+    CHECK_THROWS((Deserialize<MutableArraySequence, int>(hugeCount)), SerializationError);
+
+    vector<string> strings = {"x"};
+    MutableArraySequence<string> stringArray(strings.data(), 1);
+    stringstream stringBuffer;
+    Serialize(&stringArray, stringBuffer);
+    string hugeStrings = stringBuffer.str();
+    memcpy(&hugeStrings[offsetof(SequenceFileHeader, count)], &count, sizeof(count));
+    stringstream hugeStringCount(hugeStrings);
+    CHECK_THROWS((Deserialize<MutableListSequence, string>(hugeStringCount)), SerializationError);
+}
+
+// A corrupt string length fails before that much is allocated, whether or
+// not the stream can be measured.
+void TestCorruptStringLength() {
+    vector<string> strings = {"first", string(200000, 'y'), "last"};
+    MutableArraySequence<string> array(strings.data(), (int) strings.size());
+    stringstream buffer;
+    Serialize(&array, buffer);
+    string bytes = buffer.str();
+
+    PipeBuffer pipe(bytes);
+    istream piped(&pipe);
+    MutableArraySequence<string>* restored = Deserialize<MutableArraySequence, string>(piped);
+    CHECK(SameElements(restored, strings));
+    delete restored;
+
+    SequenceFileHeader header;
+    memcpy(&header, bytes.data(), sizeof(header));
+    string corrupt = bytes;
+    uint32_t length = 0xFFFFFFF0u;
+    memcpy(&corrupt[header.payloadOffset], &length, sizeof(length));
+    stringstream seekable(corrupt);
+    CHECK_THROWS((Deserialize<MutableArraySequence, string>(seekable)), SerializationError);
+    PipeBuffer corruptPipe(corrupt);
+    istream unseekable(&corruptPipe);
+    CHECK_THROWS((Deserialize<MutableArraySequence, string>(unseekable)), SerializationError);
+}
+
+void TestFiles() {
+    string path = TempPath("serialization.seq");
+    vector<long long> values;
+    for (int i = 0; i < 3000; i++) {
+        values.push_back((long long) RandomInt(0, 1 << 30) * 7);
+    }
+    MutableArraySequence<long long> array(values.data(), (int) values.size());
+    SerializeToFile<long long>(&array, path);
+
+    MutableArraySequence<long long>* read = DeserializeFromFile<MutableArraySequence, long long>(path);
+    CHECK(SameElements(read, values));
+    delete read;
+
+    ImmutableArraySequence<long long>* mapped = MapImmutableArraySequence<long long>(path);
+    CHECK(SameElements(mapped, values));
+    delete mapped;
+
+    // The incremental writer produces the same format.
+    {
+        SequenceFileWriter<long long> writer(path);
+        writer.Write(values.data(), 1000);
+        for (int i = 1000; i < (int) values.size(); i++) {
+            writer.Write(values[i]);
+        }
+        CHECK(writer.Count() == values.size());
+        writer.Close();
+    }
+    read = DeserializeFromFile<MutableArraySequence, long long>(path);
+    CHECK(SameElements(read, values));
+    delete read;
+
+    remove(path.c_str());
+    CHECK_THROWS((DeserializeFromFile<MutableArraySequence, long long>(path)), SerializationError);
+}
+
+int main() {
+    TestStreams();
+    TestRejectedInput();
+    TestCorruptStringLength();
+    TestFiles();
+    return TestStatus();
+}
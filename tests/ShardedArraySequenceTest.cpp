@@ -0,0 +1,176 @@
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Check.h"
+#include "IndexOutOfRange.h"
+#include "ShardedArraySequence.h"
+
+const int SHARD = ShardedArraySequence<int>::SHARD_SIZE;
+
+void TestSingleThread() {
+    ShardedArraySequence<int> sequence;
+    CHECK(sequence.GetSize() == 0);
+    CHECK_THROWS(sequence.Get(0), IndexOutOfRange);
+    int count = SHARD * 2 + 10;
+    for (int i = 0; i < count; i++) {
+        CHECK(sequence.Append(i) == i);
+    }
+    CHECK(sequence.GetSize() == count);
+    CHECK(sequence.Get(count - 1) == count - 1);
+    CHECK_THROWS(sequence.Get(count), IndexOutOfRange);
+    CHECK_THROWS(sequence.Get(-1), IndexOutOfRange);
+    CHECK_THROWS(sequence.Set(count, 0), IndexOutOfRange);
+
+    sequence.Set(SHARD, -5);
+    CHECK(sequence.Get(SHARD) == -5);
+    sequence.Update(SHARD, [](int value) { return value * 2; });
+    CHECK(sequence.Get(SHARD) == -10);
+
+    int items[] = {7, 8, 9};
+    CHECK(sequence.AppendRange(items, 3) == count);
+    CHECK(sequence.GetSize() == count + 3);
+    CHECK(sequence.Get(count + 2) == 9);
+    CHECK_THROWS(sequence.AppendRange(items, -1), IndexOutOfRange);
+}
+
+// Map and Reduce go parallel above 65536 elements; both must agree with a
+// plain loop over the same values.
+void TestMapAndReduce() {
+    int count = SHARD * 5 + 123;
+    vector<int> values(count);
+    for (int i = 0; i < count; i++) {
+        values[i] = RandomInt(-1000, 1000);
+    }
+    ShardedArraySequence<int> sequence(values.data(), count);
+    long long expected = 0;
+    for (int value : values) {
+        expected += value;
+    }
+    CHECK(sequence.Reduce([](int a, int b) { return a + b; }, 17) == expected + 17);
+
+    MutableArraySequence<int>* doubled = sequence.Map([](int value) { return value * 2; });
+    bool same = doubled->GetSize() == count;
+    for (int i = 0; same && i < count; i++) {
+        same = doubled->Get(i) == values[i] * 2;
+    }
+    CHECK(same);
+    delete doubled;
+
+    ShardedArraySequence<int> empty;
+    CHECK(empty.Reduce([](int a, int b) { return a + b; }, 3) == 3);
+}
+
+// No default constructor, and a destructor that has to run.
+struct Event {
+    string name;
+    int id;
+
+    Event(string name, int id) : name(std::move(name)), id(id) {}
+};
+
+void TestElementTypes() {
+    ShardedArraySequence<Event> sequence;
+    int count = SHARD + 100;
+    for (int i = 0; i < count; i++) {
+        sequence.Append(Event("event number " + to_string(i), i));
+    }
+    CHECK(sequence.Get(count - 1).id == count - 1);
+    CHECK(sequence.Get(7).name == "event number 7");
+    sequence.Set(7, Event("renamed", 70));
+    CHECK(sequence.Get(7).name == "renamed" && sequence.Get(7).id == 70);
+
+    // Two shards and one directory page.
+    CHECK(sequence.MemoryFootprint().allocationCount == 3);
+}
+
+// Two writers append one by one and two append in chunks, all values
+// >= 1, while a reader keeps checking that nothing below GetSize() is
+// still unwritten (0). In the end every value is there exactly once.
+void TestAppendersAndReader() {
+    const int WRITERS = 4;
+    const int PER_WRITER = 40000;
+    const int CHUNK = 100;
+    ShardedArraySequence<int> sequence;
+    atomic<int> finished{0};
+    atomic<bool> sawUnwritten{false};
+
+    vector<thread> writers;
+    for (int w = 0; w < WRITERS; w++) {
+        writers.emplace_back([&, w]() {
+            int base = w * PER_WRITER + 1;
+            if (w % 2 == 0) {
+                for (int i = 0; i < PER_WRITER; i++) {
+                    sequence.Append(base + i);
+                }
+            } else {
+                int chunk[CHUNK];
+                for (int i = 0; i < PER_WRITER; i += CHUNK) {
+                    for (int j = 0; j < CHUNK; j++) {
+                        chunk[j] = base + i + j;
+                    }
+                    sequence.AppendRange(chunk, CHUNK);
+                }
+            }
+            finished++;
+        });
+    }
+    thread reader([&]() {
+        int checked = 0;
+        while (finished.load() < WRITERS || checked < WRITERS * PER_WRITER) {
+            int size = sequence.GetSize();
+            for (; checked < size; checked++) {
+                if (sequence.Get(checked) < 1) {
+                    sawUnwritten = true;
+                }
+            }
+        }
+    });
+    for (thread& t : writers) {
+        t.join();
+    }
+    reader.join();
+
+    CHECK(!sawUnwritten.load());
+    CHECK(sequence.GetSize() == WRITERS * PER_WRITER);
+    vector<bool> present(WRITERS * PER_WRITER + 1, false);
+    bool unique = true;
+    for (int i = 0; i < WRITERS * PER_WRITER; i++) {
+        int value = sequence.Get(i);
+        unique = unique && value >= 1 && value <= WRITERS * PER_WRITER && !present[value];
+        present[value] = true;
+    }
+    CHECK(unique);
+}
+
+// Concurrent Update calls on the same indices must not lose increments.
+void TestConcurrentUpdates() {
+    const int THREADS = 4;
+    const int ROUNDS = 20000;
+    const int SLOTS = 8;
+    vector<int> zeros(SLOTS, 0);
+    ShardedArraySequence<int> sequence(zeros.data(), SLOTS);
+    vector<thread> threads;
+    for (int t = 0; t < THREADS; t++) {
+        threads.emplace_back([&, t]() {
+            for (int i = 0; i < ROUNDS; i++) {
+                sequence.Update((i + t) % SLOTS, [](int value) { return value + 1; });
+            }
+        });
+    }
+    for (thread& t : threads) {
+        t.join();
+    }
+    int total = sequence.Reduce([](int a, int b) { return a + b; }, 0);
+    CHECK(total == THREADS * ROUNDS);
+}
+
+int main() {
+    TestSingleThread();
+    TestMapAndReduce();
+    TestElementTypes();
+    TestAppendersAndReader();
+    TestConcurrentUpdates();
+    return TestStatus();
+}
@@ -0,0 +1,92 @@
+#include <algorithm>
+#include <vector>
+
+#include "Check.h"
+#include "IndexOutOfRange.h"
+#include "SkipList.h"
+
+// Random Append / Insert / Prepend / RemoveAt against a vector, checking
+// every position after each batch.
+void TestRandomEdits() {
+    SkipList<int> list;
+    vector<int> expected;
+    for (int step = 0; step < 4000; step++) {
+        int value = RandomInt(-1000, 1000);
+        int choice = RandomInt(0, 9);
+        if (choice < 4) {
+            list.Append(value);
+            expected.push_back(value);
+        } else if (choice < 6) {
+            int index = RandomInt(0, (int) expected.size());
+            list.Insert(value, index);
+            expected.insert(expected.begin() + index, value);
+        } else if (choice < 7) {
+            list.Prepend(value);
+            expected.insert(expected.begin(), value);
+        } else if (!expected.empty()) {
+            int index = RandomInt(0, (int) expected.size() - 1);
+            list.RemoveAt(index);
+            expected.erase(expected.begin() + index);
+        }
+        if (step % 250 == 0) {
+            CHECK(SameElements(&list, expected));
+        }
+    }
+    CHECK(SameElements(&list, expected));
+    if (!expected.empty()) {
+        CHECK(list.GetFirst() == expected.front());
+        CHECK(list.GetLast() == expected.back());
+    }
+}
+
+void TestSortSubListConcat() {
+    vector<int> values;
+    for (int i = 0; i < 1000; i++) {
+        values.push_back(RandomInt(0, 100));
+    }
+    SkipList<int> list(values.data(), (int) values.size());
+    SkipList<int> copy(list);
+    list.Sort();
+    vector<int> sorted = values;
+    sort(sorted.begin(), sorted.end());
+    CHECK(SameElements(&list, sorted));
+    CHECK(SameElements(&copy, values));
+
+    SkipList<int>* sub = list.GetSubList(100, 400);
+    CHECK(SameElements(sub, vector<int>(sorted.begin() + 100, sorted.begin() + 400)));
+
+    SkipList<int>* joined = sub->Concat(&copy);
+    vector<int> expected(sorted.begin() + 100, sorted.begin() + 400);
+    expected.insert(expected.end(), values.begin(), values.end());
+    CHECK(SameElements(joined, expected));
+
+    // Appends after an insert must still extend the right tail.
+    joined->Insert(-1, 5);
+    joined->Append(-2);
+    expected.insert(expected.begin() + 5, -1);
+    expected.push_back(-2);
+    CHECK(SameElements(joined, expected));
+    delete joined;
+    delete sub;
+}
+
+void TestBounds() {
+    SkipList<int> list;
+    CHECK_THROWS(list.Get(0), IndexOutOfRange);
+    CHECK_THROWS(list.RemoveAt(0), IndexOutOfRange);
+    CHECK_THROWS(list.Insert(1, 1), IndexOutOfRange);
+    list.Append(7);
+    CHECK_THROWS(list.Get(1), IndexOutOfRange);
+    CHECK_THROWS(list.Get(-1), IndexOutOfRange);
+    list.RemoveAt(0);
+    CHECK(list.GetSize() == 0);
+    list.Append(8);
+    CHECK(list.Get(0) == 8);
+}
+
+int main() {
+    TestRandomEdits();
+    TestSortSubListConcat();
+    TestBounds();
+    return TestStatus();
+}
@@ -0,0 +1,106 @@
+#include <algorithm>
+#include <cstdlib>
+#include <functional>
+#include <vector>
+
+#include "Check.h"
+#include "IndexOutOfRange.h"
+#include "SortedSequence.h"
+
+// InsertSorted / Remove / Append against a vector kept sorted with
+// upper_bound, and every lookup against its std:: equivalent.
+void TestAgainstSortedVector() {
+    SortedSequence<int> sequence;
+    vector<int> expected;
+    for (int step = 0; step < 3000; step++) {
+        int value = RandomInt(0, 300);
+        int choice = RandomInt(0, 5);
+        if (choice < 3) {
+            int index = sequence.InsertSorted(value);
+            auto position = upper_bound(expected.begin(), expected.end(), value);
+            CHECK(index == (int) (position - expected.begin()));
+            expected.insert(position, value);
+        } else if (choice < 4) {
+            sequence.Append(value);
+            expected.insert(upper_bound(expected.begin(), expected.end(), value), value);
+        } else {
+            auto position = lower_bound(expected.begin(), expected.end(), value);
+            bool present = position != expected.end() && *position == value;
+            CHECK(sequence.Remove(value) == present);
+            if (present) {
+                expected.erase(position);
+            }
+        }
+    }
+    CHECK(SameElements(&sequence, expected));
+    for (int key = -1; key <= 301; key++) {
+        auto lower = lower_bound(expected.begin(), expected.end(), key);
+        auto upper = upper_bound(expected.begin(), expected.end(), key);
+        CHECK(sequence.LowerBound(key) == (int) (lower - expected.begin()));
+        CHECK(sequence.UpperBound(key) == (int) (upper - expected.begin()));
+        CHECK(sequence.Count(key) == (int) (upper - lower));
+        CHECK(sequence.Contains(key) == (upper != lower));
+    }
+    SortedSequence<int>* range = sequence.Range(50, 100);
+    CHECK(SameElements(range, vector<int>(lower_bound(expected.begin(), expected.end(), 50),
+                                          lower_bound(expected.begin(), expected.end(), 100))));
+    delete range;
+}
+
+void TestConstructorsSort() {
+    vector<int> values;
+    for (int i = 0; i < 1000; i++) {
+        values.push_back(RandomInt(-500, 500));
+    }
+    vector<int> ascending = values;
+    sort(ascending.begin(), ascending.end());
+    vector<int> descending = ascending;
+    reverse(descending.begin(), descending.end());
+
+    SortedSequence<int> fromItems(values.data(), (int) values.size());
+    CHECK(SameElements(&fromItems, ascending));
+
+    SortedSequence<int, greater<int>> reversed(values.data(), (int) values.size());
+    CHECK(SameElements(&reversed, descending));
+    CHECK(reversed.LowerBound(0) == (int) (lower_bound(descending.begin(), descending.end(), 0, greater<int>())
+                                           - descending.begin()));
+
+    // Adopted storage is sorted with the given comparator, including one
+    // that carries state.
+    DynamicArray<int>* storage = new DynamicArray<int>(values.data(), (int) values.size());
+    SortedSequence<int, greater<int>> adopted(storage);
+    CHECK(SameElements(&adopted, descending));
+
+    auto byDistance = [](int pivot) {
+        return function<bool(int, int)>([pivot](int a, int b) { return abs(a - pivot) < abs(b - pivot); });
+    };
+    SortedSequence<int, function<bool(int, int)>> near(new DynamicArray<int>(values.data(), (int) values.size()),
+                                                       byDistance(100));
+    bool ordered = true;
+    for (int i = 1; i < near.GetSize(); i++) {
+        ordered = ordered && abs(near.Get(i - 1) - 100) <= abs(near.Get(i) - 100);
+    }
+    CHECK(ordered && near.GetSize() == (int) values.size());
+    near.InsertSorted(100);
+    CHECK(near.GetFirst() == 100);
+
+    SortedSequence<int> copy(&fromItems);
+    copy.InsertSorted(10000);
+    CHECK(copy.GetLast() == 10000);
+    CHECK(fromItems.GetSize() == (int) values.size());
+}
+
+void TestBounds() {
+    SortedSequence<int> sequence;
+    CHECK_THROWS(sequence.Get(0), IndexOutOfRange);
+    CHECK_THROWS(sequence.GetFirst(), IndexOutOfRange);
+    CHECK(!sequence.Remove(1));
+    CHECK(sequence.LowerBound(5) == 0);
+}
+
+int main() {
+    TestAgainstSortedVector();
+    TestConstructorsSort();
+    TestBounds();
+    return TestStatus();
+}
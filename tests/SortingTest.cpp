@@ -0,0 +1,90 @@
+#include <algorithm>
+#include <functional>
+#include <utility>
+#include <vector>
+
+#include "Check.h"
+#include "MutableArraySequence.h"
+#include "MutableListSequence.h"
+#include "Sorting.h"
+
+// Above SORT_RADIX_THRESHOLD, so arithmetic types take the radix path
+// where it applies.
+const int COUNT = 5000;
+
+template <class T>
+vector<T> RandomValues() {
+    vector<T> values;
+    for (int i = 0; i < COUNT; i++) {
+        values.push_back((T) RandomInt(-1000000, 1000000) / (T) 7);
+    }
+    return values;
+}
+
+template <class T, class Compare = less<T>>
+void CheckSort(Compare compare = Compare()) {
+    vector<T> values = RandomValues<T>();
+    vector<T> expected = values;
+    sort(expected.begin(), expected.end(), compare);
+
+    vector<T> sorted = values;
+    SortRange(sorted.data(), COUNT, compare);
+    CHECK(sorted == expected);
+
+    vector<T> stable = values;
+    StableSortRange(stable.data(), COUNT, compare);
+    CHECK(stable == expected);
+
+    MutableArraySequence<T> sequence(values.data(), COUNT);
+    sequence.Sort(compare);
+    CHECK(SameElements(&sequence, expected));
+
+    MutableListSequence<T> list(values.data(), COUNT);
+    list.Sort(compare);
+    CHECK(SameElements(&list, expected));
+}
+
+// Many equal keys: the stable sorts must keep their original order.
+void TestStability() {
+    using Item = pair<int, int>;
+    vector<Item> values;
+    for (int i = 0; i < COUNT; i++) {
+        values.push_back({RandomInt(0, 20), i});
+    }
+    auto byKey = [](const Item& a, const Item& b) { return a.first < b.first; };
+    vector<Item> expected = values;
+    stable_sort(expected.begin(), expected.end(), byKey);
+
+    vector<Item> stable = values;
+    StableSortRange(stable.data(), COUNT, byKey);
+    CHECK(stable == expected);
+
+    MutableArraySequence<Item> sequence(values.data(), COUNT);
+    sequence.StableSort(byKey);
+    CHECK(SameElements(&sequence, expected));
+
+    MutableListSequence<Item> list(values.data(), COUNT);
+    list.StableSort(byKey);
+    CHECK(SameElements(&list, expected));
+}
+
+// Radix keys hold at most 64 bits; wider types must not take that path.
+void TestWideTypes() {
+    static_assert(!IsRadixSortable<long double, less<long double>>());
+    static_assert(!IsRadixSortable<__int128, less<__int128>>());
+    static_assert(IsRadixSortable<double, less<double>>());
+    CheckSort<long double>();
+    CheckSort<__int128>();
+}
+
+int main() {
+    CheckSort<int>();
+    CheckSort<long long>();
+    CheckSort<unsigned>();
+    CheckSort<double>();
+    CheckSort<float>();
+    CheckSort<int>(greater<int>());
+    TestStability();
+    TestWideTypes();
+    return TestStatus();
+}
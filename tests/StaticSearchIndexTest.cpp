@@ -0,0 +1,74 @@
+#include <algorithm>
+#include <functional>
+#include <vector>
+
+#include "Check.h"
+#include "MutableArraySequence.h"
+#include "StaticSearchIndex.h"
+
+// Checks every key from below the smallest to above the largest against
+// std::lower_bound over a stable sort of the source. Equal keys keep their
+// source order, so the first match is the smallest source index.
+template <class Compare>
+bool MatchesLowerBound(const vector<int>& values, const StaticSearchIndex<int, Compare>& index, Compare compare) {
+    vector<int> order;
+    for (int i = 0; i < (int) values.size(); i++) {
+        order.push_back(i);
+    }
+    stable_sort(order.begin(), order.end(), [&](int a, int b) { return compare(values[a], values[b]); });
+    vector<int> keys;
+    for (int i : order) {
+        keys.push_back(values[i]);
+    }
+    bool same = index.GetSize() == (int) values.size();
+    for (int key = -60; key <= 60 && same; key++) {
+        int position = (int) (lower_bound(keys.begin(), keys.end(), key, compare) - keys.begin());
+        bool found = position < (int) keys.size() && !compare(key, keys[position]);
+        int lower = position < (int) keys.size() ? order[position] : -1;
+        same = index.LowerBound(key) == lower
+               && index.Find(key) == (found ? lower : -1)
+               && index.Contains(key) == found;
+    }
+    return same;
+}
+
+void TestSizes() {
+    int sizes[] = {0, 1, 2, 3, 5, 7, 8, 9, 100, 1000, 1023, 1025};
+    for (int size : sizes) {
+        // Keys from a small range, so most of them repeat.
+        vector<int> values;
+        for (int i = 0; i < size; i++) {
+            values.push_back(RandomInt(-50, 50));
+        }
+        StaticSearchIndex<int> unsorted(values.data(), size);
+        CHECK(MatchesLowerBound(values, unsorted, less<int>()));
+
+        // Already sorted input skips the sort.
+        vector<int> sorted = values;
+        sort(sorted.begin(), sorted.end());
+        StaticSearchIndex<int> presorted(sorted.data(), size);
+        CHECK(MatchesLowerBound(sorted, presorted, less<int>()));
+
+        StaticSearchIndex<int, greater<int>> descending(values.data(), size);
+        CHECK(MatchesLowerBound(values, descending, greater<int>()));
+    }
+}
+
+void TestFromSequence() {
+    int items[] = {9, 4, 4, 7, 1, 9, 4};
+    MutableArraySequence<int> sequence(items, 7);
+    StaticSearchIndex<int> index(&sequence);
+    CHECK(index.GetSize() == 7);
+    CHECK(index.Find(4) == 1);
+    CHECK(index.Find(9) == 0);
+    CHECK(index.Find(5) == -1);
+    CHECK(index.LowerBound(5) == 3);
+    CHECK(index.LowerBound(10) == -1);
+    CHECK(index.LowerBound(0) == 4);
+}
+
+int main() {
+    TestSizes();
+    TestFromSequence();
+    return TestStatus();
+}
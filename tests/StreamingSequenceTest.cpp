@@ -0,0 +1,90 @@
+#include <cstdio>
+#include <filesystem>
+#include <vector>
+
+#include "Check.h"
+#include "ExternalSort.h"
+#include "MutableArraySequence.h"
+#include "Serialization.h"
+#include "StreamingSequence.h"
+
+vector<int> WriteInput(const string& path, int count) {
+    vector<int> values;
+    for (int i = 0; i < count; i++) {
+        values.push_back(RandomInt(-1000, 1000));
+    }
+    MutableArraySequence<int> sequence(values.data(), count);
+    SerializeToFile<int>(&sequence, path);
+    return values;
+}
+
+template <class T>
+bool SameFile(const string& path, const vector<T>& expected) {
+    MutableArraySequence<T>* read = DeserializeFromFile<MutableArraySequence, T>(path);
+    bool same = SameElements(read, expected);
+    delete read;
+    return same;
+}
+
+// Small chunks, so every pass crosses many chunk boundaries.
+void TestPasses() {
+    string input = TempPath("stream_in.seq");
+    string output = TempPath("stream_out.seq");
+    vector<int> values = WriteInput(input, 10000);
+    StreamingSequence<int> sequence(input, 333);
+    CHECK(sequence.GetSize() == (long long) values.size());
+    CHECK(sequence.Get(1234) == values[1234]);
+
+    long long sum = 0;
+    vector<int> doubled;
+    vector<int> positive;
+    for (int v : values) {
+        sum += v;
+        doubled.push_back(v * 2);
+        if (v > 0) {
+            positive.push_back(v);
+        }
+    }
+    CHECK(sequence.Reduce([](int a, int b) { return a + b; }, 0) == sum);
+
+    StreamingSequence<int>* mapped = sequence.Map([](int x) { return x * 2; }, output);
+    CHECK(mapped->GetSize() == (long long) values.size());
+    CHECK(SameFile(output, doubled));
+    delete mapped;
+
+    StreamingSequence<int>* filtered = sequence.Where([](int x) { return x > 0; }, output);
+    CHECK(SameFile(output, positive));
+    delete filtered;
+
+    int generated = 0;
+    bool same = true;
+    for (int v : sequence.AsGenerator()) {
+        same = same && v == values[generated++];
+    }
+    CHECK(same && generated == (int) values.size());
+
+    remove(output.c_str());
+    remove(input.c_str());
+}
+
+// Writing the result over the input, under any name for it, would
+// truncate the input before it is read.
+void TestOutputOverInput() {
+    string input = TempPath("stream_same.seq");
+    vector<int> values = WriteInput(input, 1000);
+    StreamingSequence<int> sequence(input, 100);
+    string alias = (filesystem::path(input).parent_path() / "." / filesystem::path(input).filename()).string();
+
+    CHECK_THROWS(sequence.Map([](int x) { return x; }, input), SerializationError);
+    CHECK_THROWS(sequence.Where([](int) { return true; }, alias), SerializationError);
+    ExternalSorter<int> sorter;
+    CHECK_THROWS(sorter.SortFile(input, alias), SerializationError);
+    CHECK(SameFile(input, values));
+    remove(input.c_str());
+}
+
+int main() {
+    TestPasses();
+    TestOutputOverInput();
+    return TestStatus();
+}